@@ -1,4 +1,4 @@
-/* DHT library 
+/* DHT library
 
 
 MIT license
@@ -9,11 +9,17 @@ written by Adafruit Industries
 #include "DHT.h"
 
 
-DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) {
+DHT* DHT::_instances[2];
+
+
+DHT::DHT(uint8_t pin, uint8_t type) {
   _pin = pin;
   _type = type;
-  _count = count;
+  _state = DHT_IDLE;
   firstreading = true;
+
+  // external interrupt wired to the data pin, the port table is checked at compile time
+  _interrupt = digitalPinToInterrupt(_pin);
 }
 
 
@@ -25,149 +31,149 @@ void DHT::begin(void) {
 }
 
 
-//boolean S == Scale.  True == Farenheit; False == Celcius
-float DHT::readTemperature(bool S) {
-  float f;
-
-
-  if (read()) {
-	switch (_type) {
-	case DHT11:
-	  f = data[2];
-	  if(S)
-		f = convertCtoF(f);
-		
-	  return f;
-	case DHT22:
-	case DHT21:
-	  f = data[2] & 0x7F;
-	  f *= 256;
-	  f += data[3];
-	  f /= 10;
-	  if (data[2] & 0x80)
-	f *= -1;
-	  if(S)
-	f = convertCtoF(f);
-
-
-	  return f;
-	}
+// starts a transaction by pulling the bus low, returns false if a transaction
+// is already running or the sensor has been read too recently
+boolean DHT::start(void) {
+  unsigned long currenttime = millis();
+
+  if (_interrupt < 0 || _state == DHT_START || _state == DHT_RECEIVE) {
+	return false;
   }
-  return NAN;
-}
+  if (!firstreading && ((currenttime - _lastreadtime) < DHT_MIN_INTERVAL)) {
+	return false;
+  }
+  firstreading = false;
+  _lastreadtime = currenttime;
 
+  data[0] = data[1] = data[2] = data[3] = data[4] = 0;
+  _edges = 0;
+  _state = DHT_START;
 
-float DHT::convertCtoF(float c) {
-	return c * 9 / 5 + 32;
+  // now pull it low for ~20 milliseconds, poll() releases the bus
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+  return true;
 }
 
 
-float DHT::readHumidity(void) {
-  float f;
-  if (read()) {
-	switch (_type) {
-	case DHT11:
-	  f = data[0];
-	  return f;
-	case DHT22:
-	case DHT21:
-	  f = data[0];
-	  f *= 256;
-	  f += data[1];
-	  f /= 10;
-	  return f;
+// advances a running transaction, returns its state
+uint8_t DHT::poll(void) {
+  switch (_state) {
+  case DHT_START:
+	if ((millis() - _lastreadtime) < DHT_START_SIGNAL) {
+	  break;
+	}
+
+	// listen to the bus before releasing it
+	_instances[_interrupt] = this;
+	attachInterrupt(_interrupt, _interrupt == 0 ? isr0 : isr1, CHANGE);
+
+	_state = DHT_RECEIVE;
+	_released = micros();
+	pinMode(_pin, INPUT);
+	digitalWrite(_pin, HIGH);
+	break;
+
+  case DHT_RECEIVE:
+	if (_edges >= DHT_EDGES) {
+	  // check that the checksum matches
+	  if (data[4] == ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) {
+		finish(DHT_DONE, DHT_FRAME_OK);
+	  } else {
+		finish(DHT_FAILED, DHT_FRAME_CHECKSUM);
+	  }
+	} else if ((micros() - _released) > DHT_RESPONSE_TIMEOUT) {
+	  finish(DHT_FAILED, DHT_FRAME_TIMEOUT);
 	}
+	break;
   }
-  return NAN;
-}
 
+  return _state;
+}
 
 
+// returns true if the last transaction has finished, successfully or not
+boolean DHT::complete(void) {
+  return _state == DHT_DONE || _state == DHT_FAILED;
+}
 
-boolean DHT::read(void) {
-  uint8_t laststate = HIGH;
-  uint8_t counter = 0;
-  uint8_t j = 0, i;
-  unsigned long currenttime;
 
+void DHT::finish(uint8_t state, uint8_t status) {
+  detachInterrupt(_interrupt);
+  _instances[_interrupt] = NULL;
+  _state = state;
+  _status = status;
+  _finished = millis();
+}
 
-  // pull the pin high and wait 250 milliseconds
-  digitalWrite(_pin, HIGH);
-  delay(250);
 
+// measures high pulses, called on every bus level change
+void DHT::handleEdge(void) {
+  unsigned long now = micros();
 
-  currenttime = millis();
-  if (currenttime < _lastreadtime) {
-	// ie there was a rollover
-	_lastreadtime = 0;
+  if (digitalRead(_pin) == HIGH) {
+	_rise = now;
+	return;
   }
-  if (!firstreading && ((currenttime - _lastreadtime) < 2000)) {
-	return true; // return last correct measurement
-	//delay(2000 - (currenttime - _lastreadtime));
-  }
-  firstreading = false;
-  /*
-	Serial.print("Currtime: "); Serial.print(currenttime);
-	Serial.print(" Lasttime: "); Serial.print(_lastreadtime);
-  */
-  _lastreadtime = millis();
-
 
-  data[0] = data[1] = data[2] = data[3] = data[4] = 0;
-  
-  // now pull it low for ~20 milliseconds
-  pinMode(_pin, OUTPUT);
-  digitalWrite(_pin, LOW);
-  delay(20);
-  cli();
-  digitalWrite(_pin, HIGH);
-  delayMicroseconds(40);
-  pinMode(_pin, INPUT);
-
-
-  // read in timings
-  for ( i=0; i< MAXTIMINGS; i++) {
-	counter = 0;
-	while (digitalRead(_pin) == laststate) {
-	  counter++;
-	  delayMicroseconds(1);
-	  if (counter == 255) {
-		break;
-	  }
-	}
-	laststate = digitalRead(_pin);
+  // the first two falling edges end the sensor's acknowledge,
+  // the following ones end data bits
+  if (_edges >= 2 && _edges < DHT_EDGES) {
+	uint8_t j = _edges - 2;
+	data[j/8] <<= 1;
+	if ((now - _rise) > DHT_BIT_THRESHOLD)
+	  data[j/8] |= 1;
+  }
+  _edges++;
+}
 
 
-	if (counter == 255) break;
+void DHT::isr0(void) {
+  if (_instances[0] != NULL)
+	_instances[0]->handleEdge();
+}
 
 
-	// ignore first 3 transitions
-	if ((i >= 4) && (i%2 == 0)) {
-	  // shove each bit into the storage bytes
-	  data[j/8] <<= 1;
-	  if (counter > _count)
-		data[j/8] |= 1;
-	  j++;
-	}
+void DHT::isr1(void) {
+  if (_instances[1] != NULL)
+	_instances[1]->handleEdge();
+}
 
 
+// decodes temperature and humidity from the last finished transaction's
+// frame, returns false if there's no finished transaction to report
+boolean DHT::read(DHTFrame& frame) {
+  if (!complete()) {
+	return false;
   }
 
+  frame.timestamp = _finished;
+  frame.status = _status;
+  frame.temperature = 0;
+  frame.humidity = 0;
+  _state = DHT_IDLE;
 
-  sei();
-  
-
-
-  // check we read 40 bits and that the checksum matches
-  if ((j >= 40) && 
-	  (data[4] == ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) ) {
+  if (frame.status != DHT_FRAME_OK) {
 	return true;
   }
-  
-
-
-  return false;
-
 
+  switch (_type) {
+  case DHT11:
+	frame.humidity = data[0] * 100;
+	frame.temperature = data[2] * 100;
+	break;
+  case DHT22:
+  case DHT21:
+	frame.humidity = ((data[0] << 8) | data[1]) * 10;
+	frame.temperature = (((data[2] & 0x7F) << 8) | data[3]) * 10;
+	if (data[2] & 0x80)
+	  frame.temperature = -frame.temperature;
+	break;
+  }
+  return true;
 }
 
+
+float DHT::convertCtoF(float c) {
+	return c * 9 / 5 + 32;
+}
\ No newline at end of file
@@ -7,16 +7,18 @@
 #endif
 
 
-/* DHT library 
+/* DHT library
 
 
 MIT license
 written by Adafruit Industries
-*/
-
 
-// how many timing transitions we need to keep track of. 2 * number bits + extra
-#define MAXTIMINGS 85
+Asynchronous version: a transaction is started with start(), driven by
+poll() and the bits are timed by an external interrupt on the data pin,
+so the caller never waits for the sensor. The data pin must be an
+external interrupt pin (2 or 3 on Arduino Uno), sensor.cpp checks
+the configured ports at compile time.
+*/
 
 
 #define DHT11 11
@@ -25,23 +27,70 @@ written by Adafruit Industries
 #define AM2301 21
 
 
+// transaction states
+#define DHT_IDLE      0   // no transaction has been started yet
+#define DHT_START     1   // host holds the start signal
+#define DHT_RECEIVE   2   // sensor is sending its response
+#define DHT_DONE      3   // a frame has been received
+#define DHT_FAILED    4   // sensor didn't respond or checksum mismatch
+
+
+// start signal length, ms
+#define DHT_START_SIGNAL  20
+// max response length after the start signal, us
+#define DHT_RESPONSE_TIMEOUT  10000
+// high pulses longer than this are "1" bits, us
+#define DHT_BIT_THRESHOLD  48
+// min interval between two transactions, ms
+#define DHT_MIN_INTERVAL  2000
+// falling edges in a response: 2 for the acknowledge and 40 data bits
+#define DHT_EDGES  42
+
+
+// frame status
+#define DHT_FRAME_OK        0   // frame received, checksum matches
+#define DHT_FRAME_TIMEOUT   1   // sensor didn't send a complete frame
+#define DHT_FRAME_CHECKSUM  2   // frame received, checksum mismatch
+
+
+// one decoded 40-bit sensor frame
+struct DHTFrame {
+  int16_t temperature;      // hundredths of Celcius, 0 unless status is DHT_FRAME_OK
+  int16_t humidity;         // hundredths of percent, 0 unless status is DHT_FRAME_OK
+  unsigned long timestamp;  // millis() when the transaction has finished
+  uint8_t status;
+};
+
+
 class DHT {
  private:
-  uint8_t data[6];
-  uint8_t _pin, _type, _count;
-  boolean read(void);
+  volatile uint8_t data[5];
+  volatile uint8_t _edges;
+  volatile unsigned long _rise;
+  uint8_t _pin, _type, _state, _status;
+  int8_t _interrupt;
   unsigned long _lastreadtime;
+  unsigned long _released;
+  unsigned long _finished;
   boolean firstreading;
 
+  void handleEdge(void);
+  void finish(uint8_t state, uint8_t status);
+
+  static DHT* _instances[2];
+  static void isr0(void);
+  static void isr1(void);
+
 
  public:
-  DHT(uint8_t pin, uint8_t type, uint8_t count=6);
+  DHT(uint8_t pin, uint8_t type);
   void begin(void);
-  float readTemperature(bool S=false);
+  boolean start(void);
+  uint8_t poll(void);
+  boolean complete(void);
+  boolean read(DHTFrame& frame);
   float convertCtoF(float);
-  float readHumidity(void);
 
 
 };
-#endif
-
+#endif
\ No newline at end of file
@@ -17,6 +17,18 @@ LCDBitmap::LCDBitmap(LiquidCrystal *lcd, byte x, byte y) {
   _lcd = lcd;
 }
 
+// Pixels are drawn straight into the custom characters, there's no separate pixel buffer
+void LCDBitmap::set(byte x, byte y, boolean color) {
+  byte c = x / BITMAP_CHAR_W;
+  if (y >= BITMAP_CHAR_H) {
+    c += 4;
+    y -= BITMAP_CHAR_H;
+  }
+  byte mask = 0x10 >> (x % BITMAP_CHAR_W);
+  if (color) chr[c][y] |= mask;
+  else chr[c][y] &= ~mask;
+}
+
 void LCDBitmap::updateChar() {
   for (byte i=0; i<BITMAP_CHAR; i++) _lcd->createChar(i, chr[i]);
 }
@@ -45,7 +57,6 @@ void LCDBitmap::begin() {
 }
 
 void LCDBitmap::clear() {
-  for (byte y=0; y<BITMAP_H; y++) for (byte x=0; x<BITMAP_W; x++) bitmap[x][y]=OFF;
   for (byte c=0; c<BITMAP_CHAR; c++) for (byte a=0; a<BITMAP_CHAR_H; a++) chr[c][a]=OFF;
   LCDBitmap::updateChar();
 }
@@ -59,35 +70,21 @@ void LCDBitmap::home() {
   _lcd->setCursor(0, 0);
 }
 void LCDBitmap::update() {
-  byte shift_x;
-  byte shift_y=0;
-  for (byte c=0; c<BITMAP_CHAR; c++) {
-    if (c<4) shift_x=c*BITMAP_CHAR_W;
-    else shift_x=(c-4)*BITMAP_CHAR_W;
-    if (c==4) shift_y=BITMAP_CHAR_H;
-    for (byte a=0; a<BITMAP_CHAR_H; a++) {
-      chr[c][a]=bitmap[shift_x][shift_y+a]<<4;
-      chr[c][a]+=bitmap[shift_x+1][shift_y+a]<<3;
-      chr[c][a]+=bitmap[shift_x+2][shift_y+a]<<2;
-      chr[c][a]+=bitmap[shift_x+3][shift_y+a]<<1;
-      chr[c][a]+=bitmap[shift_x+4][shift_y+a];
-    }
-  }
   LCDBitmap::updateChar();
 }
 
 void LCDBitmap::inverse() {
-  for (byte x=0; x<BITMAP_W; x++) {
-    for (byte y=0; y<BITMAP_H; y++) bitmap[x][y]=bitmap[x][y]^1;
+  for (byte c=0; c<BITMAP_CHAR; c++) {
+    for (byte a=0; a<BITMAP_CHAR_H; a++) chr[c][a]^=0x1F;
   }
   LCDBitmap::update();
 }
 
 void LCDBitmap::move(byte x, byte y) {
   _lcd->setCursor(bitmap_x, bitmap_y);
-  _lcd->print("    ");
+  _lcd->print(F("    "));
   _lcd->setCursor(bitmap_x, bitmap_y+1);
-  _lcd->print("    ");
+  _lcd->print(F("    "));
   bitmap_x = x;
   bitmap_y = y;
   LCDBitmap::drawChar();
@@ -95,9 +92,9 @@ void LCDBitmap::move(byte x, byte y) {
 
 void LCDBitmap::pixel(byte x, byte y, boolean color, boolean update) {
 #ifdef BITMAP_RANGE_CHK
-  if (x>=0 && y>=0 && x<BITMAP_W && y<BITMAP_H) bitmap[x][y]=color;
+  if (x>=0 && y>=0 && x<BITMAP_W && y<BITMAP_H) LCDBitmap::set(x, y, color);
 #else
-  bitmap[x][y]=color;
+  LCDBitmap::set(x, y, color);
 #endif
   if (update) LCDBitmap::update();
 }
@@ -109,16 +106,16 @@ void LCDBitmap::line(byte x1, byte y1, byte x2, byte y2, boolean color, boolean
   // Vertical line (faster than diagonal line method)
   if (x1==x2) {
     if (y1 < y2) {
-      for (y1=y1; y1<=y2; y1++) bitmap[x1][y1]=color;
+      for (y1=y1; y1<=y2; y1++) LCDBitmap::set(x1, y1, color);
     } else {
-      for (y2=y2; y2<=y1; y2++) bitmap[x1][y2]=color;
+      for (y2=y2; y2<=y1; y2++) LCDBitmap::set(x1, y2, color);
     }
   // Horizontal line (faster than diagonal line method)
   } else if (y1==y2) {
     if (x1 < x2) {
-      for (x1=x1; x1<=x2; x1++) bitmap[x1][y1]=color;
+      for (x1=x1; x1<=x2; x1++) LCDBitmap::set(x1, y1, color);
     } else {
-      for (x2=x2; x2<=x1; x2++) bitmap[x2][y1]=color;
+      for (x2=x2; x2<=x1; x2++) LCDBitmap::set(x2, y1, color);
     }
   // Diagonal line
   } else {
@@ -131,7 +128,7 @@ void LCDBitmap::line(byte x1, byte y1, byte x2, byte y2, boolean color, boolean
     if (x1 < x2) sx = 1; else sx = -1;
     if (y1 < y2) sy = 1; else sy = -1;
     while (1) {
-      bitmap[x1][y1]=color;
+      LCDBitmap::set(x1, y1, color);
       if (x1 == x2 && y1 == y2) break;
       e2 = 2*err;
       if (e2 > -dy) { 
@@ -169,7 +166,7 @@ void LCDBitmap::rectFill(byte x1, byte y1, byte x2, byte y2, boolean color, bool
   while (1) {
     y=y1;
     while (1) {
-      bitmap[x1][y]=color;
+      LCDBitmap::set(x1, y, color);
       if (y == y2) break;
     y+=sy;
     }
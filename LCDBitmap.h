@@ -126,6 +126,7 @@ class LCDBitmap {
 		void rectFill(byte x1, byte y1, byte x2, byte y2, boolean color, boolean update=false);
 		void barGraph(byte bars, byte *graph, boolean color, boolean update=false);
 	private:
+		void set(byte x, byte y, boolean color);
 		void updateChar();
 		void drawChar();
 #ifdef BITMAP_RANGE_CHK
@@ -133,7 +134,6 @@ class LCDBitmap {
 #endif
 		byte bitmap_x;
 		byte bitmap_y;
-		boolean bitmap[BITMAP_W][BITMAP_H];
 		byte chr[BITMAP_CHAR][BITMAP_CHAR_H];
 #ifndef LiquidCrystal_h // Using the New LiquidCrystal library
 		LCD *_lcd;
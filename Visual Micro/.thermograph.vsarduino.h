@@ -2,7 +2,7 @@
 #define _VSARDUINO_H_
 //Board = Arduino Uno
 #define __AVR_ATmega328P__
-#define ARDUINO 101
+#define ARDUINO 10819
 #define __AVR__
 #define F_CPU 16000000L
 #define __cplusplus
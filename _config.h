@@ -11,16 +11,159 @@
 #define APP_OUTDOOR_SENSOR_PORT 2
 
 /* 
- * Temperature sensors' update period, in seconds
+ * Temperature sensors' update period, in seconds.
+ * Sensor channels can't be updated more often than this.
  */
 #define APP_SENSOR_PERIOD ((long)10) /* sec */
 
+/*
+ * Sensor channels table.
+ * Each CHANNEL(port, driver, name, label, period, oversampling) entry describes a sensor channel:
+ *	port			- sensor port
+ *	driver			- sensor driver, one of SENSOR_DRIVER_DHT11, SENSOR_DRIVER_DHT22, SENSOR_DRIVER_LM35, SENSOR_DRIVER_THERMISTOR
+ *	name			- display name, up to 11 characters
+ *	label			- short display name, up to 3 characters
+ *	period			- update period, in seconds. Rounded up to a multiple of APP_SENSOR_PERIOD
+ *	oversampling	- analog sensors only: extra bits n to gain by oversampling 4^n times, 0 to 3
+ * Channels' IDs are their indices in this table.
+ */
+#define APP_SENSOR_CHANNELS(CHANNEL) \
+	CHANNEL(APP_OUTDOOR_SENSOR_PORT, SENSOR_DRIVER_DHT11, "outside", "out", APP_SENSOR_PERIOD, 0) \
+	CHANNEL(APP_INDOOR_SENSOR_PORT, SENSOR_DRIVER_DHT11, "in the room", "in", APP_SENSOR_PERIOD, 0)
+
+/* 
+ * First temperature sensors' update delay after boot, in milliseconds.
+ * DHT sensors can't start another reading sooner than 2 seconds after the boot one.
+ */
+#define APP_SENSOR_WARMUP ((long)2000) /* ms */
+
+/* 
+ * Temperature sensors' update time budget, in milliseconds
+ */
+#define APP_SENSOR_BUDGET ((long)100) /* ms */
+
+/*
+ * Temperature sensors' background acquisition polling period and time budget, in milliseconds.
+ * The budget covers collecting a completed round and writing its readings into the log.
+ */
+#define APP_SENSOR_POLL_PERIOD ((long)10) /* ms */
+#define APP_SENSOR_POLL_BUDGET ((long)100) /* ms */
+
+/*
+ * Max acquisition round length, in milliseconds.
+ * Sensors that haven't completed their reading by then are reported as unavailable.
+ */
+#define APP_SENSOR_ROUND_TIMEOUT ((long)1000) /* ms */
+
+/*
+ * Smoothing of oversampled analog sensor channels: each decimated reading
+ * moves the filtered value by 1/2^APP_ADC_FILTER_SHIFT of the difference. 0 disables smoothing.
+ */
+#define APP_ADC_FILTER_SHIFT 2
+
+/*
+ * Keypad polling period and time budget, in milliseconds
+ */
+#define APP_BUTTON_PERIOD ((long)50) /* ms */
+#define APP_BUTTON_BUDGET ((long)10) /* ms */
+
+/*
+ * Display refresh period and time budget, in milliseconds
+ */
+#define APP_DISPLAY_PERIOD ((long)250) /* ms */
+#define APP_DISPLAY_BUDGET ((long)100) /* ms */
+
+/*
+ * Scheduler statistics report period, in seconds, and time budget, in milliseconds
+ */
+#define APP_STATS_PERIOD ((long)600) /* sec */
+#define APP_STATS_BUDGET ((long)1000) /* ms */
+
+/*
+ * Log output buffer, in bytes. Log calls queue text into it and return at once,
+ * the serial port's interrupt sends it in background. It must hold a burst of lines a task writes in one run.
+ * Text which doesn't fit is dropped a whole line at a time, either the line being written (LOG_DROP_NEWEST)
+ * or the oldest queued ones (LOG_DROP_OLDEST). Dropped text is counted in statistics report
+ */
+#define APP_LOG_BUFFER 256
+#define APP_LOG_OVERFLOW LOG_DROP_NEWEST
+
+/*
+ * Rate limited log messages (LOG_ERR_LIMITED etc.): repeats of a call site's message within its window
+ * since it was written are counted instead, the count is written afterwards as a "repeated N times" line.
+ * Up to APP_LOG_REPEAT_SLOTS call sites are tracked at once, a new one replaces the one whose window ends first.
+ * Call sites' windows, in milliseconds:
+ *	DHT_INCOMPLETE	- DHT sensor hasn't completed its reading by the end of the round
+ *	DHT_FAILURE		- DHT sensor's frame timed out or failed its checksum
+ *	DHT_BUSY		- DHT sensor is still busy when a reading is due
+ */
+#define APP_LOG_REPEAT_SLOTS 3
+#define APP_LOG_REPEAT_WINDOW_DHT_INCOMPLETE ((unsigned long)300000) /* ms */
+#define APP_LOG_REPEAT_WINDOW_DHT_FAILURE ((unsigned long)300000) /* ms */
+#define APP_LOG_REPEAT_WINDOW_DHT_BUSY ((unsigned long)300000) /* ms */
+
+/*
+ * Binary log protocol: log messages are sent as format string IDs, timestamps and raw arguments
+ * instead of text. host/log_decode restores the text using "log_formats.h", which is generated
+ * from the firmware's F("...") strings by "make tables" in host/. LOG_* macros' IDs are computed
+ * at compile time, so their format strings aren't stored in flash. Text is sent otherwise
+ */
+//#define APP_LOG_BINARY
+
 
 /*
  * Measurement history write period, in seconds
  */
 #define APP_HISTORY_INTERVAL ((long)60) /* sec */
 
+/*
+ * Measurement history tiers: TIER(span, bytes, resolution), finest first.
+ * A tier's bucket aggregates span history intervals, charts plot APP_HISTORY_BUCKETS last buckets.
+ * A span must be a multiple of the previous tier's span, its buckets are rolled up from that tier.
+ * A tier keeps every stored metric's buckets compressed in bytes of SRAM per sensor:
+ * 1 byte per steady bucket, up to 7 bytes per noisy one. Must be 28 to 255 bytes.
+ * Stored values are rounded to resolution, in hundredths of a unit, 10 to 255.
+ * Coarse buckets are noisier, their tiers need more room or a coarser resolution for the same buckets count.
+ * Temperature and humidity are stored, dew point is derived from them
+ */
+#define APP_HISTORY_BUCKETS 20
+#define APP_HISTORY_TIERS(TIER) \
+	TIER(1, 32, 10)		/* 1 min x 20 = 20 min */ \
+	TIER(504, 64, 100)	/* 504 min x 20 = 7 d */
+
+/*
+ * SRAM budget of ATmega328P's 2048 bytes, static data estimated for AVR (2-byte pointers and ints, no padding):
+ *	data_history	 671	- tiers' streams and open buckets 216, compressed buckets 384 (2 sensors x 2 metrics x 96),
+ *						  EEPROM checkpoint record 21, chart projection 26, clocks, revisions and statistics 24
+ *	log				 302	- APP_LOG_BUFFER ring 256, repeat slots and statistics
+ *	scheduler		 175	- 6 tasks x 28
+ *	adc_scanner		 148	- double buffered frames 66, decimation and IIR filters
+ *	display			  89	- LCD driver, bitmap's 8 custom characters
+ *	sensor			  93	- channels and their DHT drivers
+ *	app				  77	- 6 tasks, 3 display modes
+ *	vtables			~180	- copied into SRAM on AVR
+ *	other .data		 ~97	- channel table and names, history tables, core's millis() state
+ *	total			~1830, leaving ~215 bytes for the stack. Its deepest paths, the sensor round's report and
+ *					a chart projection, take ~190 with the ADC interrupt handler on top. A chart projection's
+ *					LOG_DEBUG dump adds ~90 more, so HISTORY logs up to LOG_INFO by default.
+ * data_history_t is checked against APP_HISTORY_SRAM at compile time, history settings must keep within it
+ */
+#define APP_HISTORY_SRAM 680
+
+/*
+ * Persistent history log: EEPROM area closed buckets of coarse history tiers are checkpointed into,
+ * so the history survives a reboot. Records are appended round-robin, so every cell wears evenly
+ */
+#define APP_HISTORY_LOG_ADDRESS 0
+#define APP_HISTORY_LOG_BYTES 1024
+
+/*
+ * Checkpoint writing period and time budget, in milliseconds.
+ * A run writes at most one EEPROM byte, which takes 3.3 ms to program, so the period shouldn't be shorter
+ */
+#define APP_HISTORY_LOG_PERIOD ((long)10) /* ms */
+#define APP_HISTORY_LOG_BUDGET ((long)5) /* ms */
+
 /*
  * Chart display mode - using normalization to average.
  * Uses normalization to boundaries otherwise
@@ -47,7 +190,14 @@
 #define LM35_USE_INTERNAL_REF
 
 /*
- * Enable debug logging level. Displays messages with DBG, INF, ERR levels.
- * Displays only IFN and ERR messages otherwise.
+ * Log levels by module: LOG_ERROR, LOG_INFO or LOG_DEBUG. A module logs messages up to its level,
+ * the rest are compiled out along with their arguments (see LOG_ENABLED in "log.h").
+ *	SENSOR	- sensors and ADC
+ *	DISPLAY	- display and its modes
+ *	HISTORY	- measurement history
+ *	APP		- application, scheduler and the log itself
  */
-#define ENABLE_DEBUG_LOGGING
\ No newline at end of file
+#define APP_LOG_LEVEL_SENSOR	LOG_DEBUG
+#define APP_LOG_LEVEL_DISPLAY	LOG_DEBUG
+#define APP_LOG_LEVEL_HISTORY	LOG_INFO
+#define APP_LOG_LEVEL_APP		LOG_DEBUG
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "Arduino.h"
+#include "_config.h"
+#include "adc.h"
+#include "log.h"
+extern "C" 
+{
+#include <avr/io.h>
+#include <avr/interrupt.h>
+}
+
+using namespace thermograph;
+
+/**
+ *	ADC scanner static instance
+ **/
+adc_scanner_t thermograph::adc_scanner;
+
+/**
+ *	ADC conversion complete interrupt handler
+ **/
+ISR(ADC_vect)
+{
+	adc_scanner.on_conversion();
+}
+
+/*
+ ************************************************************************
+ *	adc_scanner_t
+ *	Interrupt driven ADC scanner class
+ ************************************************************************
+ */
+
+/**
+ *	Constructor
+ **/
+adc_scanner_t::adc_scanner_t()
+	: _front(0), _revision(0), _filters_ready(0), _channels(0), _reference(0), _group(0), _settling(0), _channel(0), _scans(0)
+{ 
+	memset(_frames, 0, sizeof(_frames));
+	memset(_oversampling, 0, sizeof(_oversampling));
+	memset(_decimation_sums, 0, sizeof(_decimation_sums));
+	memset(_decimation_counts, 0, sizeof(_decimation_counts));
+	memset(_filters, 0, sizeof(_filters));
+	memset(_references, 0, sizeof(_references));
+}
+
+/**
+ *	Registers an analog channel to scan. Must be called before start()
+ *	@param	channel			analog channel, either 0-7 or A0-A7
+ *	@param	reference		analog reference voltage: DEFAULT, INTERNAL or EXTERNAL
+ *	@param	oversampling	extra bits n to gain by oversampling 4^n times, up to MAX_OVERSAMPLING
+ **/
+void adc_scanner_t::add(uint8_t channel, uint8_t reference, uint8_t oversampling)
+{
+	uint8_t index = to_index(channel);
+	_channels |= _BV(index);
+	_references[index] = reference;
+	_oversampling[index] = min(oversampling, MAX_OVERSAMPLING);
+
+	LOG_DBG(SENSOR,
+		F("adc_scanner\tadd(): channel = %d, reference = %d, oversampling = %d"),
+		index,
+		reference,
+		_oversampling[index]);
+}
+
+/**
+ *	Starts scanning registered channels
+ **/
+void adc_scanner_t::start()
+{
+	if(_channels == 0)
+	{
+		return;
+	}
+
+	// Start from the first registered channel's group
+	uint8_t first = 0;
+	while(!(_channels & _BV(first)))
+	{
+		first++;
+	}
+	switch_group(_references[first]);
+
+	// Disable digital input buffers on analog pins
+	DIDR0 |= _channels & 0x3F;
+
+	// Auto trigger conversions by Timer0 overflow, 125 kHz ADC clock, interrupt on completion
+	ADCSRB = _BV(ADTS2);
+	ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+
+	LOG_DBG(SENSOR, F("adc_scanner\tstart(): channels = %B"), _channels);
+}
+
+/**
+ *	Handles a completed conversion. Called by ADC interrupt handler
+ **/
+void adc_scanner_t::on_conversion()
+{
+	int value = ADC;
+	frame_t& back = _frames[_front ^ 1];
+	if(_settling == 0)
+	{
+		back.latest[_channel] = value;
+		decimate(_channel, value);
+	}
+
+	// Switch to the group's next channel, the next overflow converts it
+	uint8_t next = _channel;
+	do
+	{
+		next = (next + 1) & (CHANNELS - 1);
+	} while(!(_group & _BV(next)));
+
+	bool scan_completed = next <= _channel;
+	_channel = next;
+	select(next);
+
+	if(!scan_completed)
+	{
+		return;
+	}
+
+	if(_settling > 0)
+	{
+		_settling--;
+		return;
+	}
+
+	if(++_scans < SAMPLES)
+	{
+		return;
+	}
+
+	// Publish collected readings, other groups' readings are carried over from the front frame
+	const frame_t& front = _frames[_front];
+	for(uint8_t i = 0; i < CHANNELS; i++)
+	{
+		if(!(_group & _BV(i)))
+		{
+			back.latest[i] = front.latest[i];
+		}
+		back.filtered[i] = _filters[i] >> 8;
+	}
+	back.filtered_ready = _filters_ready;
+
+	_scans = 0;
+	_front ^= 1;
+	_revision++;
+
+	// Hand the ADC over to the next group, if channels use other references
+	uint8_t reference = _reference;
+	do
+	{
+		reference = (reference + 1) & 3;
+	} while(get_group(reference) == 0);
+
+	if(reference != _reference)
+	{
+		switch_group(reference);
+	}
+}
+
+/**
+ *	Switches to a group of channels, starting from its first channel
+ *	@param	reference	group's reference voltage
+ **/
+void adc_scanner_t::switch_group(uint8_t reference)
+{
+	_reference = reference;
+	_group = get_group(reference);
+
+	// Discard whole scans until SETTLING conversions have passed
+	uint8_t size = 0;
+	for(uint8_t i = 0; i < CHANNELS; i++)
+	{
+		size += (_group >> i) & 1;
+	}
+	_settling = (SETTLING + size - 1) / size;
+
+	_channel = 0;
+	while(!(_group & _BV(_channel)))
+	{
+		_channel++;
+	}
+	select(_channel);
+}
+
+/**
+ *	Gets a group of channels
+ *	@param		reference	group's reference voltage
+ *	@returns	bit mask of registered channels using the reference
+ **/
+uint8_t adc_scanner_t::get_group(uint8_t reference) const
+{
+	uint8_t group = 0;
+	for(uint8_t i = 0; i < CHANNELS; i++)
+	{
+		if((_channels & _BV(i)) && _references[i] == reference)
+		{
+			group |= _BV(i);
+		}
+	}
+	return group;
+}
+
+/**
+ *	Accumulates a conversion for oversampling, decimates and filters it once enough conversions are collected
+ *	@param	channel		channel index
+ *	@param	value		ADC code
+ **/
+void adc_scanner_t::decimate(uint8_t channel, int value)
+{
+	uint8_t n = _oversampling[channel];
+	_decimation_sums[channel] += value;
+	if(++_decimation_counts[channel] < (1 << (2 * n)))
+	{
+		return;
+	}
+
+	// Sum of 4^n conversions shifted right by n is a (10 + n)-bit value, scale it to 16 bits
+	int32_t x = static_cast<int32_t>(_decimation_sums[channel] >> n) << (6 - n + 8);
+	_decimation_sums[channel] = 0;
+	_decimation_counts[channel] = 0;
+
+	if(!(_filters_ready & _BV(channel)))
+	{
+		_filters[channel] = x;
+		_filters_ready |= _BV(channel);
+		return;
+	}
+
+	// Exponential smoothing: y += (x - y) / 2^APP_ADC_FILTER_SHIFT
+	_filters[channel] += (x - _filters[channel]) >> APP_ADC_FILTER_SHIFT;
+}
+
+/**
+ *	Selects a channel for the next conversion
+ *	@param	channel		channel index
+ **/
+void adc_scanner_t::select(uint8_t channel)
+{
+	ADMUX = (_reference << 6) | channel;
+}
\ No newline at end of file
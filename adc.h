@@ -0,0 +1,243 @@
+#pragma once
+
+#include "Arduino.h"
+#include "_config.h"
+
+namespace thermograph
+{
+	/**
+	 *	Interrupt driven ADC scanner class.
+	 *	Converts registered analog channels one by one on every Timer0 overflow (~1 kHz)
+	 *	and publishes their latest and averaged readings once per SAMPLES scans.
+	 *	A channel may also be oversampled 4^n times and decimated into a (10 + n)-bit value,
+	 *	which is smoothed by a fixed-point IIR filter and published as a filtered reading.
+	 *	Every channel is filtered, oversampled or not, and its averaged reading is the filtered one cut down to 10 bits.
+	 *	Published readings are double buffered, so they are read without disabling interrupts.
+	 *	Channels are grouped by their reference voltage: the reference is never switched within a scan,
+	 *	a group is converted for SAMPLES scans and published, then the next group takes over.
+	 *	AREF's capacitor needs several milliseconds to settle on a new reference,
+	 *	so the first SETTLING conversions after a switch (and after start()) are discarded.
+	 *	With all channels on one reference the scanner never switches it
+	 **/
+	class adc_scanner_t
+	{
+	public:
+		/**
+		 *	Max analog channels
+		 **/
+		static const uint8_t CHANNELS = 8;
+
+		/**
+		 *	Scans per publication
+		 **/
+		static const uint8_t SAMPLES = 4;
+
+		/**
+		 *	Max oversampling: 4^3 = 64 conversions give 3 extra bits
+		 **/
+		static const uint8_t MAX_OVERSAMPLING = 3;
+
+		/**
+		 *	Conversions discarded after a reference switch, ~16 ms for a 100 nF capacitor on AREF
+		 **/
+		static const uint8_t SETTLING = 16;
+
+		/**
+		 *	Constructor
+		 **/
+		adc_scanner_t();
+
+		/**
+		 *	Registers an analog channel to scan. Must be called before start()
+		 *	@param	channel			analog channel, either 0-7 or A0-A7
+		 *	@param	reference		analog reference voltage: DEFAULT, INTERNAL or EXTERNAL
+		 *	@param	oversampling	extra bits n to gain by oversampling 4^n times, up to MAX_OVERSAMPLING
+		 **/
+		void add(uint8_t channel, uint8_t reference = DEFAULT, uint8_t oversampling = 0);
+
+		/**
+		 *	Starts scanning registered channels
+		 **/
+		void start();
+
+		/**
+		 *	Gets a value indicating whether readings have been published
+		 *	@returns	true if readings are available, false otherwise
+		 **/
+		bool ready() const { return _revision != 0; }
+
+		/**
+		 *	Gets a value indicating whether channel's filtered reading has been published
+		 *	@param		channel		analog channel, either 0-7 or A0-A7
+		 *	@returns	true if the reading is available, false otherwise
+		 **/
+		bool ready(uint8_t channel) const { return _frames[_front].filtered_ready & _BV(to_index(channel)); }
+
+		/**
+		 *	Gets channel's latest reading
+		 *	@param		channel		analog channel, either 0-7 or A0-A7
+		 *	@returns	ADC code in [0, 1023] range
+		 **/
+		int latest(uint8_t channel) const { return _frames[_front].latest[to_index(channel)]; }
+
+		/**
+		 *	Gets channel's oversampled and filtered reading
+		 *	@param		channel		analog channel, either 0-7 or A0-A7
+		 *	@returns	ADC code scaled to [0, 65535] range, (10 + n) bits of it are significant
+		 **/
+		uint16_t filtered(uint8_t channel) const { return _frames[_front].filtered[to_index(channel)]; }
+
+		/**
+		 *	Gets channel's averaged reading, the filtered one cut down to 10 bits
+		 *	@param		channel		analog channel, either 0-7 or A0-A7
+		 *	@returns	ADC code in [0, 1023] range
+		 **/
+		int average(uint8_t channel) const { return filtered(channel) >> 6; }
+
+		/**
+		 *	Gets published readings' revision number
+		 *	@returns	revision number, 0 if nothing has been published yet
+		 **/
+		uint16_t get_revision() const { return _revision; }
+
+		/**
+		 *	Handles a completed conversion. Called by ADC interrupt handler
+		 **/
+		void on_conversion();
+
+	private:
+		/**
+		 *	Published readings
+		 **/
+		struct frame_t
+		{
+			/**
+			 *	Latest readings
+			 **/
+			int latest[CHANNELS];
+
+			/**
+			 *	Oversampled and filtered readings, scaled to 16 bits
+			 **/
+			uint16_t filtered[CHANNELS];
+
+			/**
+			 *	Bit mask of channels which have filtered readings
+			 **/
+			uint8_t filtered_ready;
+		};
+
+		/**
+		 *	Published readings and readings being collected
+		 **/
+		frame_t _frames[2];
+
+		/**
+		 *	Index of published readings
+		 **/
+		volatile uint8_t _front;
+
+		/**
+		 *	Published readings' revision number
+		 **/
+		volatile uint16_t _revision;
+
+		/**
+		 *	Channels' oversampling, extra bits to gain
+		 **/
+		uint8_t _oversampling[CHANNELS];
+
+		/**
+		 *	Conversions' sums since last decimation
+		 **/
+		uint16_t _decimation_sums[CHANNELS];
+
+		/**
+		 *	Conversions since last decimation
+		 **/
+		uint8_t _decimation_counts[CHANNELS];
+
+		/**
+		 *	IIR filters' states, 16.8 fixed point
+		 **/
+		int32_t _filters[CHANNELS];
+
+		/**
+		 *	Bit mask of channels which filters have been seeded
+		 **/
+		uint8_t _filters_ready;
+
+		/**
+		 *	Registered channels' bit mask
+		 **/
+		uint8_t _channels;
+
+		/**
+		 *	Channels' reference voltages
+		 **/
+		uint8_t _references[CHANNELS];
+
+		/**
+		 *	Reference voltage of the group being converted
+		 **/
+		uint8_t _reference;
+
+		/**
+		 *	Bit mask of the group being converted
+		 **/
+		uint8_t _group;
+
+		/**
+		 *	Scans left to discard until the reference settles
+		 **/
+		uint8_t _settling;
+
+		/**
+		 *	Channel being converted
+		 **/
+		uint8_t _channel;
+
+		/**
+		 *	Complete scans since last publication
+		 **/
+		uint8_t _scans;
+
+		/**
+		 *	Accumulates a conversion for oversampling, decimates and filters it once enough conversions are collected
+		 *	@param	channel		channel index
+		 *	@param	value		ADC code
+		 **/
+		void decimate(uint8_t channel, int value);
+
+		/**
+		 *	Switches to a group of channels, starting from its first channel
+		 *	@param	reference	group's reference voltage
+		 **/
+		void switch_group(uint8_t reference);
+
+		/**
+		 *	Gets a group of channels
+		 *	@param		reference	group's reference voltage
+		 *	@returns	bit mask of registered channels using the reference
+		 **/
+		uint8_t get_group(uint8_t reference) const;
+
+		/**
+		 *	Selects a channel for the next conversion
+		 *	@param	channel		channel index
+		 **/
+		void select(uint8_t channel);
+
+		/**
+		 *	Converts a channel number into channel index
+		 *	@param		channel		analog channel, either 0-7 or A0-A7
+		 *	@returns	channel index
+		 **/
+		static uint8_t to_index(uint8_t channel) { return (channel >= A0 ? channel - A0 : channel) & (CHANNELS - 1); }
+	};
+
+	/**
+	 *	ADC scanner static instance
+	 **/
+	extern adc_scanner_t adc_scanner;
+}
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "Arduino.h"
 #include "_config.h"
+#include "adc.h"
 #include "app.h"
+#include "button.h"
+#include "data_history.h"
 #include "display.h"
 #include "log.h"
 #include "sensor.h"
@@ -18,6 +21,12 @@ using namespace thermograph;
  *	Constructor
  **/
 app_t::app_t()
+	: _sensor_task(this, &app_t::update_sensors),
+	  _sensor_poll_task(this, &app_t::poll_sensors),
+	  _button_task(this, &app_t::poll_buttons),
+	  _display_task(this, &app_t::refresh_display),
+	  _stats_task(this, &app_t::report_stats),
+	  _history_task(this, &app_t::write_history)
 { }
 
 /**
@@ -27,11 +36,17 @@ void app_t::init()
 {
 	// Initialize logging
 	log.init(9600);
-	log.info(F("app\tboot"));
+	LOG_INF(APP, F("app\tboot"));
 
 	// Initialize I/O
 	display.init();
+	button_service.init();
 	sensor.init();
+
+	// Boot messages outnumber the log buffer, history's restore report and the rest go after them
+	log.flush();
+	data_history.init();
+	adc_scanner.start();
 	
 	// Assign app mode pointers
 	_modes[0] = &_expanded_display_mode;
@@ -43,50 +58,105 @@ void app_t::init()
 	{
 		_modes[i]->init();
 	}
+
+	// Start sensors' first background reading
+	sensor.update();
+
+	// Initialize active app mode
+	_modes[_mode_index]->enter();
+
+	// Register app tasks
+	scheduler.add(F("sensor"), _sensor_task, APP_SENSOR_PERIOD * 1000, APP_SENSOR_BUDGET, APP_SENSOR_WARMUP);
+	scheduler.add(F("sensor poll"), _sensor_poll_task, APP_SENSOR_POLL_PERIOD, APP_SENSOR_POLL_BUDGET);
+	scheduler.add(F("button"), _button_task, APP_BUTTON_PERIOD, APP_BUTTON_BUDGET);
+	scheduler.add(F("display"), _display_task, APP_DISPLAY_PERIOD, APP_DISPLAY_BUDGET);
+	scheduler.add(F("stats"), _stats_task, APP_STATS_PERIOD * 1000, APP_STATS_BUDGET, APP_STATS_PERIOD * 1000);
+	scheduler.add(F("history"), _history_task, APP_HISTORY_LOG_PERIOD, APP_HISTORY_LOG_BUDGET);
 	
-	log.info(F("app\tstarted"));
+	log.flush();
+	LOG_INF(APP, F("app\tstarted"));
 }
 
 /**
- *	Runs an app
+ *	Runs an app's scheduled tasks
  **/
 void app_t::run()
 {
-	log.debug(F("app\trun"));
+	unsigned long wait = scheduler.dispatch();
+	if(wait > 0)
+	{
+		// Nothing to do until the next task's deadline
+		delay(wait);
+	}
+}
+
+/**
+ *	Updates sensor values
+ **/
+void app_t::update_sensors()
+{
+	sensor.update();
+}
 
-	// Update sensor values conditionless
-	sensor.update(sensor_service_t::UP_FORCE);
+/**
+ *	Advances sensors' background acquisition
+ **/
+void app_t::poll_sensors()
+{
+	sensor.poll();
+}
 
-	// Initialize active app mode
-	_modes[_mode_index]->enter();
+/**
+ *	Handles user I/O events
+ **/
+void app_t::poll_buttons()
+{
+	mode_event e = _modes[_mode_index]->handle_events();
 
-	while(true)
+	switch (e)
 	{
-		// Update sensor if nessesary
-		sensor.update();
+	case thermograph::ME_NONE:
+		break;
 
-		// Handle user I/O event and update display
-		mode_event e = _modes[_mode_index]->handle_events();
+	case thermograph::ME_SWITCH_MODE:
 
-		switch (e)
+		// Cycle through app modes
+		_mode_index++;
+		if(_mode_index >= sizeof(_modes)/sizeof(mode_t*))
 		{
-		case thermograph::ME_NONE:
-			break;
+			_mode_index = 0;
+		}
+
+		LOG_INF(APP, F("app\trun mode switced to #%d"), _mode_index);
 
-		case thermograph::ME_SWITCH_MODE:
+		// Initialize active app mode
+		_modes[_mode_index]->enter();
+		break;
+	}
+}
 
-			// Cycle through app modes
-			_mode_index++;
-			if(_mode_index >= sizeof(_modes)/sizeof(mode_t*))
-			{
-				_mode_index = 0;
-			}
+/**
+ *	Updates display of active app mode
+ **/
+void app_t::refresh_display()
+{
+	_modes[_mode_index]->refresh();
+}
 
-			log.info(F("app\trun mode switced to #%d"), _mode_index);
+/**
+ *	Writes scheduler and history statistics into the log
+ **/
+void app_t::report_stats()
+{
+	log.log_stats();
+	scheduler.log_stats();
+	data_history.log_stats();
+}
 
-			// Initialize active app mode
-			_modes[_mode_index]->enter();
-			break;
-		}
-	}
+/**
+ *	Writes pending history checkpoints into EEPROM
+ **/
+void app_t::write_history()
+{
+	data_history.poll();
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mode.h"
+#include "scheduler.h"
 
 namespace thermograph
 {
@@ -21,11 +22,78 @@ namespace thermograph
 		void init();
 
 		/**
-		 *	Runs an app
+		 *	Runs an app's scheduled tasks
 		 **/
 		void run();
 
 	private:
+		/**
+		 *	App task bound to an app's member function
+		 **/
+		class app_task_t : public task_t
+		{
+		public:
+			/**
+			 *	Task handler type
+			 **/
+			typedef void (app_t::*handler_t)();
+
+			/**
+			 *	Constructor
+			 *	@param	app		app instance
+			 *	@param	handler	app's member function to execute
+			 **/
+			app_task_t(app_t* app, handler_t handler)
+				: _app(app), _handler(handler)
+			{ }
+
+			/**
+			 *	Executes a task
+			 **/
+			virtual void run() { (_app->*_handler)(); }
+
+		private:
+			/**
+			 *	App instance
+			 **/
+			app_t* _app;
+
+			/**
+			 *	App's member function to execute
+			 **/
+			handler_t _handler;
+		};
+
+		/**
+		 *	Sensor acquisition task
+		 **/
+		app_task_t _sensor_task;
+
+		/**
+		 *	Sensor background acquisition task
+		 **/
+		app_task_t _sensor_poll_task;
+
+		/**
+		 *	Button polling task
+		 **/
+		app_task_t _button_task;
+
+		/**
+		 *	Display refresh task
+		 **/
+		app_task_t _display_task;
+
+		/**
+		 *	Scheduler statistics report task
+		 **/
+		app_task_t _stats_task;
+
+		/**
+		 *	History checkpoint writing task
+		 **/
+		app_task_t _history_task;
+
 		/**
 		 *	App mode - temperature display
 		 **/
@@ -50,5 +118,35 @@ namespace thermograph
 		 *	An index of active app mode in "_modes" array
 		 */
 		uint8_t _mode_index;
+
+		/**
+		 *	Updates sensor values
+		 **/
+		void update_sensors();
+
+		/**
+		 *	Advances sensors' background acquisition
+		 **/
+		void poll_sensors();
+
+		/**
+		 *	Handles user I/O events
+		 **/
+		void poll_buttons();
+
+		/**
+		 *	Updates display of active app mode
+		 **/
+		void refresh_display();
+
+		/**
+		 *	Writes scheduler and history statistics into the log
+		 **/
+		void report_stats();
+
+		/**
+		 *	Writes pending history checkpoints into EEPROM
+		 **/
+		void write_history();
 	};
 }
\ No newline at end of file
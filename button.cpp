@@ -1,4 +1,5 @@
 #include "Arduino.h"
+#include "adc.h"
 #include "button.h"
 
 using namespace thermograph;
@@ -15,19 +16,34 @@ button_service_t thermograph::button_service;
  ************************************************************************
  */
 
+/**
+ *	Initializes keypad
+ **/
+void button_service_t::init()
+{
+	adc_scanner.add(KEYPAD_CHANNEL);
+}
+
 /**
  *	Read current button state
  *	@returns button currently pressed
  **/
-button button_service_t::read_button() const
+button button_service_t::read_button()
 {
 	button btn = read_button_internal();
-	if(btn != BTN_NONE)
+	if(btn == BTN_NONE)
 	{
-		// Delay for 250ms if any button has been pressed
-		delay(250);
+		return BTN_NONE;
 	}
 
+	// Ignore a pressed button for 250ms after it has been reported
+	unsigned long now = millis();
+	if(now - _last_pressed < REPEAT_DELAY)
+	{
+		return BTN_NONE;
+	}
+
+	_last_pressed = now;
 	return btn;
 }
 
@@ -37,7 +53,12 @@ button button_service_t::read_button() const
  **/
 button button_service_t::read_button_internal() const
 {
-	int adc_key_in = analogRead(0);
+	if(!adc_scanner.ready())
+	{
+		return BTN_NONE;
+	}
+
+	int adc_key_in = adc_scanner.latest(KEYPAD_CHANNEL);
 
 	if (adc_key_in < 50)   return BTN_RIGHT;
 	if (adc_key_in < 195)  return BTN_UP;
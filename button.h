@@ -44,13 +44,38 @@ namespace thermograph
 	class button_service_t
 	{
 	public:
+		/**
+		 *	Constructor
+		 **/
+		button_service_t() : _last_pressed(0) { }
+
+		/**
+		 *	Initializes keypad
+		 **/
+		void init();
+
 		/**
 		*	Reads current button state
 		 *	@returns button currently pressed
 		 **/
-		button read_button() const;
+		button read_button();
 
 	private:
+		/**
+		 *	Keypad's analog channel
+		 **/
+		static const uint8_t KEYPAD_CHANNEL = 0;
+
+		/**
+		 *	Button repeat delay, in milliseconds
+		 **/
+		static const unsigned long REPEAT_DELAY = 250;
+
+		/**
+		 *	Last button press time
+		 **/
+		unsigned long _last_pressed;
+
 		/**
 		 *	Reads current button state immediately
 		 *	@returns button currently pressed
@@ -2,7 +2,6 @@
 #include "_config.h"
 #include "data_history.h"
 #include "log.h"
-#include "LCDBitmap.h"
 
 using namespace thermograph;
 
@@ -11,6 +10,507 @@ using namespace thermograph;
  **/
 data_history_t thermograph::data_history;
 
+/**
+ *	History tiers' spans, in history intervals
+ **/
+#define HISTORY_TIER_SPAN(span, bytes, resolution) span,
+static const uint16_t tier_spans[data_history_t::TIER_COUNT] =
+{
+	APP_HISTORY_TIERS(HISTORY_TIER_SPAN)
+};
+#undef HISTORY_TIER_SPAN
+
+/**
+ *	History tiers' column lengths, in bytes
+ **/
+#define HISTORY_TIER_BYTES(span, bytes, resolution) bytes,
+static const uint8_t tier_bytes[data_history_t::TIER_COUNT] =
+{
+	APP_HISTORY_TIERS(HISTORY_TIER_BYTES)
+};
+#undef HISTORY_TIER_BYTES
+
+#define HISTORY_TIER_CHECK(span, bytes, resolution) \
+	static_assert(bytes >= history_stream_t::MIN_CAPACITY && bytes <= history_stream_t::MAX_CAPACITY, "history tier's column length is out of range"); \
+	static_assert(resolution >= history_stream_t::MIN_RESOLUTION && resolution <= 0xFF, "history tier's resolution is out of range");
+APP_HISTORY_TIERS(HISTORY_TIER_CHECK)
+#undef HISTORY_TIER_CHECK
+
+/**
+ *	History tiers' stored values' resolutions, hundredths of a unit
+ **/
+#define HISTORY_TIER_RESOLUTION(span, bytes, resolution) resolution,
+static const uint8_t tier_resolutions[data_history_t::TIER_COUNT] =
+{
+	APP_HISTORY_TIERS(HISTORY_TIER_RESOLUTION)
+};
+#undef HISTORY_TIER_RESOLUTION
+
+/**
+ *	Metrics' short labels
+ **/
+static const char* const metric_labels[METRIC_COUNT] =
+{
+	"t",
+	"rh",
+	"dp"
+};
+
+/**
+ *	Global time's wrap-around period, in seconds
+ **/
+static const long TIME_PERIOD = 256L * 3600;
+
+/**
+ *	Gets time elapsed between two global time values
+ *	@param		from	earlier time
+ *	@param		to		later time
+ *	@returns	elapsed time, in seconds
+ **/
+static long elapsed(const thermograph::time_t& from, const thermograph::time_t& to)
+{
+	long delta = 
+		to.sec - from.sec +
+		(to.min - from.min) * 60 +
+		(to.h - from.h) * 3600L;
+
+	return delta < 0 ? delta + TIME_PERIOD : delta;
+}
+
+/**
+ *	Gets signed difference between two global time values, which are less than half a wrap-around period apart
+ *	@param		from	a time value
+ *	@param		to		another time value
+ *	@returns	to - from, in seconds
+ **/
+static long difference(const thermograph::time_t& from, const thermograph::time_t& to)
+{
+	long delta = elapsed(from, to);
+	return delta > TIME_PERIOD / 2 ? delta - TIME_PERIOD : delta;
+}
+
+/**
+ *	Advances a global time value
+ *	@param	time	global time
+ *	@param	sec		seconds to add
+ **/
+static void advance_time(thermograph::time_t& time, unsigned long sec)
+{
+	sec += time.sec + time.min * 60L + time.h * 3600L;
+	time.sec = sec % 60;
+	time.min = (sec / 60) % 60;
+	time.h = sec / 3600;
+}
+
+/**
+ *	ln(1 + i/32) for i in [0, 32], in 1/4096 units
+ **/
+static const int16_t log_table[33] PROGMEM =
+{
+	   0,  126,  248,  367,  482,  595,  704,  810,
+	 914, 1015, 1114, 1210, 1304, 1396, 1486, 1575,
+	1661, 1745, 1828, 1909, 1989, 2067, 2143, 2218,
+	2292, 2365, 2436, 2506, 2575, 2642, 2709, 2775,
+	2839
+};
+
+/**
+ *	Calculates the natural logarithm of relative humidity as a fraction
+ *	@param		rh	relative humidity, in hundredths of percent, [1, 10000]
+ *	@returns	ln(rh / 100%), in 1/4096 units
+ **/
+static long log_humidity(humidity_t rh)
+{
+	const long LN2 = 2839;
+	const long LN10000 = 37726;
+
+	// rh = m * 2^(e - 14) with m in [2^14, 2^15), so ln(rh) = ln(m / 2^14) + e * ln(2)
+	uint16_t m = rh;
+	int8_t e = 14;
+	while(m < 0x4000)
+	{
+		m <<= 1;
+		e--;
+	}
+
+	// Interpolate between table points 2^9 apart
+	uint8_t i = (m >> 9) - 32;
+	int16_t lo = pgm_read_word(&log_table[i]);
+	int16_t hi = pgm_read_word(&log_table[i + 1]);
+	long ln_m = lo + ((static_cast<long>(hi - lo) * (m & 0x1FF)) >> 9);
+
+	return ln_m + e * LN2 - LN10000;
+}
+
+/**
+ *	Calculates dew point with Magnus formula, in fixed point:
+ *	gamma = ln(rh) + b * t / (c + t), dew point = c * gamma / (b - gamma)
+ *	@param		t		temperature, in hundredths of a degree
+ *	@param		rh		relative humidity, in hundredths of percent. Must be positive
+ *	@returns	dew point, in hundredths of a degree
+ **/
+static temperature_t dew_point(temperature_t t, humidity_t rh)
+{
+	// b = 17.62 in 1/4096 units, c = 243.12 degrees in hundredths
+	const long b = 72172;
+	const long c = 24312;
+
+	long gamma = log_humidity(min(rh, 10000)) + b * t / (c + t);
+	return c * gamma / (b - gamma);
+}
+
+/*
+ ************************************************************************
+ *	column_reader_t
+ *	Streaming reader of a metric's buckets, reads a tier's columns from the oldest bucket to the newest one.
+ *	A derived metric is calculated bucket by bucket from stored ones, columns are evicted independently,
+ *	so reading starts at the slot every required column has
+ **/
+class column_reader_t
+{
+public:
+	/**
+	 *	Constructor
+	 *	@param	columns	tier's columns
+	 *	@param	slot	tier's open slot, columns' newest buckets are of the slot before
+	 *	@param	metric	a metric
+	 **/
+	column_reader_t(const history_stream_t* columns, const unsigned long slot, const history_metric metric)
+		: _metric(metric), _first(columns[first_column(metric)]), _second(columns[METRIC_HUMIDITY]), _slot(base(columns, slot, metric))
+	{
+		_first.skip(_slot - (slot - columns[first_column(metric)].size()));
+		if(metric == METRIC_DEW_POINT)
+		{
+			_second.skip(_slot - (slot - columns[METRIC_HUMIDITY].size()));
+		}
+	}
+
+	/**
+	 *	Gets the first slot a metric can be read from
+	 *	@param		columns	tier's columns
+	 *	@param		slot	tier's open slot
+	 *	@param		metric	a metric
+	 *	@returns	slot number
+	 **/
+	static unsigned long base(const history_stream_t* columns, const unsigned long slot, const history_metric metric)
+	{
+		uint16_t size = columns[first_column(metric)].size();
+		if(metric == METRIC_DEW_POINT)
+		{
+			size = min(size, columns[METRIC_HUMIDITY].size());
+		}
+		return slot - size;
+	}
+
+	/**
+	 *	Gets the slot of the next bucket
+	 *	@returns	slot number
+	 **/
+	unsigned long get_slot() const { return _slot; }
+
+	/**
+	 *	Gets buckets left to read
+	 *	@returns	buckets count
+	 **/
+	uint16_t remaining() const { return _first.remaining(); }
+
+	/**
+	 *	Skips buckets
+	 *	@param	count	buckets to skip
+	 **/
+	void skip(uint16_t count)
+	{
+		count = min(count, remaining());
+		_first.skip(count);
+		if(_metric == METRIC_DEW_POINT)
+		{
+			_second.skip(count);
+		}
+		_slot += count;
+	}
+
+	/**
+	 *	Reads the next bucket
+	 *	@param		bucket	a bucket
+	 *	@returns	true if a bucket has been read, false if there are no buckets left
+	 **/
+	bool next(history_bucket_t& bucket)
+	{
+		if(!_first.next(bucket))
+		{
+			return false;
+		}
+		_slot++;
+
+		if(_metric == METRIC_DEW_POINT)
+		{
+			// The spread isn't derived, only the mean
+			history_bucket_t humidity;
+			_second.next(humidity);
+			if(bucket.is_gap() || humidity.is_gap() || humidity.mean <= 0)
+			{
+				bucket.mean = history_bucket_t::GAP;
+			}
+			else
+			{
+				bucket.mean = dew_point(bucket.mean, humidity.mean);
+			}
+			bucket.min = bucket.mean;
+			bucket.max = bucket.mean;
+		}
+		return true;
+	}
+
+private:
+	/**
+	 *	Metric being read
+	 **/
+	history_metric _metric;
+
+	/**
+	 *	Reader of the metric's column, the temperature one for a derived metric
+	 **/
+	history_stream_t::reader_t _first;
+
+	/**
+	 *	Reader of the humidity column, used by a derived metric only
+	 **/
+	history_stream_t::reader_t _second;
+
+	/**
+	 *	Slot of the next bucket
+	 **/
+	unsigned long _slot;
+
+	/**
+	 *	Gets the column a metric is read from
+	 *	@param		metric	a metric
+	 *	@returns	the metric itself if it's stored, the temperature column otherwise
+	 **/
+	static uint8_t first_column(const history_metric metric)
+	{
+		return metric < data_history_t::COLUMN_COUNT ? metric : METRIC_TEMPERATURE;
+	}
+};
+
+/*
+ ************************************************************************
+ *	aggregate_builder_t
+ *	Single pass aggregation of history buckets
+ ************************************************************************
+ */
+
+/**
+ *	Single pass aggregation of history buckets class
+ **/
+class aggregate_builder_t
+{
+public:
+	/**
+	 *	Starts a new aggregate
+	 *	@param	start	global time the aggregate starts at
+	 **/
+	void reset(const thermograph::time_t& start)
+	{
+		_aggregate.start = start;
+		_aggregate.count = 0;
+		_sum = 0;
+		_sx = 0;
+		_sxx = 0;
+		_sy = 0;
+		_sxy = 0;
+	}
+
+	/**
+	 *	Adds a bucket
+	 *	@param	x		bucket's slot relative to the aggregate's start
+	 *	@param	bucket	a bucket, must not be a gap
+	 **/
+	void add(long x, const history_bucket_t& bucket)
+	{
+		history_aggregate_t& a = _aggregate;
+		if(a.count == 0)
+		{
+			a.min = bucket.min;
+			a.max = bucket.max;
+			a.first = bucket.mean;
+		}
+		if(bucket.min < a.min)
+		{
+			a.min = bucket.min;
+		}
+		if(bucket.max > a.max)
+		{
+			a.max = bucket.max;
+		}
+		a.last = bucket.mean;
+		a.count++;
+
+		// Trend's sums are relative to the first value to keep them small
+		long y = bucket.mean - a.first;
+		_sum += bucket.mean;
+		_sx += x;
+		_sxx += x * x;
+		_sy += y;
+		_sxy += x * y;
+	}
+
+	/**
+	 *	Completes the aggregate. The trend is fitted in 32-bit integers,
+	 *	its sums hold for up to 64 buckets spread over 80 degrees
+	 *	@param		interval	aggregated buckets' interval, in seconds
+	 *	@returns	the aggregate
+	 **/
+	const history_aggregate_t& build(unsigned long interval)
+	{
+		history_aggregate_t& a = _aggregate;
+		a.slope = 0;
+		if(a.count == 0)
+		{
+			return a;
+		}
+
+		a.mean = _sum / a.count;
+
+		// Least squares: (n * Sxy - Sx * Sy) / (n * Sxx - Sx^2), per slot
+		long n = a.count;
+		long d = n * _sxx - _sx * _sx;
+		if(d != 0)
+		{
+			// Per slot slope in 1/256 units from the quotient and the remainder,
+			// limited so that scaling it to an hour doesn't overflow
+			long num = n * _sxy - _sx * _sy;
+			long k = num / d * 256 + (num % d) * 256 / d;
+			k = constrain(k, -MAX_SLOT_SLOPE, MAX_SLOT_SLOPE);
+			a.slope = k * 3600 / static_cast<long>(interval) / 256;
+		}
+
+		return a;
+	}
+
+private:
+	/**
+	 *	Max per slot slope, in 1/256 hundredths of a unit
+	 **/
+	static const long MAX_SLOT_SLOPE = 0x7FFFFFFFL / 3600;
+
+	history_aggregate_t _aggregate;
+	long _sum;
+	long _sx;
+	long _sxx;
+	long _sy;
+	long _sxy;
+};
+
+/*
+ ************************************************************************
+ *	aggregate_exporter_t
+ *	Writes query results into the log
+ ************************************************************************
+ */
+
+/**
+ *	Query results exporter class
+ **/
+class aggregate_exporter_t : public history_visitor_t
+{
+public:
+	/**
+	 *	Constructor
+	 *	@param	id		sensor's ID
+	 *	@param	metric	exported metric
+	 **/
+	aggregate_exporter_t(const sensor_id id, const history_metric metric) : _id(id), _metric(metric) { }
+
+	/**
+	 *	Writes a query result into the log
+	 *	@param	aggregate	measurement results of a time range
+	 **/
+	virtual void visit(const history_aggregate_t& aggregate)
+	{
+		if(aggregate.count == 0)
+		{
+			LOG_INF(HISTORY, F("data_history\t%s, %s: no data"), sensor.get_name(_id), data_history_t::get_label(_metric));
+			return;
+		}
+
+		LOG_INF(HISTORY, F("data_history\t%s, %s: %d buckets, min = %h, max = %h, mean = %h, first = %h, last = %h, slope = %l/h"),
+			sensor.get_name(_id), data_history_t::get_label(_metric), aggregate.count, aggregate.min, aggregate.max, aggregate.mean, aggregate.first, aggregate.last, aggregate.slope);
+	}
+
+private:
+	/**
+	 *	Sensor's ID
+	 **/
+	sensor_id _id;
+
+	/**
+	 *	Exported metric
+	 **/
+	history_metric _metric;
+};
+
+/*
+ ************************************************************************
+ *	data_history_t::accumulator_t
+ *	Running aggregate of a bucket being filled
+ ************************************************************************
+ */
+
+/**
+ *	Adds a measured value
+ *	@param	t	measurement result
+ **/
+void data_history_t::accumulator_t::add(const temperature_t t)
+{
+	if(count == 0 || t < min)
+	{
+		min = t;
+	}
+	if(count == 0 || t > max)
+	{
+		max = t;
+	}
+	sum += t;
+	count++;
+}
+
+/**
+ *	Merges another aggregate in
+ *	@param	other	an aggregate to merge
+ **/
+void data_history_t::accumulator_t::add(const accumulator_t& other)
+{
+	if(other.count == 0)
+	{
+		return;
+	}
+
+	if(count == 0 || other.min < min)
+	{
+		min = other.min;
+	}
+	if(count == 0 || other.max > max)
+	{
+		max = other.max;
+	}
+	sum += other.sum;
+	count += other.count;
+}
+
+/**
+ *	Gets aggregated values as a bucket. The aggregate must not be empty
+ *	@returns	a bucket
+ **/
+data_history_t::bucket_t data_history_t::accumulator_t::to_bucket() const
+{
+	bucket_t bucket;
+	bucket.min = min;
+	bucket.max = max;
+	bucket.mean = sum / count;
+	return bucket;
+}
+
 /*
  ************************************************************************
  *	data_history_t
@@ -19,156 +519,677 @@ data_history_t thermograph::data_history;
  */
 
 /**
- *	Pushes a new value into the history
+ *	Constructor
+ **/
+data_history_t::data_history_t() : _checkpoints(APP_HISTORY_LOG_ADDRESS, APP_HISTORY_LOG_BYTES), _rev(0), _cache_hits(0), _cache_misses(0)
+{
+	_projection.height = 0;
+
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
+	{
+		_started[id] = false;
+		_revs[id] = 0;
+		_pending[id] = 0;
+
+		uint8_t* bytes = _bytes[id];
+		for(uint8_t tier = 0; tier < TIER_COUNT; tier++)
+		{
+			for(uint8_t column = 0; column < COLUMN_COUNT; column++)
+			{
+				_tiers[id][tier].columns[column].attach(bytes, tier_bytes[tier], tier_resolutions[tier]);
+				_tiers[id][tier].open[column].reset();
+				bytes += tier_bytes[tier];
+			}
+			_tiers[id][tier].slot = 0;
+			_tiers[id][tier].rollups = 0;
+		}
+	}
+}
+
+/**
+ *	Gets a metric's short label
+ *	@param		metric	a metric
+ *	@returns	metric's label
+ **/
+const char* data_history_t::get_label(const history_metric metric)
+{
+	return metric_labels[metric];
+}
+
+/**
+ *	Gets a time span covered by a history tier
+ *	@param		tier	history tier, 0 is the finest one
+ *	@returns	time span, in seconds
+ **/
+unsigned long data_history_t::get_span(const uint8_t tier)
+{
+	return get_interval(tier) * DATA_POINTS_COUNT;
+}
+
+/**
+ *	Gets a time span aggregated into a bucket of a history tier
+ *	@param		tier	history tier, 0 is the finest one
+ *	@returns	time span, in seconds
+ **/
+unsigned long data_history_t::get_interval(const uint8_t tier)
+{
+	return static_cast<unsigned long>(tier_spans[tier]) * APP_HISTORY_INTERVAL;
+}
+
+/**
+ *	Gets global time a bucket of a history tier has started at
+ *	@param		id		sensor's ID
+ *	@param		tier	history tier, 0 is the finest one
+ *	@param		age		bucket's age, 0 is the newest one
+ *	@returns	bucket's start time
+ **/
+thermograph::time_t data_history_t::get_time(const sensor_id id, const uint8_t tier, const uint16_t age) const
+{
+	// Buckets older than the history's start precede the origin, so the offset is signed
+	long offset = (static_cast<long>(_tiers[id][tier].slot) - 1 - age) * static_cast<long>(get_interval(tier)) % TIME_PERIOD;
+
+	time_t time = _origin[id];
+	advance_time(time, offset < 0 ? offset + TIME_PERIOD : offset);
+	return time;
+}
+
+/**
+ *	Gets the global time the finest tier's open bucket has started at
+ *	@param		id	sensor's ID
+ *	@returns	global time
+ **/
+thermograph::time_t data_history_t::get_opened(const sensor_id id) const
+{
+	time_t time = _origin[id];
+	advance_time(time, _tiers[id][0].slot * get_interval(0) % TIME_PERIOD);
+	return time;
+}
+
+/**
+ *	Adds a measurement result into the finest tier's open bucket
+ *	@param	id		sensor's ID
+ *	@param	metric	a stored metric
+ *	@param	value	measurement result, in hundredths of metric's unit
+ **/
+void data_history_t::push(const sensor_id id, const history_metric metric, const int16_t value)
+{
+	_tiers[id][0].open[metric].add(value);
+}
+
+/**
+ *	Closes history intervals which have passed by, the ones without measurements become gaps
  *	@param	id		sensor's ID
  *	@param	time	current global time
- *	@param	t		measurement result
  **/
-void data_history_t::push(const sensor_id id, const time_t& time, const temperature_t t)
+void data_history_t::advance(const sensor_id id, const time_t& time)
 {
-	data_point_t* points = get_array(id);
+	if(!_started[id])
+	{
+		// History starts with the first acquisition round, right after the restored one if any
+		_origin[id] = time;
+		advance_time(_origin[id], TIME_PERIOD - _tiers[id][0].slot * get_interval(0) % TIME_PERIOD);
+		_started[id] = true;
+		return;
+	}
 
-	if(_is_first)
+	long delta = elapsed(get_opened(id), time);
+	while(delta >= APP_HISTORY_INTERVAL)
 	{
-		// If history is empty then fill the history with current value
-		for (size_t i = 0; i < DATA_POINTS_COUNT; i++)
+		const accumulator_t& open = _tiers[id][0].open[METRIC_TEMPERATURE];
+		bool gap = open.count == 0;
+		temperature_t mean = gap ? 0 : open.to_bucket().mean;
+		close(id, 0);
+		delta -= APP_HISTORY_INTERVAL;
+
+		// Increment revision number
+		_rev++;
+		_revs[id]++;
+
+		if(gap)
 		{
-			points[i - 1].time =time;
-			points[i - 1].value =  t;
+			LOG_DBG(HISTORY, F("data_history\tadvance(): gap, rev = #%d"), _rev);
 		}
+		else
+		{
+			LOG_DBG(HISTORY, F("data_history\tadvance(): new data point, t = %h deg, rev = #%d"), mean, _rev);
+		}
+	}
+}
 
-		_is_first = false;
+/**
+ *	Closes a tier's open bucket and rolls it up into the coarser tier
+ *	@param	id		sensor's ID
+ *	@param	tier	history tier
+ **/
+void data_history_t::close(const sensor_id id, const uint8_t tier)
+{
+	tier_t& current = _tiers[id][tier];
+
+	for(uint8_t column = 0; column < COLUMN_COUNT; column++)
+	{
+		const accumulator_t& open = current.open[column];
+		// The checkpoint is written by poll(), it's dropped if the column's newest bucket is a gap by then
+		uint8_t pending = 1 << (tier * COLUMN_COUNT + column);
+		if(open.count == 0)
+		{
+			current.columns[column].push_gap();
+			_pending[id] &= ~pending;
+		}
+		else
+		{
+			current.columns[column].push(open.to_bucket());
+			if(tier != 0)
+			{
+				_pending[id] |= pending;
+			}
+		}
 	}
-	else
+	current.slot++;
+
+	if(tier + 1 < TIER_COUNT)
 	{
-		time_t& last_time = points[DATA_POINTS_COUNT - 1].time;
-		long delta = 
-			time.sec - last_time.sec +
-			(time.min - last_time.min) * 60 +
-			(time.h - last_time.h) * 360;
+		tier_t& coarser = _tiers[id][tier + 1];
+		for(uint8_t column = 0; column < COLUMN_COUNT; column++)
+		{
+			coarser.open[column].add(current.open[column]);
+		}
 
-		if(delta < APP_HISTORY_INTERVAL)
+		if(++coarser.rollups == tier_spans[tier + 1] / tier_spans[tier])
 		{
-			// Ignore value updates if it happened too fast
-			return;
+			close(id, tier + 1);
 		}
+	}
+
+	for(uint8_t column = 0; column < COLUMN_COUNT; column++)
+	{
+		current.open[column].reset();
+	}
+	current.rollups = 0;
+}
+
+/**
+ *	Restores coarse history tiers from the checkpoints made before the reboot.
+ *	The time the board has been off for is unknown, so measurements continue right after the newest checkpoint
+ **/
+void data_history_t::init()
+{
+	unsigned long started = millis();
 
-		// Move measurement results in order to free the last array item
-		for (size_t i = 1; i < DATA_POINTS_COUNT; i++)
+	_checkpoints.init();
+
+	// Replay checkpoints from the oldest to the newest one
+	eeprom_log_t::reader_t reader(_checkpoints);
+	uint8_t record[eeprom_log_t::PAYLOAD];
+	uint16_t count = 0;
+	while(reader.next(record))
+	{
+		sensor_id id = record[0] >> 4;
+		uint8_t column = record[0] >> 2 & 0x03;
+		uint8_t tier = record[0] & 0x03;
+		if(id >= SENSOR_COUNT || column >= COLUMN_COUNT || tier == 0 || tier >= TIER_COUNT)
 		{
-			points[i - 1].time = points[i].time;
-			points[i - 1].value =  points[i].value;
+			continue;
 		}
 
-		// Write current value into the last array item
-		data_point_t& point = points[DATA_POINTS_COUNT - 1];
-		point.time = time;
-		point.value = t;
+		unsigned long slot = record[1] | static_cast<unsigned long>(record[2]) << 8 | static_cast<unsigned long>(record[3]) << 16;
+
+		bucket_t bucket;
+		bucket.mean = record[4] | record[5] << 8;
+		bucket.min = bucket.mean - record[6] * tier_resolutions[tier];
+		bucket.max = bucket.mean + record[7] * tier_resolutions[tier];
+
+		// Columns are restored in lockstep, a slot's buckets are kept open until a newer slot's one
+		if(restore(id, tier, slot))
+		{
+			accumulator_t& open = _tiers[id][tier].open[column];
+			open.sum = bucket.mean;
+			open.count = 1;
+			open.min = bucket.min;
+			open.max = bucket.max;
+			count++;
+		}
 	}
 
-	// Increment revision number
-	_rev++;
+	// Align tiers with the newest restored bucket
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
+	{
+		unsigned long next = 0;
+		for(uint8_t tier = 1; tier < TIER_COUNT; tier++)
+		{
+			tier_t& current = _tiers[id][tier];
+			for(uint8_t column = 0; column < COLUMN_COUNT; column++)
+			{
+				if(current.open[column].count != 0)
+				{
+					restore(id, tier, current.slot + 1);
+					break;
+				}
+			}
+			next = max(next, current.slot * tier_spans[tier] / tier_spans[0]);
+		}
+
+		if(next == 0)
+		{
+			continue;
+		}
+
+		for(uint8_t tier = 0; tier < TIER_COUNT; tier++)
+		{
+			restore(id, tier, next * tier_spans[0] / tier_spans[tier]);
+
+			if(tier != 0)
+			{
+				// Finer buckets of the open bucket are only restored in the finer tier, it aggregates new ones only
+				_tiers[id][tier].rollups = next * tier_spans[0] / tier_spans[tier - 1] % (tier_spans[tier] / tier_spans[tier - 1]);
+			}
+		}
 
-	log.info(F("data_history\tpush(): new data point, t = %f deg, rev = #%d"), &t, _rev);
+		_revs[id]++;
+	}
+
+	LOG_INF(HISTORY, F("data_history\tinit(): %d of %d checkpoints restored in %l ms"), count, _checkpoints.get_capacity(), millis() - started);
+}
+
+/**
+ *	Aggregates measurement results of a time range into consecutive buckets of the same width.
+ *	Reads the finest history tier which still covers the range start, in a single pass
+ *	@param	id		sensor's ID
+ *	@param	metric	a metric
+ *	@param	from	range start, global time
+ *	@param	to		range end, global time, excluded
+ *	@param	width	bucket width, in seconds
+ *	@param	visitor	receiver of aggregated buckets
+ **/
+void data_history_t::query(const sensor_id id, const history_metric metric, const time_t& from, const time_t& to, const unsigned long width, history_visitor_t& visitor) const
+{
+	if(!_started[id] || width == 0)
+	{
+		return;
+	}
+
+	// Slot starts are offsets from the history's origin, so is the range
+	long now = _tiers[id][0].slot * get_interval(0);
+	time_t opened = get_opened(id);
+	long begin = now + difference(opened, from);
+	long end = now + difference(opened, to);
+
+	// Pick the finest tier which covers the range start, but doesn't split result buckets
+	uint8_t tier = 0;
+	for(uint8_t k = 0; k < TIER_COUNT && get_interval(k) <= width; k++)
+	{
+		tier = k;
+		if(static_cast<long>(column_reader_t::base(_tiers[id][k].columns, _tiers[id][k].slot, metric) * get_interval(k)) <= begin)
+		{
+			break;
+		}
+	}
+
+	const unsigned long interval = get_interval(tier);
+
+	// Skip buckets started before the range
+	column_reader_t reader(_tiers[id][tier].columns, _tiers[id][tier].slot, metric);
+	if(begin > 0)
+	{
+		unsigned long first = (begin + interval - 1) / interval;
+		if(first > reader.get_slot())
+		{
+			reader.skip(min(first - reader.get_slot(), reader.remaining()));
+		}
+	}
+
+	aggregate_builder_t builder;
+	builder.reset(from);
+	long index = 0;
+	long last = (end - begin + static_cast<long>(width) - 1) / static_cast<long>(width);
+
+	bucket_t bucket;
+	while(true)
+	{
+		long start = reader.get_slot() * interval;
+		if(!reader.next(bucket))
+		{
+			break;
+		}
+		if(start >= end)
+		{
+			break;
+		}
+
+		// Complete result buckets which end before this one
+		long target = (start - begin) / static_cast<long>(width);
+		while(index < target)
+		{
+			visitor.visit(builder.build(interval));
+			index++;
+
+			time_t time = from;
+			advance_time(time, index * width);
+			builder.reset(time);
+		}
+
+		if(!bucket.is_gap())
+		{
+			builder.add((start - begin - index * static_cast<long>(width)) / static_cast<long>(interval), bucket);
+		}
+	}
+
+	while(index < last)
+	{
+		visitor.visit(builder.build(interval));
+		index++;
+
+		time_t time = from;
+		advance_time(time, index * width);
+		builder.reset(time);
+	}
+}
+
+/**
+ *	Gets statistics of a metric's last DATA_POINTS_COUNT buckets of a history tier.
+ *	The window is filled in one decoding pass, then every statistic is O(1)
+ *	@param	id		sensor's ID
+ *	@param	tier	history tier, 0 is the finest one
+ *	@param	metric	a metric
+ *	@param	stats	window statistics, must be empty
+ **/
+void data_history_t::get_stats(const sensor_id id, const uint8_t tier, const history_metric metric, window_t& stats) const
+{
+	column_reader_t reader(_tiers[id][tier].columns, _tiers[id][tier].slot, metric);
+	if(reader.remaining() > DATA_POINTS_COUNT)
+	{
+		reader.skip(reader.remaining() - DATA_POINTS_COUNT);
+	}
+
+	bucket_t bucket;
+	while (reader.next(bucket))
+	{
+		if(bucket.is_gap())
+		{
+			stats.push_gap();
+		}
+		else
+		{
+			stats.push(bucket.mean);
+		}
+	}
 }
 
 /**
  *	Retrieves last measurement results in normalized form.
- *	Measurement results will be normalized to [0, 255] range
- *	@param	id	sensor's ID
- *	@param	arr	an array for measurement results. Must have at least DATA_POINTS_COUNT items
+ *	Measurement results will be normalized to [0, height] range, gaps are 0.
+ *	The last projection is cached until sensor's history revision changes
+ *	@param	id		sensor's ID
+ *	@param	tier	history tier, 0 is the finest one
+ *	@param	metric	a metric
+ *	@param	arr		an array for measurement results. Must have at least DATA_POINTS_COUNT items
+ *	@param	height	chart's height, pixels
  */
-void data_history_t::get_points(const sensor_id id, byte* arr) const
+void data_history_t::get_points(const sensor_id id, const uint8_t tier, const history_metric metric, byte* arr, const uint8_t height) const
+{
+	projection_t& projection = _projection;
+	if(projection.height == height && projection.sensor == id && projection.tier == tier && projection.metric == metric && projection.rev == _revs[id])
+	{
+		_cache_hits++;
+	}
+	else
+	{
+		_cache_misses++;
+		project(id, tier, metric, projection.points, height);
+		projection.sensor = id;
+		projection.tier = tier;
+		projection.metric = metric;
+		projection.rev = _revs[id];
+		projection.height = height;
+	}
+
+	memcpy(arr, projection.points, DATA_POINTS_COUNT);
+}
+
+/**
+ *	Writes pending checkpoints into the persistent log, at most one EEPROM byte per call.
+ *	A checkpoint is staged once the previous one has been written completely
+ **/
+void data_history_t::poll()
 {
-	const data_point_t* points = get_array(id);
+	_checkpoints.poll();
+	if(_checkpoints.busy())
+	{
+		return;
+	}
 
-#ifdef APP_CHART_MODE_AVG
-	float ps[DATA_POINTS_COUNT];
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
+	{
+		for(uint8_t bit = 0; bit < TIER_COUNT * COLUMN_COUNT; bit++)
+		{
+			if(_pending[id] & (1 << bit))
+			{
+				_pending[id] &= ~(1 << bit);
+				checkpoint(id, bit / COLUMN_COUNT, bit % COLUMN_COUNT);
+				return;
+			}
+		}
+	}
+}
+
+/**
+ *	Writes a column's newest bucket into the persistent history log
+ *	@param	id		sensor's ID
+ *	@param	tier	history tier, must not be the finest one
+ *	@param	column	a stored metric
+ **/
+void data_history_t::checkpoint(const sensor_id id, const uint8_t tier, const uint8_t column)
+{
+	const history_stream_t& buckets = _tiers[id][tier].columns[column];
+	unsigned long slot = _tiers[id][tier].slot - 1;
 
-	// Dump measurement points & calculate boundaries
-	float min = 1000, max = -1000, avg = 0;
-	for (int i = 0; i < DATA_POINTS_COUNT; i++)
+	// Columns keep no decoded copy of their newest bucket, a column is only a few dozen bytes to decode
+	bucket_t bucket;
+	history_stream_t::reader_t reader(buckets);
+	reader.skip(reader.remaining() - 1);
+	reader.next(bucket);
+
+	// Stored values are multiples of the resolution, so is the spread.
+	// Column and tier take 2 bits each
+	uint8_t record[eeprom_log_t::PAYLOAD];
+	record[0] = id << 4 | column << 2 | tier;
+	record[1] = slot;
+	record[2] = slot >> 8;
+	record[3] = slot >> 16;
+	record[4] = bucket.mean;
+	record[5] = bucket.mean >> 8;
+	record[6] = min((bucket.mean - bucket.min) / buckets.resolution(), 0xFF);
+	record[7] = min((bucket.max - bucket.mean) / buckets.resolution(), 0xFF);
+
+	_checkpoints.append(record);
+}
+
+/**
+ *	Moves a tier to a slot while restoring it. Restored buckets of the open slot are closed,
+ *	skipped slots become gaps, a gap longer than a chart drops the older buckets
+ *	@param		id		sensor's ID
+ *	@param		tier	history tier
+ *	@param		slot	slot to open
+ *	@returns	false if the tier is already past the slot, true otherwise
+ **/
+bool data_history_t::restore(const sensor_id id, const uint8_t tier, const unsigned long slot)
+{
+	tier_t& current = _tiers[id][tier];
+	if(slot < current.slot)
 	{
-		float x = points[i].value;
-		ps[i] = x;
+		return false;
+	}
 
-		if(x > max)
+	if(slot - current.slot > DATA_POINTS_COUNT)
+	{
+		for(uint8_t column = 0; column < COLUMN_COUNT; column++)
 		{
-			max = x;
-		} 
-		if(x < min)
+			current.columns[column].reset();
+			current.open[column].reset();
+		}
+		current.slot = slot;
+		return true;
+	}
+
+	for(; current.slot < slot; current.slot++)
+	{
+		for(uint8_t column = 0; column < COLUMN_COUNT; column++)
 		{
-			min = x;
+			accumulator_t& open = current.open[column];
+			if(open.count == 0)
+			{
+				current.columns[column].push_gap();
+			}
+			else
+			{
+				current.columns[column].push(open.to_bucket());
+			}
+			open.reset();
 		}
-		avg += x;
 	}
+	return true;
+}
 
-	// Normalize data
-	avg /= DATA_POINTS_COUNT;
-	float amp = max(avg - min, max - avg);
-	float k = (BITMAP_H/2.0 - 1) / amp;
+/**
+ *	Writes chart projection cache statistics and the last hour's aggregates into the log
+ **/
+void data_history_t::log_stats() const
+{
+	if(!LOG_ENABLED(HISTORY, LOG_INFO))
+	{
+		return;
+	}
 
-	log_event_t e = log.begin_event(LOG_DEBUG);
-	e.printf(F("data_history\tget_points(): avg %f, amp %f, k = %f -> [ "), &avg, &amp, &k);
+	LOG_INF(HISTORY, F("data_history\tchart cache: hits = %l, misses = %l"), _cache_hits, _cache_misses);
 
-	for (int i = 0; i < DATA_POINTS_COUNT; i++)
+	// Export the last closed hour of every sensor's metric
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
 	{
-		float x = ps[i];
-		float t = k*(x - avg);
+		if(!_started[id])
+		{
+			continue;
+		}
+
+		time_t to = get_opened(id);
+		time_t from = to;
+		advance_time(from, TIME_PERIOD - 3600);
 
-		byte y = (byte)(k*(x - avg)) + BITMAP_H/2;
-		arr[i] = y;
-		e.printf(F("(%f, %d) "), &x, y);
+		for(uint8_t metric = 0; metric < METRIC_COUNT; metric++)
+		{
+			aggregate_exporter_t exporter(id, static_cast<history_metric>(metric));
+			query(id, static_cast<history_metric>(metric), from, to, 3600, exporter);
+		}
 	}
+}
 
-	e.printf(F("]"));
-#else
-	float ps[DATA_POINTS_COUNT];
+/**
+ *	Normalizes last measurement results
+ *	@param	id		sensor's ID
+ *	@param	tier	history tier, 0 is the finest one
+ *	@param	metric	a metric
+ *	@param	arr		an array for measurement results. Must have at least DATA_POINTS_COUNT items
+ *	@param	height	chart's height, pixels
+ */
+void data_history_t::project(const sensor_id id, const uint8_t tier, const history_metric metric, byte* arr, const uint8_t height) const
+{
+	// The points are decoded twice, to find their range and to scale them, rather than kept in a window on the stack.
+	// A projection is cached until the next bucket, so it's made once a history interval at most
+	const history_stream_t& buckets = _tiers[id][tier].columns[metric < COLUMN_COUNT ? metric : METRIC_TEMPERATURE];
+	const tier_t& current = _tiers[id][tier];
+	uint8_t count = min(column_reader_t(current.columns, current.slot, metric).remaining(), static_cast<uint16_t>(DATA_POINTS_COUNT));
+
+	temperature_t low = 0;
+	temperature_t high = 0;
+	long sum = 0;
+	uint8_t values = 0;
+	{
+		column_reader_t reader(current.columns, current.slot, metric);
+		reader.skip(reader.remaining() - count);
+
+		bucket_t bucket;
+		while(reader.next(bucket))
+		{
+			if(bucket.is_gap())
+			{
+				continue;
+			}
 
-	// Dump measurement points & calculate boundaries
-	float max = -1000;
-	for (int i = 0; i < DATA_POINTS_COUNT; i++)
+			low = values == 0 ? bucket.mean : min(low, bucket.mean);
+			high = values == 0 ? bucket.mean : max(high, bucket.mean);
+			sum += bucket.mean;
+			values++;
+		}
+	}
+
+#ifdef APP_CHART_MODE_AVG
+	// Normalize data around average value
+	int base = 0;
+	int amp = 1;
+	if(values != 0)
 	{
-		int x = points[i].value;
-		ps[i] = x;
-		if(x > max)
+		base = sum / values;
+		amp = max(base - low, high - base);
+		if(amp == 0)
 		{
-			max = x;
+			amp = 1;
 		}
 	}
+	const uint8_t shift = height/2;
+#else
+	// Normalize data to max value
+	const int base = 0;
+	int amp = 1;
+	if(values != 0 && high > amp)
+	{
+		amp = high;
+	}
+	const uint8_t shift = 1;
+#endif
 
-	// Normalize data
-	float k = (BITMAP_H/2.0 - 1) / max;
+	// Points older than the stored buckets are gaps
+	uint8_t i = 0;
+	while(i < DATA_POINTS_COUNT - count)
+	{
+		arr[i++] = 0;
+	}
 
-	log_event_t e = log.begin_event(LOG_DEBUG);
-	e.printf(F("data_history\tget_points(): to %f with k = %f [ "), &max, &k);
+	column_reader_t reader(current.columns, current.slot, metric);
+	reader.skip(reader.remaining() - count);
 
-	for (int i = 0; i < DATA_POINTS_COUNT; i++)
+	bucket_t bucket;
+	while(reader.next(bucket))
 	{
-		float x = ps[i];
-		byte y = (byte)(k*x) + 1;
-		arr[i] = y;
-		e.printf(F("(%f, %d) "), &x, y);
+		arr[i++] = bucket.is_gap() ? 0 : static_cast<long>(bucket.mean - base) * (height/2 - 1) / amp + shift;
 	}
 
-	e.printf(F("]"));
+	if(LOG_ENABLED(HISTORY, LOG_DEBUG))
+	{
+		log_event_t e = log.begin_event(LOG_DEBUG);
+#ifdef APP_CHART_MODE_AVG
+		LOG_APPEND(e, F("data_history\tproject(): %d buckets in %d bytes, avg %h, amp %h -> [ "), buckets.size(), buckets.used(), base, amp);
+#else
+		LOG_APPEND(e, F("data_history\tproject(): %d buckets in %d bytes, to %h [ "), buckets.size(), buckets.used(), amp);
 #endif
-}
 
-/**
- *	Gets an array containing measurement results for specified sensor
- *	@param		id	sensor's ID
- *	@returns	an array of measurement data points
-**/
-data_history_t::data_point_t* data_history_t::get_array(const sensor_id id) const
-{
-	switch (id)
-	{
-	case SENSOR_ID_INDOOR:
-		return _indoor_points;
-	case SENSOR_ID_OUTDOOR:
-		return _outdoor_points;
-	default:
-		return NULL;
+		for(i = 0; i < DATA_POINTS_COUNT - count; i++)
+		{
+			LOG_APPEND(e, F("- "));
+		}
+
+		column_reader_t values_reader(current.columns, current.slot, metric);
+		values_reader.skip(values_reader.remaining() - count);
+		while(values_reader.next(bucket))
+		{
+			if(bucket.is_gap())
+			{
+				LOG_APPEND(e, F("- "));
+			}
+			else
+			{
+				LOG_APPEND(e, F("(%h, %d) "), bucket.mean, arr[i]);
+			}
+			i++;
+		}
+
+		LOG_APPEND(e, F("]"));
 	}
 }
\ No newline at end of file
@@ -1,41 +1,241 @@
 #pragma once
 
+#include "_config.h"
 #include "time.h"
 #include "sensor.h"
+#include "history_stream.h"
+#include "window_stats.h"
+#include "eeprom_log.h"
 
 namespace thermograph
 {
 	/**
-	 *	Measurements' history storage class
+	 *	History metrics. Stored metrics come first, the rest are derived from them when read
+	 **/
+	enum history_metric
+	{
+		METRIC_TEMPERATURE,
+		METRIC_HUMIDITY,
+		METRIC_DEW_POINT,
+		METRIC_COUNT
+	};
+
+	/**
+	 *	Measurement results aggregated over a time range
+	 **/
+	struct history_aggregate_t
+	{
+		/**
+		 *	Global time the range starts at
+		 **/
+		time_t start;
+
+		/**
+		 *	History buckets aggregated, 0 if there are no measurements in the range
+		 **/
+		uint16_t count;
+
+		/**
+		 *	Min measured value
+		 **/
+		temperature_t min;
+
+		/**
+		 *	Max measured value
+		 **/
+		temperature_t max;
+
+		/**
+		 *	Average measured value
+		 **/
+		temperature_t mean;
+
+		/**
+		 *	The earliest average value
+		 **/
+		temperature_t first;
+
+		/**
+		 *	The latest average value
+		 **/
+		temperature_t last;
+
+		/**
+		 *	Linear trend's slope, in hundredths of a unit per hour
+		 **/
+		long slope;
+	};
+
+	/**
+	 *	History query results receiver base class
+	 **/
+	class history_visitor_t
+	{
+	protected:
+		/**
+		 *	Destructor, visitors live on query callers' stack
+		 **/
+		~history_visitor_t() { }
+
+	public:
+		/**
+		 *	Receives a query result, results are received in time order
+		 *	@param	aggregate	measurement results of a time range
+		 **/
+		virtual void visit(const history_aggregate_t& aggregate) = 0;
+	};
+
+	/**
+	 *	Measurements' history storage class.
+	 *	Keeps a round-robin database of APP_HISTORY_TIERS tiers per sensor, finest first.
+	 *	A tier stores every stored metric in its own column of buckets, columns share the tier's slots,
+	 *	so a bucket's time is derived once for all metrics and a metric is scanned without touching others.
+	 *	Measurements are aggregated into the finest tier's buckets, every closed bucket
+	 *	is rolled up into the next coarser tier, so every tier is updated incrementally.
+	 *	Closed buckets of coarse tiers are checkpointed into a persistent log and restored on boot
 	 **/
 	class data_history_t
 	{
 	public:
 		/**
-		 *	Max data points to store
+		 *	Buckets per tier, a chart's data points count
 		 **/
-		static const int DATA_POINTS_COUNT = 20;
-		
+		static const int DATA_POINTS_COUNT = APP_HISTORY_BUCKETS;
+
+		/**
+		 *	Number of history tiers
+		 **/
+#define HISTORY_TIER_COUNT(span, bytes, resolution) + 1
+		static const uint8_t TIER_COUNT = 0 APP_HISTORY_TIERS(HISTORY_TIER_COUNT);
+#undef HISTORY_TIER_COUNT
+
+		/**
+		 *	Number of stored metrics, a tier has a column of buckets per stored metric
+		 **/
+		static const uint8_t COLUMN_COUNT = METRIC_DEW_POINT;
+
+		/**
+		 *	Compressed buckets of a stored metric in every tier, bytes
+		 **/
+#define HISTORY_TIER_BYTES(span, bytes, resolution) + bytes
+		static const uint16_t COLUMN_BYTES = 0 APP_HISTORY_TIERS(HISTORY_TIER_BYTES);
+#undef HISTORY_TIER_BYTES
+
+		/**
+		 *	Aggregated measurement results of a time span
+		 **/
+		typedef history_bucket_t bucket_t;
+
+		/**
+		 *	Sliding window statistics over a chart's data points
+		 **/
+		typedef window_stats_t<DATA_POINTS_COUNT> window_t;
+
 		/**
 		 *	Constructor
 		 **/
-		data_history_t() : _is_first(true) { }
+		data_history_t();
+
+		/**
+		 *	Restores coarse history tiers from the checkpoints made before the reboot
+		 **/
+		void init();
+
+		/**
+		 *	Adds a measurement result into the finest tier's open bucket.
+		 *	advance() must be called on the acquisition round first
+		 *	@param	id		sensor's ID
+		 *	@param	metric	a stored metric
+		 *	@param	value	measurement result, in hundredths of metric's unit
+		 **/
+		void push(const sensor_id id, const history_metric metric, const int16_t value);
 
 		/**
-		 *	Pushes a new value into the history
+		 *	Closes history intervals which have passed by, the ones without measurements become gaps.
+		 *	Must be called on every acquisition round
 		 *	@param	id		sensor's ID
 		 *	@param	time	current global time
-		 *	@param	t		measurement result
 		 **/
-		void push(const sensor_id id, const time_t& time, const temperature_t t);
+		void advance(const sensor_id id, const time_t& time);
+
+		/**
+		 *	Writes pending checkpoints into the persistent log, at most one EEPROM byte per call
+		 **/
+		void poll();
+
+		/**
+		 *	Aggregates measurement results of a time range into consecutive buckets of the same width.
+		 *	Reads the finest history tier which still covers the range start, in a single pass
+		 *	@param	id		sensor's ID
+		 *	@param	metric	a metric
+		 *	@param	from	range start, global time
+		 *	@param	to		range end, global time, excluded
+		 *	@param	width	bucket width, in seconds
+		 *	@param	visitor	receiver of aggregated buckets
+		 **/
+		void query(const sensor_id id, const history_metric metric, const time_t& from, const time_t& to, const unsigned long width, history_visitor_t& visitor) const;
 
 		/**
 		 *	Retrieves last measurement results in normalized form.
-		 *	Measurement results will be normalized to [0, 255] range
-		 *	@param	id	sensor's ID
-		 *	@param	arr	an array for measurement results. Must have at least DATA_POINTS_COUNT items
+		 *	Measurement results will be normalized to [0, height] range, gaps are 0.
+		 *	The last projection is cached until sensor's history revision changes
+		 *	@param	id		sensor's ID
+		 *	@param	tier	history tier, 0 is the finest one
+		 *	@param	metric	a metric
+		 *	@param	arr		an array for measurement results. Must have at least DATA_POINTS_COUNT items
+		 *	@param	height	chart's height, pixels
 		 */
-		void get_points(const sensor_id id, byte* arr) const;
+		void get_points(const sensor_id id, const uint8_t tier, const history_metric metric, byte* arr, const uint8_t height) const;
+
+		/**
+		 *	Gets statistics of a metric's last DATA_POINTS_COUNT buckets of a history tier.
+		 *	The window is filled in one decoding pass, then every statistic is O(1)
+		 *	@param	id		sensor's ID
+		 *	@param	tier	history tier, 0 is the finest one
+		 *	@param	metric	a metric
+		 *	@param	stats	window statistics, must be empty
+		 **/
+		void get_stats(const sensor_id id, const uint8_t tier, const history_metric metric, window_t& stats) const;
+
+		/**
+		 *	Gets closed buckets of a stored metric of a history tier
+		 *	@param		id		sensor's ID
+		 *	@param		tier	history tier, 0 is the finest one
+		 *	@param		metric	a stored metric
+		 *	@returns	compressed buckets storage, read it with history_stream_t::reader_t
+		 **/
+		const history_stream_t& get_buckets(const sensor_id id, const uint8_t tier, const history_metric metric) const { return _tiers[id][tier].columns[metric]; }
+
+		/**
+		 *	Gets global time a bucket of a history tier has started at.
+		 *	Buckets carry no timestamps, a bucket's time is derived from its slot, shared by all metrics
+		 *	@param		id		sensor's ID
+		 *	@param		tier	history tier, 0 is the finest one
+		 *	@param		age		bucket's age, 0 is the newest one
+		 *	@returns	bucket's start time
+		 **/
+		time_t get_time(const sensor_id id, const uint8_t tier, const uint16_t age) const;
+
+		/**
+		 *	Gets a time span aggregated into a bucket of a history tier
+		 *	@param		tier	history tier, 0 is the finest one
+		 *	@returns	time span, in seconds
+		 **/
+		static unsigned long get_interval(const uint8_t tier);
+
+		/**
+		 *	Gets a metric's short label
+		 *	@param		metric	a metric
+		 *	@returns	metric's label
+		 **/
+		static const char* get_label(const history_metric metric);
+
+		/**
+		 *	Gets a time span covered by a history tier
+		 *	@param		tier	history tier, 0 is the finest one
+		 *	@returns	time span, in seconds
+		 **/
+		static unsigned long get_span(const uint8_t tier);
 
 		/**
 		 *	Gets last history revision number
@@ -43,33 +243,124 @@ namespace thermograph
 		 */
 		int get_revision() const { return _rev; }
 
+		/**
+		 *	Gets sensor's history revision number
+		 *	@param		id	sensor's ID
+		 *	@returns	last revision number of sensor's history
+		 */
+		int get_revision(const sensor_id id) const { return _revs[id]; }
+
+		/**
+		 *	Writes chart projection cache statistics and the last hour's aggregates into the log
+		 **/
+		void log_stats() const;
+
 	private:
-		
 		/**
-		 * A measurement data point
+		 *	Running aggregate of a bucket being filled
 		 **/
-		struct data_point_t
+		struct accumulator_t
 		{
 			/**
-			 *	Measured value
-			 */
-			temperature_t value;
+			 *	Sum of measured values
+			 **/
+			long sum;
 
 			/**
-			 *	Global tme of measurement
-			 */
-			time_t time;
+			 *	Measured values count
+			 **/
+			uint16_t count;
+
+			/**
+			 *	Min measured value
+			 **/
+			temperature_t min;
+
+			/**
+			 *	Max measured value
+			 **/
+			temperature_t max;
+
+			/**
+			 *	Clears the aggregate
+			 **/
+			void reset() { sum = 0; count = 0; }
+
+			/**
+			 *	Adds a measured value
+			 *	@param	t	measurement result
+			 **/
+			void add(const temperature_t t);
+
+			/**
+			 *	Merges another aggregate in
+			 *	@param	other	an aggregate to merge
+			 **/
+			void add(const accumulator_t& other);
+
+			/**
+			 *	Gets aggregated values as a bucket. The aggregate must not be empty
+			 *	@returns	a bucket
+			 **/
+			bucket_t to_bucket() const;
+		};
+
+		/**
+		 *	A history tier of a sensor
+		 **/
+		struct tier_t
+		{
+			/**
+			 *	Closed buckets, by stored metric
+			 **/
+			history_stream_t columns[COLUMN_COUNT];
+
+			/**
+			 *	The buckets being filled, by stored metric
+			 **/
+			accumulator_t open[COLUMN_COUNT];
+
+			/**
+			 *	Slot of the open buckets, the newest closed bucket of every column is a slot before
+			 **/
+			unsigned long slot;
+
+			/**
+			 *	Finer tier's buckets rolled up into the open buckets
+			 **/
+			uint16_t rollups;
 		};
 
 		/**
-		 *	Measurement results for SENSOR_ID_INDOOR sensor
+		 *	History tiers, by sensor ID
+		 **/
+		tier_t _tiers[SENSOR_COUNT][TIER_COUNT];
+
+		/**
+		 *	Byte rings of tiers' columns, by sensor ID
+		 **/
+		uint8_t _bytes[SENSOR_COUNT][COLUMN_COUNT * COLUMN_BYTES];
+
+		/**
+		 *	Global time the history has started at, slot 0 of every tier, by sensor ID
+		 **/
+		time_t _origin[SENSOR_COUNT];
+
+		/**
+		 *	Indicates whether the history has started, by sensor ID
 		 **/
-		mutable data_point_t _indoor_points[DATA_POINTS_COUNT];
+		bool _started[SENSOR_COUNT];
 
 		/**
-		 *	Measurement results for SENSOR_ID_OUTDOOR sensor
+		 *	Persistent log of coarse tiers' closed buckets
 		 **/
-		mutable data_point_t _outdoor_points[DATA_POINTS_COUNT];
+		eeprom_log_t _checkpoints;
+
+		/**
+		 *	Closed buckets waiting for their checkpoints, a bit per tier's column, by sensor ID
+		 **/
+		uint8_t _pending[SENSOR_COUNT];
+		static_assert(TIER_COUNT * COLUMN_COUNT <= 8, "pending checkpoints don't fit a byte");
 
 		/**
 		 *	Current revision number
@@ -77,18 +368,108 @@ namespace thermograph
 		int _rev;
 
 		/**
-		 * Indicates whether history is empty
+		 *	Current revision numbers, by sensor ID
+		 */
+		int _revs[SENSOR_COUNT];
+
+		/**
+		 *	A chart projection of measurement results
+		 **/
+		struct projection_t
+		{
+			/**
+			 *	Normalized measurement results
+			 **/
+			byte points[DATA_POINTS_COUNT];
+
+			/**
+			 *	Sensor's history revision the projection has been made at
+			 **/
+			int rev;
+
+			/**
+			 *	Sensor's ID
+			 **/
+			sensor_id sensor;
+
+			/**
+			 *	History tier
+			 **/
+			uint8_t tier;
+
+			/**
+			 *	Metric
+			 **/
+			uint8_t metric;
+
+			/**
+			 *	Chart's height, pixels. 0 if there's no projection yet
+			 **/
+			uint8_t height;
+		};
+
+		/**
+		 *	The last chart projection, only one chart is shown at a time
 		 **/
-		bool _is_first;
+		mutable projection_t _projection;
 
 		/**
-		 *	Gets an array containing measurement results for specified sensor
+		 *	Chart projections served from the cache
+		 **/
+		mutable unsigned long _cache_hits;
+
+		/**
+		 *	Chart projections recalculated
+		 **/
+		mutable unsigned long _cache_misses;
+
+		/**
+		 *	Normalizes last measurement results
+		 *	@param	id		sensor's ID
+		 *	@param	tier	history tier, 0 is the finest one
+		 *	@param	metric	a metric
+		 *	@param	arr		an array for measurement results. Must have at least DATA_POINTS_COUNT items
+		 *	@param	height	chart's height, pixels
+		 */
+		void project(const sensor_id id, const uint8_t tier, const history_metric metric, byte* arr, const uint8_t height) const;
+
+		/**
+		 *	Gets the global time the finest tier's open bucket has started at
 		 *	@param		id	sensor's ID
-		 *	@returns	an array of measurement data points
+		 *	@returns	global time
+		 **/
+		time_t get_opened(const sensor_id id) const;
+
+		/**
+		 *	Writes a column's newest bucket into the persistent history log
+		 *	@param	id		sensor's ID
+		 *	@param	tier	history tier, must not be the finest one
+		 *	@param	column	a stored metric
+		 **/
+		void checkpoint(const sensor_id id, const uint8_t tier, const uint8_t column);
+
+		/**
+		 *	Moves a tier to a slot while restoring it. Restored buckets of the open slot are closed,
+		 *	skipped slots become gaps, a gap longer than a chart drops the older buckets
+		 *	@param		id		sensor's ID
+		 *	@param		tier	history tier
+		 *	@param		slot	slot to open
+		 *	@returns	false if the tier is already past the slot, true otherwise
 		 **/
-		data_point_t* get_array(const sensor_id id) const;
+		bool restore(const sensor_id id, const uint8_t tier, const unsigned long slot);
+
+		/**
+		 *	Closes a tier's open bucket and rolls it up into the coarser tier
+		 *	@param	id		sensor's ID
+		 *	@param	tier	history tier
+		 **/
+		void close(const sensor_id id, const uint8_t tier);
 	};
 
+#ifdef __AVR__
+	static_assert(sizeof(data_history_t) <= APP_HISTORY_SRAM, "measurement history exceeds its SRAM budget, see APP_HISTORY_SRAM");
+#endif
+
 	/**
 	 *	Measurements' history storage static instance
 	 **/
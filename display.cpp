@@ -37,13 +37,13 @@ display_t::display_t()
  **/
 void display_t::init()
 {
-	log.debug(F("display\tinit"));
+	LOG_DBG(DISPLAY, F("display\tinit"));
 
 	_lcd.begin(LCD_WIDTH, LCD_HEIGHT);
 	_bitmap.begin();
 	_bitmap.move(12, 0);
 
-	log.debug(F("display\tdone"));
+	LOG_DBG(DISPLAY, F("display\tdone"));
 }
 
 /**
@@ -155,6 +155,11 @@ void display_t::print_g(int index, custom_char c)
 	case thermograph::CHAR_QUESTION:
 		print_question(offset);
 		break;
+	case thermograph::CHAR_MINUS:
+		print_minus(offset);
+		break;
+	case thermograph::CHAR_NONE:
+		break;
 	}
 }
 
@@ -647,4 +652,32 @@ void display_t::print_question(int offset)
 	_bitmap.line(offset + 4,  2, offset + 4,  4, ON);
 	_bitmap.line(offset + 3,  5, offset + 3, 13, ON);
 	_bitmap.line(offset + 3, 15, offset + 3, 15, ON);
+}
+
+/**
+ *	Draws a '-' character onto LCD bitmap
+ *	@param	offset	an offset to draw a character, in pixels
+ **/
+void display_t::print_minus(int offset)
+{
+	/********************/
+	/*** +----------+ ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** +----------+ ***/
+	/********************/
+	/*** +XXXXXXXXXX+ ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** |----------| ***/
+	/*** +----------+ ***/
+	/********************/
+	_bitmap.line(offset + 0,  8, offset + 4,  8, ON);
 }
\ No newline at end of file
@@ -24,7 +24,8 @@ namespace thermograph
 		CHAR_DEG,
 		CHAR_C,
 		CHAR_PERCENT,
-		CHAR_QUESTION
+		CHAR_QUESTION,
+		CHAR_MINUS
 	};
 
 	/**
@@ -183,6 +184,12 @@ namespace thermograph
 		 *	@param	offset	an offset to draw a character, in pixels
 		 **/
 		void print_question(int offset);
+
+		/**
+		 *	Draws a '-' character onto LCD bitmap
+		 *	@param	offset	an offset to draw a character, in pixels
+		 **/
+		void print_minus(int offset);
 	};
 
 	/**
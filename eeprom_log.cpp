@@ -0,0 +1,200 @@
+#include "Arduino.h"
+#include <avr/eeprom.h>
+#include "eeprom_log.h"
+
+using namespace thermograph;
+
+/**
+ *	Updates a CRC-16 (CCITT, reflected 0x1021 polynomial) with a byte
+ *	@param		crc		CRC so far
+ *	@param		value	a byte
+ *	@returns	updated CRC
+ **/
+static uint16_t crc16(uint16_t crc, uint8_t value)
+{
+	crc ^= value;
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		crc = crc & 0x0001 ? (crc >> 1) ^ 0x8408 : crc >> 1;
+	}
+	return crc;
+}
+
+/**
+ *	Starts writing an EEPROM byte unless it already holds the value, a write takes 3.4 ms and wears the cell
+ *	@param		address	EEPROM address
+ *	@param		value	a byte
+ *	@returns	true if a write has been started, false otherwise
+ **/
+static bool update_byte(uint16_t address, uint8_t value)
+{
+	uint8_t* cell = reinterpret_cast<uint8_t*>(address);
+	if (eeprom_read_byte(cell) == value)
+	{
+		return false;
+	}
+
+	eeprom_write_byte(cell, value);
+	return true;
+}
+
+/*
+ ************************************************************************
+ *	eeprom_log_t::reader_t
+ *	Streaming reader class
+ ************************************************************************
+ */
+
+/**
+ *	Constructor
+ *	@param	log		log to read
+ **/
+eeprom_log_t::reader_t::reader_t(const eeprom_log_t& log)
+	: _log(log), _slot(log._head), _remaining(log._capacity)
+{
+}
+
+/**
+ *	Reads the next valid record
+ *	@param		payload	record's payload, must have at least PAYLOAD bytes
+ *	@returns	true if a record has been read, false if there are no records left
+ **/
+bool eeprom_log_t::reader_t::next(uint8_t* payload)
+{
+	while (_remaining > 0)
+	{
+		uint16_t slot = _slot;
+		_slot = _slot + 1 == _log._capacity ? 0 : _slot + 1;
+		_remaining--;
+
+		// Records outside of the last capacity sequence numbers are left from an older log
+		uint16_t seq;
+		if (_log.read(slot, seq, payload) && static_cast<uint16_t>(_log._seq - 1 - seq) < _log._capacity)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ ************************************************************************
+ *	eeprom_log_t
+ *	Append-only record log in EEPROM
+ ************************************************************************
+ */
+
+/**
+ *	Constructor
+ *	@param	address	log area's EEPROM address
+ *	@param	length	log area's length, bytes
+ **/
+eeprom_log_t::eeprom_log_t(uint16_t address, uint16_t length)
+	: _address(address), _capacity(length / RECORD_SIZE), _head(0), _seq(0), _written(RECORD_SIZE)
+{
+}
+
+/**
+ *	Finds the newest record, must be called before the log is used
+ **/
+void eeprom_log_t::init()
+{
+	// The newest record is the one the next slot doesn't continue,
+	// the one with the greatest sequence number if there are several of them
+	bool found = false;
+	uint16_t seq = 0;
+	bool valid = read(0, seq, NULL);
+	for (uint16_t slot = 0; slot < _capacity; slot++)
+	{
+		uint16_t next = slot + 1 == _capacity ? 0 : slot + 1;
+		uint16_t next_seq = 0;
+		bool next_valid = read(next, next_seq, NULL);
+
+		if (valid && !(next_valid && next_seq == static_cast<uint16_t>(seq + 1)) &&
+			(!found || static_cast<int16_t>(seq - _seq) >= 0))
+		{
+			found = true;
+			_head = next;
+			_seq = seq + 1;
+		}
+
+		seq = next_seq;
+		valid = next_valid;
+	}
+}
+
+/**
+ *	Appends a record, overwriting the oldest one if the log is full.
+ *	Must not be called while the previous record is being written
+ *	@param	payload	record's payload, PAYLOAD bytes
+ **/
+void eeprom_log_t::append(const uint8_t* payload)
+{
+	_record[0] = _seq & 0xFF;
+	_record[1] = _seq >> 8;
+	memcpy(_record + 2, payload, PAYLOAD);
+
+	uint16_t crc = VERSION;
+	for (uint8_t i = 0; i < PAYLOAD + 2; i++)
+	{
+		crc = crc16(crc, _record[i]);
+	}
+	_record[PAYLOAD + 2] = crc & 0xFF;
+	_record[PAYLOAD + 3] = crc >> 8;
+	_written = 0;
+
+	// The slot is taken right away, a record torn by a power loss fails its CRC
+	_head = _head + 1 == _capacity ? 0 : _head + 1;
+	_seq++;
+}
+
+/**
+ *	Writes the next byte of the appended record, if the EEPROM is ready for it
+ **/
+void eeprom_log_t::poll()
+{
+	uint16_t slot = _head == 0 ? _capacity - 1 : _head - 1;
+	uint16_t address = _address + slot * RECORD_SIZE;
+
+	// Cells which already hold their bytes are skipped, at most one write is started
+	while (busy() && eeprom_is_ready())
+	{
+		uint8_t i = _written++;
+		if (update_byte(address + i, _record[i]))
+		{
+			return;
+		}
+	}
+}
+
+/**
+ *	Reads a record
+ *	@param		slot	record's slot
+ *	@param		seq		record's sequence number
+ *	@param		payload	record's payload, may be NULL
+ *	@returns	true if the record is valid, false otherwise
+ **/
+bool eeprom_log_t::read(uint16_t slot, uint16_t& seq, uint8_t* payload) const
+{
+	const uint8_t* address = reinterpret_cast<const uint8_t*>(_address + slot * RECORD_SIZE);
+
+	uint8_t low = eeprom_read_byte(address++);
+	uint8_t high = eeprom_read_byte(address++);
+	uint16_t crc = crc16(crc16(VERSION, low), high);
+	seq = low | high << 8;
+
+	for (uint8_t i = 0; i < PAYLOAD; i++)
+	{
+		uint8_t value = eeprom_read_byte(address++);
+		crc = crc16(crc, value);
+		if (payload != NULL)
+		{
+			payload[i] = value;
+		}
+	}
+
+	low = eeprom_read_byte(address++);
+	high = eeprom_read_byte(address);
+	return (low | high << 8) == crc;
+}
\ No newline at end of file
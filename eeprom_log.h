@@ -0,0 +1,146 @@
+#pragma once
+
+#include <inttypes.h>
+
+namespace thermograph
+{
+	/**
+	 *	Append-only record log in EEPROM.
+	 *	Fixed size records are written round-robin over the log's area, so every cell wears evenly.
+	 *	A record is a 16-bit sequence number, PAYLOAD bytes and a CRC-16 of both seeded with the log's VERSION:
+	 *	the newest record is the one the next slot doesn't continue the sequence of,
+	 *	a record torn by a power loss, written by other firmware or by another log version fails its CRC and is skipped.
+	 *	An appended record is written by poll() one byte per call, an EEPROM write completes in the background
+	 **/
+	class eeprom_log_t
+	{
+	public:
+		/**
+		 *	Record's payload length, bytes
+		 **/
+		static const uint8_t PAYLOAD = 8;
+
+		/**
+		 *	Record's length, bytes
+		 **/
+		static const uint8_t RECORD_SIZE = PAYLOAD + 4;
+
+		/**
+		 *	Records' format version, a CRC seed. Changed whenever older records can't be read back,
+		 *	history tiers' layout included
+		 **/
+		static const uint16_t VERSION = 0x7E03;
+
+		/**
+		 *	Streaming reader class, reads valid records from the oldest to the newest one
+		 **/
+		class reader_t
+		{
+		public:
+			/**
+			 *	Constructor
+			 *	@param	log		log to read
+			 **/
+			reader_t(const eeprom_log_t& log);
+
+			/**
+			 *	Reads the next valid record
+			 *	@param		payload	record's payload, must have at least PAYLOAD bytes
+			 *	@returns	true if a record has been read, false if there are no records left
+			 **/
+			bool next(uint8_t* payload);
+
+		private:
+			/**
+			 *	Log being read
+			 **/
+			const eeprom_log_t& _log;
+
+			/**
+			 *	Slot to read next
+			 **/
+			uint16_t _slot;
+
+			/**
+			 *	Slots left to read
+			 **/
+			uint16_t _remaining;
+		};
+
+		/**
+		 *	Constructor
+		 *	@param	address	log area's EEPROM address
+		 *	@param	length	log area's length, bytes
+		 **/
+		eeprom_log_t(uint16_t address, uint16_t length);
+
+		/**
+		 *	Finds the newest record, must be called before the log is used
+		 **/
+		void init();
+
+		/**
+		 *	Gets records count the log area fits
+		 *	@returns	slots count
+		 **/
+		uint16_t get_capacity() const { return _capacity; }
+
+		/**
+		 *	Appends a record, overwriting the oldest one if the log is full.
+		 *	Must not be called while the previous record is being written
+		 *	@param	payload	record's payload, PAYLOAD bytes
+		 **/
+		void append(const uint8_t* payload);
+
+		/**
+		 *	Writes the next byte of the appended record, if the EEPROM is ready for it
+		 **/
+		void poll();
+
+		/**
+		 *	Gets a value indicating whether the appended record is being written
+		 *	@returns	true if the record hasn't been written completely, false otherwise
+		 **/
+		bool busy() const { return _written < RECORD_SIZE; }
+
+	private:
+		/**
+		 *	Log area's EEPROM address
+		 **/
+		uint16_t _address;
+
+		/**
+		 *	Slots count
+		 **/
+		uint16_t _capacity;
+
+		/**
+		 *	Slot the next record is written to
+		 **/
+		uint16_t _head;
+
+		/**
+		 *	Sequence number of the next record
+		 **/
+		uint16_t _seq;
+
+		/**
+		 *	Record being written, in the slot before the head
+		 **/
+		uint8_t _record[RECORD_SIZE];
+
+		/**
+		 *	Bytes of the record written so far
+		 **/
+		uint8_t _written;
+
+		/**
+		 *	Reads a record
+		 *	@param		slot	record's slot
+		 *	@param		seq		record's sequence number
+		 *	@param		payload	record's payload, may be NULL
+		 *	@returns	true if the record is valid, false otherwise
+		 **/
+		bool read(uint16_t slot, uint16_t& seq, uint8_t* payload) const;
+	};
+}
\ No newline at end of file
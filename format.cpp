@@ -0,0 +1,139 @@
+#include "Arduino.h"
+#include "format.h"
+#include "number_format.h"
+
+using namespace thermograph;
+
+/**
+*	Takes the next argument of a conversion
+*	@param		args		argument list, advanced past the argument
+*	@param		conversion	conversion character following '%'
+*	@returns	the argument, NULL if the list has ended or the argument doesn't fit the conversion
+**/
+const format_arg_t* thermograph::format_next_arg(const format_arg_t*& args, char conversion)
+{
+	if(args->type == FORMAT_ARG_NONE)
+	{
+		return NULL;
+	}
+
+	const format_arg_t* arg = args++;
+	return format_accepts(arg->type, conversion) ? arg : NULL;
+}
+
+/**
+*	Prints a formatted message.
+*	A conversion without a fitting argument prints '?', format strings checked by FORMAT_CHECK never have one
+*	@param	out		printer
+*	@param	format	format string, see the format table in "log.h"
+*	@param	flash	indicates whether the format string is in flash memory
+*	@param	args	format arguments, ending with FORMAT_ARG_NONE
+**/
+void thermograph::format_message(Print& out, const char* format, bool flash, const format_arg_t* args)
+{
+	for(char c; (c = format_char(format, flash)) != '\0'; format++)
+	{
+		if(c != '%')
+		{
+			out.print(c);
+			continue;
+		}
+
+		c = format_char(++format, flash);
+		if(c == '\0')
+		{
+			break;
+		}
+		if(c == '%')
+		{
+			out.print(c);
+			continue;
+		}
+
+		const format_arg_t* arg = format_next_arg(args, c);
+		if(arg == NULL)
+		{
+			out.print('?');
+			continue;
+		}
+
+		switch(c)
+		{
+		case 'd':
+		case 'i':
+		case 'l':
+		case 'c':
+			number_format_t(arg->integer).print(out);
+			break;
+		case 'X':
+			out.print(F("0x"));
+			// no break
+		case 'x':
+			out.print(static_cast<int>(arg->integer), HEX);
+			break;
+		case 'B':
+			out.print(F("0b"));
+			// no break
+		case 'b':
+			out.print(static_cast<int>(arg->integer), BIN);
+			break;
+		case 't':
+			out.print(arg->integer == 1 ? 'T' : 'F');
+			break;
+		case 'T':
+			out.print(arg->integer == 1 ? F("true") : F("false"));
+			break;
+		case 'h':
+			number_format_t(arg->integer, 2).print(out);
+			break;
+		case 'f':
+		case 'F':
+			out.print(arg->real);
+			break;
+		case 's':
+			out.print(arg->string);
+			break;
+		case 'u':
+			format_time(out, *arg->time);
+			break;
+		case 'U':
+			format_time(out, *arg->sys_time);
+			break;
+		case 'm':
+			out.print(arg->message);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/**
+*	Prints a global time as hh:mm:ss
+*	@param	out		printer
+*	@param	time	global time
+**/
+void thermograph::format_time(Print& out, const time_t& time)
+{
+	number_format_t(time.h, 0, 2, '0').print(out);
+	out.print(':');
+	number_format_t(time.min, 0, 2, '0').print(out);
+	out.print(':');
+	number_format_t(time.sec, 0, 2, '0').print(out);
+}
+
+/**
+*	Prints a local time as hhhh:mm:ss.mmm
+*	@param	out		printer
+*	@param	time	local time
+**/
+void thermograph::format_time(Print& out, const sys_time_t& time)
+{
+	number_format_t(time.h, 0, 4, ' ').print(out);
+	out.print(':');
+	number_format_t(time.min, 0, 2, '0').print(out);
+	out.print(':');
+	number_format_t(time.sec, 0, 2, '0').print(out);
+	out.print('.');
+	number_format_t(time.ms, 0, 3, '0').print(out);
+}
\ No newline at end of file
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "_config.h"
+#include "Arduino.h"
+#include <avr/pgmspace.h>
+#include "time.h"
+
+namespace thermograph
+{
+	/**
+	 *	Format argument types enumeration
+	 **/
+	enum format_arg_type
+	{
+		/**
+		 *	No argument, ends an argument list
+		 **/
+		FORMAT_ARG_NONE,
+
+		/**
+		 *	Integer no wider than int
+		 **/
+		FORMAT_ARG_INTEGER,
+
+		/**
+		 *	Integer wider than int
+		 **/
+		FORMAT_ARG_LONG,
+
+		/**
+		 *	Floating point value
+		 **/
+		FORMAT_ARG_FLOAT,
+
+		/**
+		 *	String in RAM
+		 **/
+		FORMAT_ARG_STRING,
+
+		/**
+		 *	Global time
+		 **/
+		FORMAT_ARG_TIME,
+
+		/**
+		 *	Local time
+		 **/
+		FORMAT_ARG_SYS_TIME,
+
+		/**
+		 *	Log message's format string: F() string in text log, its ID in binary log
+		 **/
+		FORMAT_ARG_MESSAGE
+	};
+
+	/**
+	 *	Checks whether a format string conversion accepts an argument type, see the format table in "log.h"
+	 *	@param		type		argument type
+	 *	@param		conversion	conversion character following '%'
+	 *	@returns	true if the conversion formats the argument, false otherwise
+	 **/
+	constexpr bool format_accepts(format_arg_type type, char conversion)
+	{
+		return conversion == 'l' || conversion == 'h' ? type == FORMAT_ARG_INTEGER || type == FORMAT_ARG_LONG
+			: conversion == 'd' || conversion == 'i' || conversion == 'x' || conversion == 'X' || conversion == 'b'
+				|| conversion == 'B' || conversion == 'c' || conversion == 't' || conversion == 'T' ? type == FORMAT_ARG_INTEGER
+			: conversion == 'f' || conversion == 'F' ? type == FORMAT_ARG_FLOAT
+			: conversion == 's' ? type == FORMAT_ARG_STRING
+			: conversion == 'u' ? type == FORMAT_ARG_TIME
+			: conversion == 'U' ? type == FORMAT_ARG_SYS_TIME
+			: conversion == 'm' ? type == FORMAT_ARG_MESSAGE
+			: false;
+	}
+
+	/**
+	 *	Format string ID, identifies a format string in binary log, see "log_formats.h"
+	 **/
+	struct format_id_t
+	{
+		/**
+		 *	ID value, no format string has ID 0
+		 **/
+		uint16_t value;
+	};
+
+	/**
+	 *	Compares format string IDs
+	 *	@param		a	an ID
+	 *	@param		b	another ID
+	 *	@returns	true if the IDs are equal, false otherwise
+	 **/
+	constexpr bool operator==(format_id_t a, format_id_t b) { return a.value == b.value; }
+
+	/**
+	 *	Compares format string IDs
+	 *	@param		a	an ID
+	 *	@param		b	another ID
+	 *	@returns	true if the IDs differ, false otherwise
+	 **/
+	constexpr bool operator!=(format_id_t a, format_id_t b) { return a.value != b.value; }
+
+	/**
+	 *	Scrambles a format string's ID hash
+	 *	@param		id	ID hash
+	 *	@returns	scrambled ID hash
+	 **/
+	constexpr uint16_t format_id_mix(uint16_t id)
+	{
+		return id ^ id >> 7;
+	}
+
+	/**
+	 *	Advances a format string's ID hash by a character, host/gen_log_formats.cpp computes the same for "log_formats.h"
+	 *	@param		id	ID hash so far
+	 *	@param		c	format string's character
+	 *	@returns	updated ID hash
+	 **/
+	constexpr uint16_t format_id_next(uint16_t id, char c)
+	{
+		return format_id_mix(static_cast<uint16_t>(static_cast<uint16_t>(id ^ static_cast<uint8_t>(c)) * 0x6F4BU));
+	}
+
+	/**
+	 *	Computes a format string literal's ID at compile time
+	 *	@param		format	format string literal
+	 *	@param		id		ID hash so far, LOG_FORMAT_SEED at the string's start
+	 *	@returns	format string's ID
+	 **/
+	constexpr uint16_t format_id(const char* format, uint16_t id)
+	{
+		return *format == '\0' ? id : format_id(format + 1, format_id_next(id, *format));
+	}
+
+	/**
+	 *	Gets a format string ID known at compile time
+	 *	@returns	the ID
+	 **/
+	template<uint16_t ID>
+	constexpr format_id_t format_id_constant()
+	{
+		return { ID };
+	}
+
+	template<typename T>
+	struct format_arg_traits;
+
+	/**
+	 *	Format argument: a value tagged with its type.
+	 *	Arguments are passed by value except for strings and times, which must outlive the argument
+	 **/
+	struct format_arg_t
+	{
+		/**
+		 *	Argument type
+		 **/
+		format_arg_type type;
+
+		/**
+		 *	Argument value
+		 **/
+		union
+		{
+			long integer;
+			float real;
+			const char* string;
+			const time_t* time;
+			const sys_time_t* sys_time;
+			const __FlashStringHelper* message;
+			format_id_t id;
+		};
+
+		/**
+		 *	Constructor of an argument list's end
+		 **/
+		format_arg_t() : type(FORMAT_ARG_NONE) { }
+
+		/**
+		 *	Constructor
+		 *	@param	value	argument value, its type must have format_arg_traits
+		 **/
+		template<typename T>
+		format_arg_t(const T& value) : type(format_arg_traits<T>::TYPE)
+		{
+			format_arg_traits<T>::store(*this, value);
+		}
+	};
+
+	/**
+	 *	Format argument traits of enumerations, an unsupported argument type fails here
+	 **/
+	template<typename T>
+	struct format_arg_traits
+	{
+		static_assert(__is_enum(T), "unsupported format argument type");
+		static const format_arg_type TYPE = FORMAT_ARG_INTEGER;
+		static void store(format_arg_t& arg, const T& value) { arg.integer = value; }
+	};
+
+	/**
+	 *	Format argument traits of integers
+	 **/
+	template<typename T>
+	struct format_integer_traits
+	{
+		static const format_arg_type TYPE = sizeof(T) > sizeof(int) ? FORMAT_ARG_LONG : FORMAT_ARG_INTEGER;
+		static void store(format_arg_t& arg, const T& value) { arg.integer = static_cast<long>(value); }
+	};
+
+	template<> struct format_arg_traits<bool> : format_integer_traits<bool> { };
+	template<> struct format_arg_traits<char> : format_integer_traits<char> { };
+	template<> struct format_arg_traits<signed char> : format_integer_traits<signed char> { };
+	template<> struct format_arg_traits<unsigned char> : format_integer_traits<unsigned char> { };
+	template<> struct format_arg_traits<short> : format_integer_traits<short> { };
+	template<> struct format_arg_traits<unsigned short> : format_integer_traits<unsigned short> { };
+	template<> struct format_arg_traits<int> : format_integer_traits<int> { };
+	template<> struct format_arg_traits<unsigned int> : format_integer_traits<unsigned int> { };
+	template<> struct format_arg_traits<long> : format_integer_traits<long> { };
+	template<> struct format_arg_traits<unsigned long> : format_integer_traits<unsigned long> { };
+
+	/**
+	 *	Format argument traits of floating point values, double is float on AVR
+	 **/
+	template<typename T>
+	struct format_float_traits
+	{
+		static const format_arg_type TYPE = FORMAT_ARG_FLOAT;
+		static void store(format_arg_t& arg, const T& value) { arg.real = value; }
+	};
+
+	template<> struct format_arg_traits<float> : format_float_traits<float> { };
+	template<> struct format_arg_traits<double> : format_float_traits<double> { };
+
+	/**
+	 *	Format argument traits of strings
+	 **/
+	struct format_string_traits
+	{
+		static const format_arg_type TYPE = FORMAT_ARG_STRING;
+		static void store(format_arg_t& arg, const char* value) { arg.string = value; }
+	};
+
+	template<> struct format_arg_traits<char*> : format_string_traits { };
+	template<> struct format_arg_traits<const char*> : format_string_traits { };
+	template<size_t N> struct format_arg_traits<char[N]> : format_string_traits { };
+
+	/**
+	 *	Format argument traits of global time
+	 **/
+	template<>
+	struct format_arg_traits<time_t>
+	{
+		static const format_arg_type TYPE = FORMAT_ARG_TIME;
+		static void store(format_arg_t& arg, const time_t& value) { arg.time = &value; }
+	};
+
+	/**
+	 *	Format argument traits of local time
+	 **/
+	template<>
+	struct format_arg_traits<sys_time_t>
+	{
+		static const format_arg_type TYPE = FORMAT_ARG_SYS_TIME;
+		static void store(format_arg_t& arg, const sys_time_t& value) { arg.sys_time = &value; }
+	};
+
+#ifdef APP_LOG_BINARY
+	/**
+	 *	Format argument traits of log messages' format string IDs, binary log sends them instead of the strings
+	 **/
+	template<>
+	struct format_arg_traits<format_id_t>
+	{
+		static const format_arg_type TYPE = FORMAT_ARG_MESSAGE;
+		static void store(format_arg_t& arg, const format_id_t& value) { arg.id = value; }
+	};
+#else
+	/**
+	 *	Format argument traits of log messages' format strings
+	 **/
+	template<>
+	struct format_arg_traits<const __FlashStringHelper*>
+	{
+		static const format_arg_type TYPE = FORMAT_ARG_MESSAGE;
+		static void store(format_arg_t& arg, const __FlashStringHelper* value) { arg.message = value; }
+	};
+#endif
+
+	/**
+	 *	Argument types of a formatted message, checks a format string against them at compile time
+	 **/
+	template<typename... A>
+	struct format_signature_t;
+
+	template<>
+	struct format_signature_t<>
+	{
+		/**
+		 *	Checks whether a format string has no conversions left
+		 *	@param		format	format string
+		 *	@returns	true if it matches, false otherwise
+		 **/
+		static constexpr bool matches(const char* format)
+		{
+			return *format == '\0' ? true
+				: *format != '%' ? matches(format + 1)
+				: format[1] == '%' ? matches(format + 2)
+				: format[1] == '\0';
+		}
+	};
+
+	template<typename A, typename... R>
+	struct format_signature_t<A, R...>
+	{
+		/**
+		 *	Checks whether a format string's conversions accept the argument types
+		 *	@param		format	format string
+		 *	@returns	true if it matches, false otherwise
+		 **/
+		static constexpr bool matches(const char* format)
+		{
+			return *format == '\0' ? false
+				: *format != '%' ? matches(format + 1)
+				: format[1] == '%' ? matches(format + 2)
+				: format_accepts(format_arg_traits<A>::TYPE, format[1]) && format_signature_t<R...>::matches(format + 2);
+		}
+	};
+
+	/**
+	 *	Gets a formatted message's signature, for decltype() only
+	 *	@param		args	format arguments
+	 *	@returns	signature type
+	 **/
+	template<typename... A>
+	format_signature_t<A...> format_signature(A... args);
+
+	/**
+	 *	Reads a format string's character
+	 *	@param		format	character's address
+	 *	@param		flash	indicates whether the format string is in flash memory
+	 *	@returns	the character
+	 **/
+	inline char format_char(const char* format, bool flash)
+	{
+		return flash ? pgm_read_byte(format) : *format;
+	}
+
+	/**
+	 *	Takes the next argument of a conversion
+	 *	@param		args		argument list, advanced past the argument
+	 *	@param		conversion	conversion character following '%'
+	 *	@returns	the argument, NULL if the list has ended or the argument doesn't fit the conversion
+	 **/
+	const format_arg_t* format_next_arg(const format_arg_t*& args, char conversion);
+
+	/**
+	 *	Prints a formatted message
+	 *	@param	out		printer
+	 *	@param	format	format string, see the format table in "log.h"
+	 *	@param	flash	indicates whether the format string is in flash memory
+	 *	@param	args	format arguments, ending with FORMAT_ARG_NONE
+	 **/
+	void format_message(Print& out, const char* format, bool flash, const format_arg_t* args);
+
+	/**
+	 *	Prints a global time as hh:mm:ss
+	 *	@param	out		printer
+	 *	@param	time	global time
+	 **/
+	void format_time(Print& out, const time_t& time);
+
+	/**
+	 *	Prints a local time as hhhh:mm:ss.mmm
+	 *	@param	out		printer
+	 *	@param	time	local time
+	 **/
+	void format_time(Print& out, const sys_time_t& time);
+}
+
+/**
+ *	Checks a format string literal against its arguments at compile time
+ *	@param	literal	format string literal
+ *	@param	...		format arguments
+ **/
+#define FORMAT_CHECK(literal, ...) static_assert(decltype(thermograph::format_signature(__VA_ARGS__))::matches(literal), "format string doesn't match its arguments")
+
+/**
+ *	Unwraps an F() format string, FORMAT_LITERAL_##format turns F("...") into "..."
+ **/
+#define FORMAT_LITERAL_F(literal) literal
\ No newline at end of file
@@ -0,0 +1,360 @@
+#include "Arduino.h"
+#include "history_stream.h"
+
+using namespace thermograph;
+
+/**
+ *	A mean of a span without measurements
+ **/
+const temperature_t history_bucket_t::GAP;
+
+/**
+ *	Maps a signed value to an unsigned one, small magnitudes to small values
+ *	@param		value	a signed value
+ *	@returns	zigzag encoded value
+ **/
+static unsigned long zigzag(long value)
+{
+	return (static_cast<unsigned long>(value) << 1) ^ static_cast<unsigned long>(value >> 31);
+}
+
+/**
+ *	Restores a signed value from its zigzag encoding
+ *	@param		value	zigzag encoded value
+ *	@returns	a signed value
+ **/
+static long unzigzag(unsigned long value)
+{
+	return static_cast<long>(value >> 1) ^ -static_cast<long>(value & 1);
+}
+
+/**
+ *	Rounds a value to a resolution
+ *	@param		value		a value, in hundredths of a unit
+ *	@param		resolution	resolution, hundredths of a unit
+ *	@returns	the value, in resolution units
+ **/
+static long quantize(long value, uint8_t resolution)
+{
+	const long half = resolution / 2;
+	return (value >= 0 ? value + half : value - half) / resolution;
+}
+
+/**
+ *	Writes a varint: 7 bits per byte, least significant first, the high bit marks a continuation
+ *	@param		out		output buffer
+ *	@param		value	a value to write
+ *	@returns	bytes written
+ **/
+static uint8_t write_varint(uint8_t* out, unsigned long value)
+{
+	uint8_t length = 0;
+	while (value >= 0x80)
+	{
+		out[length++] = static_cast<uint8_t>(value) | 0x80;
+		value >>= 7;
+	}
+	out[length++] = static_cast<uint8_t>(value);
+	return length;
+}
+
+/*
+ ************************************************************************
+ *	history_stream_t::reader_t
+ *	Streaming decoder class
+ ************************************************************************
+ */
+
+/**
+ *	Constructor
+ *	@param	stream	storage to read
+ **/
+history_stream_t::reader_t::reader_t(const history_stream_t& stream)
+	: _stream(stream), _pos(stream._tail), _remaining(stream._size), _gap(0), _index(0), _keyframe(true), _mean(0)
+{
+}
+
+/**
+ *	Decodes the next bucket
+ *	@param		bucket	decoded bucket
+ *	@returns	true if a bucket has been decoded, false if there are no buckets left
+ **/
+bool history_stream_t::reader_t::next(history_bucket_t& bucket)
+{
+	if (_remaining == 0)
+	{
+		return false;
+	}
+
+	_remaining--;
+
+	if (_gap == 0)
+	{
+		if (_index == 0)
+		{
+			_keyframe = true;
+		}
+		_index = _index + 1 == KEYFRAME_INTERVAL ? 0 : _index + 1;
+
+		unsigned long head = _stream.read_varint(_pos);
+		uint8_t kind = head & 0x03;
+		if (kind == ENTRY_GAP)
+		{
+			_gap = head >> 2;
+		}
+		else
+		{
+			long value = unzigzag(head >> 2);
+			_mean = _keyframe ? value : _mean + value;
+			_keyframe = false;
+
+			const uint8_t resolution = _stream._resolution;
+			bucket.mean = _mean * resolution;
+			bucket.min = bucket.mean;
+			bucket.max = bucket.mean;
+			if (kind == ENTRY_NARROW)
+			{
+				uint8_t spreads = _stream._bytes[_pos];
+				_pos = _pos + 1 == _stream._capacity ? 0 : _pos + 1;
+				bucket.min = (_mean - (spreads & 0x0F)) * resolution;
+				bucket.max = (_mean + (spreads >> 4)) * resolution;
+			}
+			else if (kind == ENTRY_SPREAD)
+			{
+				bucket.min = (_mean - static_cast<long>(_stream.read_varint(_pos))) * resolution;
+				bucket.max = (_mean + static_cast<long>(_stream.read_varint(_pos))) * resolution;
+			}
+			return true;
+		}
+	}
+
+	_gap--;
+	bucket.mean = history_bucket_t::GAP;
+	bucket.min = history_bucket_t::GAP;
+	bucket.max = history_bucket_t::GAP;
+	return true;
+}
+
+/**
+ *	Skips buckets
+ *	@param	count	buckets to skip
+ **/
+void history_stream_t::reader_t::skip(uint16_t count)
+{
+	history_bucket_t bucket;
+	while (count-- > 0 && next(bucket))
+	{
+	}
+}
+
+/*
+ ************************************************************************
+ *	history_stream_t
+ *	Compressed history buckets storage class
+ ************************************************************************
+ */
+
+/**
+ *	Constructor, the storage must be attached to a byte ring before use
+ **/
+history_stream_t::history_stream_t() : _bytes(NULL), _capacity(0), _resolution(1)
+{
+	reset();
+}
+
+/**
+ *	Attaches the storage to a byte ring and removes all buckets
+ *	@param	bytes		byte ring
+ *	@param	capacity	ring's length, [MIN_CAPACITY, MAX_CAPACITY] bytes
+ *	@param	resolution	stored values' resolution, at least MIN_RESOLUTION hundredths of a unit
+ **/
+void history_stream_t::attach(uint8_t* bytes, uint8_t capacity, uint8_t resolution)
+{
+	_bytes = bytes;
+	_capacity = capacity;
+	_resolution = resolution;
+	reset();
+}
+
+/**
+ *	Removes all buckets
+ **/
+void history_stream_t::reset()
+{
+	_tail = 0;
+	_used = 0;
+	_size = 0;
+	_blocks = 0;
+	_block_size = KEYFRAME_INTERVAL;
+	_open_gap = false;
+	_keyframe = true;
+	_mean = 0;
+}
+
+/**
+ *	Pushes a bucket of the next slot, evicting the oldest block if there's not enough room
+ *	@param	bucket	a bucket to push
+ **/
+void history_stream_t::push(const history_bucket_t& bucket)
+{
+	long mean = quantize(bucket.mean, _resolution);
+	long min = quantize(bucket.min, _resolution);
+	long max = quantize(bucket.max, _resolution);
+
+	if (_block_size == KEYFRAME_INTERVAL)
+	{
+		_keyframe = true;
+	}
+	bool spread = min != mean || max != mean;
+	bool narrow = mean - min <= MAX_NARROW_SPREAD && max - mean <= MAX_NARROW_SPREAD;
+	uint8_t kind = !spread ? ENTRY_VALUE : narrow ? ENTRY_NARROW : ENTRY_SPREAD;
+
+	// Encode the entry
+	uint8_t entry[MAX_ENTRY];
+	uint8_t length = write_varint(entry, (zigzag(_keyframe ? mean : mean - _mean) << 2) | kind);
+	if (kind == ENTRY_NARROW)
+	{
+		entry[length++] = static_cast<uint8_t>(mean - min) | static_cast<uint8_t>(max - mean) << 4;
+	}
+	else if (kind == ENTRY_SPREAD)
+	{
+		length += write_varint(entry + length, mean - min);
+		length += write_varint(entry + length, max - mean);
+	}
+
+	append(entry, length);
+
+	_size++;
+	_open_gap = false;
+	_keyframe = false;
+	_mean = mean;
+}
+
+/**
+ *	Marks the next slot as having no measurements
+ **/
+void history_stream_t::push_gap()
+{
+	uint16_t last = _tail + _used - 1;
+	if (last >= _capacity)
+	{
+		last -= _capacity;
+	}
+
+	if (_open_gap && (_bytes[last] >> 2) < MAX_SHORT_GAP)
+	{
+		// Extend the newest gap entry in place
+		_bytes[last] += 1 << 2;
+	}
+	else
+	{
+		if (_block_size == KEYFRAME_INTERVAL)
+		{
+			_keyframe = true;
+		}
+
+		uint8_t entry = (1 << 2) | ENTRY_GAP;
+		append(&entry, 1);
+		_open_gap = true;
+	}
+
+	_size++;
+}
+
+/**
+ *	Appends an entry, evicting the oldest blocks if there's not enough room
+ *	@param	entry	encoded entry
+ *	@param	length	entry's length, bytes
+ **/
+void history_stream_t::append(const uint8_t* entry, uint8_t length)
+{
+	bool new_block = _block_size == KEYFRAME_INTERVAL;
+
+	// Free the room, the newest block can't be evicted while it's being filled
+	uint8_t sealed = new_block ? _blocks : _blocks - 1;
+	while (_capacity - _used < length && sealed > 0)
+	{
+		evict();
+		sealed--;
+	}
+
+	uint16_t pos = _tail + _used;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		if (pos >= _capacity)
+		{
+			pos -= _capacity;
+		}
+		_bytes[pos++] = entry[i];
+	}
+	_used += length;
+
+	if (new_block)
+	{
+		_blocks++;
+		_block_size = 1;
+	}
+	else
+	{
+		_block_size++;
+	}
+}
+
+/**
+ *	Evicts the oldest block
+ **/
+void history_stream_t::evict()
+{
+	uint16_t pos = _tail;
+	uint16_t slots = 0;
+	for (uint8_t i = 0; i < KEYFRAME_INTERVAL; i++)
+	{
+		unsigned long head = read_varint(pos);
+		switch (head & 0x03)
+		{
+		case ENTRY_GAP:
+			slots += head >> 2;
+			break;
+
+		case ENTRY_SPREAD:
+			read_varint(pos);
+			read_varint(pos);
+			slots++;
+			break;
+
+		case ENTRY_NARROW:
+			pos = pos + 1 == _capacity ? 0 : pos + 1;
+			// no break
+
+		default:
+			slots++;
+			break;
+		}
+	}
+
+	_used -= pos >= _tail ? pos - _tail : pos + _capacity - _tail;
+	_tail = pos;
+	_size -= slots;
+	_blocks--;
+}
+
+/**
+ *	Reads a varint
+ *	@param		pos		read position, advanced past the varint
+ *	@returns	decoded value
+ **/
+unsigned long history_stream_t::read_varint(uint16_t& pos) const
+{
+	unsigned long value = 0;
+	uint8_t shift = 0;
+	uint8_t b;
+	do
+	{
+		b = _bytes[pos];
+		pos = pos + 1 == _capacity ? 0 : pos + 1;
+		value |= static_cast<unsigned long>(b & 0x7F) << shift;
+		shift += 7;
+	} while (b & 0x80);
+
+	return value;
+}
\ No newline at end of file
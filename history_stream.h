@@ -0,0 +1,306 @@
+#pragma once
+
+#include "_config.h"
+#include "sensor.h"
+
+namespace thermograph
+{
+	/**
+	 *	Aggregated measurement results of a time span
+	 **/
+	struct history_bucket_t
+	{
+		/**
+		 *	A mean of a span without measurements
+		 **/
+		static const temperature_t GAP = -32767 - 1;
+
+		/**
+		 *	Min measured value
+		 **/
+		temperature_t min;
+
+		/**
+		 *	Max measured value
+		 **/
+		temperature_t max;
+
+		/**
+		 *	Average measured value
+		 **/
+		temperature_t mean;
+
+		/**
+		 *	Gets a value indicating whether the span has no measurements
+		 *	@returns	true if the bucket is a gap, false otherwise
+		 **/
+		bool is_gap() const { return mean == GAP; }
+	};
+
+	/**
+	 *	Compressed history buckets storage class.
+	 *	Stores one bucket per time slot, the newest bucket is the one before the owner's open slot,
+	 *	so a bucket's slot is derived from its index and buckets carry no timestamps.
+	 *	Values are rounded to the storage's resolution and encoded into a byte ring as blocks of KEYFRAME_INTERVAL entries.
+	 *	An entry is a varint of value << 2 | kind, where kind is one of:
+	 *		ENTRY_VALUE		value is zigzag(mean)
+	 *		ENTRY_SPREAD	the same, followed by varints of (mean - min) and (max - mean)
+	 *		ENTRY_GAP		value is a number of consecutive slots without measurements
+	 *		ENTRY_NARROW	the same as ENTRY_SPREAD, both spreads are nibbles of one byte: (mean - min) | (max - mean) << 4
+	 *	The first mean of a block (a keyframe) is stored as is, the following ones store
+	 *	the difference from the previous mean.
+	 *	Pushing into a full storage evicts its oldest block.
+	 *	The byte ring is owned by the caller, so storages of different capacities share the type
+	 **/
+	class history_stream_t
+	{
+	public:
+		/**
+		 *	Entries per block
+		 **/
+		static const uint8_t KEYFRAME_INTERVAL = 4;
+
+		/**
+		 *	Min resolution, hundredths of a unit
+		 **/
+		static const uint8_t MIN_RESOLUTION = 10;
+
+		/**
+		 *	Max encoded entry length, bytes: at MIN_RESOLUTION a mean takes up to 3 bytes, a spread up to 2
+		 **/
+		static const uint8_t MAX_ENTRY = 7;
+
+		/**
+		 *	Min storage capacity, bytes: the block being filled must fit
+		 **/
+		static const uint16_t MIN_CAPACITY = KEYFRAME_INTERVAL * MAX_ENTRY;
+
+		/**
+		 *	Max storage capacity, bytes. Positions within the ring are kept in bytes
+		 **/
+		static const uint16_t MAX_CAPACITY = 255;
+
+		/**
+		 *	Streaming decoder class, reads buckets from the oldest to the newest one
+		 **/
+		class reader_t
+		{
+		public:
+			/**
+			 *	Constructor
+			 *	@param	stream	storage to read
+			 **/
+			reader_t(const history_stream_t& stream);
+
+			/**
+			 *	Gets buckets left to read
+			 *	@returns	buckets count
+			 **/
+			uint16_t remaining() const { return _remaining; }
+
+			/**
+			 *	Decodes the next bucket
+			 *	@param		bucket	decoded bucket
+			 *	@returns	true if a bucket has been decoded, false if there are no buckets left
+			 **/
+			bool next(history_bucket_t& bucket);
+
+			/**
+			 *	Skips buckets
+			 *	@param	count	buckets to skip
+			 **/
+			void skip(uint16_t count);
+
+		private:
+			/**
+			 *	Storage being read
+			 **/
+			const history_stream_t& _stream;
+
+			/**
+			 *	Read position
+			 **/
+			uint16_t _pos;
+
+			/**
+			 *	Buckets left to read
+			 **/
+			uint16_t _remaining;
+
+			/**
+			 *	Gap slots left to read from the current entry
+			 **/
+			uint16_t _gap;
+
+			/**
+			 *	Index of the next entry in its block
+			 **/
+			uint8_t _index;
+
+			/**
+			 *	Indicates whether the next mean is a keyframe
+			 **/
+			bool _keyframe;
+
+			/**
+			 *	Previous bucket's mean, in resolution units
+			 **/
+			int16_t _mean;
+		};
+
+		/**
+		 *	Constructor, the storage must be attached to a byte ring before use
+		 **/
+		history_stream_t();
+
+		/**
+		 *	Attaches the storage to a byte ring and removes all buckets
+		 *	@param	bytes		byte ring
+		 *	@param	capacity	ring's length, [MIN_CAPACITY, MAX_CAPACITY] bytes
+		 *	@param	resolution	stored values' resolution, at least MIN_RESOLUTION hundredths of a unit
+		 **/
+		void attach(uint8_t* bytes, uint8_t capacity, uint8_t resolution);
+
+		/**
+		 *	Gets storage capacity
+		 *	@returns	byte ring's length
+		 **/
+		uint16_t capacity() const { return _capacity; }
+
+		/**
+		 *	Gets stored values' resolution
+		 *	@returns	resolution, hundredths of a unit
+		 **/
+		uint8_t resolution() const { return _resolution; }
+
+		/**
+		 *	Gets stored buckets count
+		 *	@returns	buckets count
+		 **/
+		uint16_t size() const { return _size; }
+
+		/**
+		 *	Gets a value indicating whether the storage is empty
+		 *	@returns	true if there are no buckets, false otherwise
+		 **/
+		bool empty() const { return _size == 0; }
+
+		/**
+		 *	Gets encoded buckets length
+		 *	@returns	used storage, bytes
+		 **/
+		uint16_t used() const { return _used; }
+
+		/**
+		 *	Removes all buckets
+		 **/
+		void reset();
+
+		/**
+		 *	Pushes a bucket of the next slot, evicting the oldest block if there's not enough room
+		 *	@param	bucket	a bucket to push
+		 **/
+		void push(const history_bucket_t& bucket);
+
+		/**
+		 *	Marks the next slot as having no measurements
+		 **/
+		void push_gap();
+
+	private:
+		/**
+		 *	Entry kinds
+		 **/
+		enum entry_kind
+		{
+			ENTRY_VALUE,
+			ENTRY_SPREAD,
+			ENTRY_GAP,
+			ENTRY_NARROW
+		};
+
+		/**
+		 *	Max gap slots which fit a one byte entry
+		 **/
+		static const uint8_t MAX_SHORT_GAP = 0x7F >> 2;
+
+		/**
+		 *	Max spread which fits a nibble of a narrow entry
+		 **/
+		static const uint8_t MAX_NARROW_SPREAD = 0x0F;
+
+		/**
+		 *	Encoded buckets ring
+		 **/
+		uint8_t* _bytes;
+
+		/**
+		 *	Ring's length, bytes
+		 **/
+		uint8_t _capacity;
+
+		/**
+		 *	Stored values' resolution, hundredths of a unit
+		 **/
+		uint8_t _resolution;
+
+		/**
+		 *	Oldest block's position
+		 **/
+		uint8_t _tail;
+
+		/**
+		 *	Encoded buckets length, bytes
+		 **/
+		uint8_t _used;
+
+		/**
+		 *	Stored buckets count
+		 **/
+		uint16_t _size;
+
+		/**
+		 *	Stored blocks count
+		 **/
+		uint8_t _blocks;
+
+		/**
+		 *	Entries in the newest block
+		 **/
+		uint8_t _block_size;
+
+		/**
+		 *	Indicates whether the newest entry is a one byte gap which can be extended
+		 **/
+		bool _open_gap;
+
+		/**
+		 *	Indicates whether the next mean is a keyframe
+		 **/
+		bool _keyframe;
+
+		/**
+		 *	The newest bucket's mean in resolution units, a base for the next entry
+		 **/
+		int16_t _mean;
+
+		/**
+		 *	Appends an entry, evicting the oldest blocks if there's not enough room
+		 *	@param	entry	encoded entry
+		 *	@param	length	entry's length, bytes
+		 **/
+		void append(const uint8_t* entry, uint8_t length);
+
+		/**
+		 *	Evicts the oldest block
+		 **/
+		void evict();
+
+		/**
+		 *	Reads a varint
+		 *	@param		pos		read position, advanced past the varint
+		 *	@returns	decoded value
+		 **/
+		unsigned long read_varint(uint16_t& pos) const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+/*
+ * Host stand-in for the Arduino core (Arduino Uno, core 1.0.x).
+ * Timing, pin I/O, the serial port and the LCD are backed by the
+ * simulated board from "sim.h", driven by a deterministic virtual clock.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "avr/io.h"
+#include "Print.h"
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT  0x0
+#define OUTPUT 0x1
+
+#define DEFAULT  1
+#define EXTERNAL 0
+#define INTERNAL 3
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+/*
+ * Program memory access. Flash and RAM share an address space on the host.
+ */
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char *
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t *>(addr))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+/*
+ * Interrupt control
+ */
+void cli();
+void sei();
+#define interrupts() sei()
+#define noInterrupts() cli()
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+/*
+ * Timing
+ */
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/*
+ * Pin I/O
+ */
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogReference(uint8_t mode);
+
+/*
+ * Serial port
+ */
+class HardwareSerial : public Print
+{
+public:
+	void begin(unsigned long baud);
+	void end();
+	int available();
+	int read();
+	void flush();
+	virtual size_t write(uint8_t c);
+	using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+/*
+ * Sketch entry points
+ */
+void setup();
+void loop();
\ No newline at end of file
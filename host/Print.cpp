@@ -0,0 +1,226 @@
+#include <math.h>
+#include <string.h>
+#include "Arduino.h"
+#include "Print.h"
+
+/*
+ * Host stand-in for the Arduino core's Print class.
+ */
+
+size_t Print::write(const char *str)
+{
+	return write(reinterpret_cast<const uint8_t *>(str), strlen(str));
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+	size_t n = 0;
+	while (size--)
+	{
+		n += write(*buffer++);
+	}
+	return n;
+}
+
+size_t Print::print(const __FlashStringHelper *ifsh)
+{
+	const char *p = reinterpret_cast<const char *>(ifsh);
+	size_t n = 0;
+	while (true)
+	{
+		unsigned char c = pgm_read_byte(p++);
+		if (c == 0) break;
+		n += write(c);
+	}
+	return n;
+}
+
+size_t Print::print(const char str[])
+{
+	return write(str);
+}
+
+size_t Print::print(char c)
+{
+	return write(static_cast<uint8_t>(c));
+}
+
+size_t Print::print(unsigned char b, int base)
+{
+	return print(static_cast<unsigned long>(b), base);
+}
+
+size_t Print::print(int n, int base)
+{
+	return print(static_cast<long>(n), base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+	return print(static_cast<unsigned long>(n), base);
+}
+
+size_t Print::print(long n, int base)
+{
+	if (base == 0)
+	{
+		return write(static_cast<uint8_t>(n));
+	}
+	else if (base == 10)
+	{
+		if (n < 0)
+		{
+			int t = print('-');
+			n = -n;
+			return printNumber(n, 10) + t;
+		}
+		return printNumber(n, 10);
+	}
+	else
+	{
+		// AVR longs are 32-bit wide, keep negative hex/binary output identical
+		return printNumber(static_cast<uint32_t>(n), base);
+	}
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+	if (base == 0) return write(static_cast<uint8_t>(n));
+	else return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits)
+{
+	return printFloat(n, digits);
+}
+
+size_t Print::println(const __FlashStringHelper *ifsh)
+{
+	size_t n = print(ifsh);
+	n += println();
+	return n;
+}
+
+size_t Print::println(void)
+{
+	size_t n = print('\r');
+	n += print('\n');
+	return n;
+}
+
+size_t Print::println(const char c[])
+{
+	size_t n = print(c);
+	n += println();
+	return n;
+}
+
+size_t Print::println(char c)
+{
+	size_t n = print(c);
+	n += println();
+	return n;
+}
+
+size_t Print::println(unsigned char b, int base)
+{
+	size_t n = print(b, base);
+	n += println();
+	return n;
+}
+
+size_t Print::println(int num, int base)
+{
+	size_t n = print(num, base);
+	n += println();
+	return n;
+}
+
+size_t Print::println(unsigned int num, int base)
+{
+	size_t n = print(num, base);
+	n += println();
+	return n;
+}
+
+size_t Print::println(long num, int base)
+{
+	size_t n = print(num, base);
+	n += println();
+	return n;
+}
+
+size_t Print::println(unsigned long num, int base)
+{
+	size_t n = print(num, base);
+	n += println();
+	return n;
+}
+
+size_t Print::println(double num, int digits)
+{
+	size_t n = print(num, digits);
+	n += println();
+	return n;
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base)
+{
+	char buf[8 * sizeof(long) + 1];
+	char *str = &buf[sizeof(buf) - 1];
+
+	*str = '\0';
+
+	if (base < 2) base = 10;
+
+	do
+	{
+		unsigned long m = n;
+		n /= base;
+		char c = m - base * n;
+		*--str = c < 10 ? c + '0' : c + 'A' - 10;
+	} while (n);
+
+	return write(str);
+}
+
+size_t Print::printFloat(double number, uint8_t digits)
+{
+	size_t n = 0;
+
+	if (isnan(number)) return print("nan");
+	if (isinf(number)) return print("inf");
+
+	if (number < 0.0)
+	{
+		n += print('-');
+		number = -number;
+	}
+
+	double rounding = 0.5;
+	for (uint8_t i = 0; i < digits; ++i)
+	{
+		rounding /= 10.0;
+	}
+
+	number += rounding;
+
+	unsigned long int_part = static_cast<unsigned long>(number);
+	double remainder = number - static_cast<double>(int_part);
+	n += print(int_part);
+
+	if (digits > 0)
+	{
+		n += print(".");
+	}
+
+	while (digits-- > 0)
+	{
+		remainder *= 10.0;
+		int to_print = int(remainder);
+		n += print(to_print);
+		remainder -= to_print;
+	}
+
+	return n;
+}
\ No newline at end of file
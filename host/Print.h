@@ -0,0 +1,52 @@
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+
+/*
+ * Host stand-in for the Arduino core's Print class.
+ * Mirrors Arduino 1.0 formatting rules so that captured serial and LCD
+ * output is byte-for-byte identical to the firmware's.
+ */
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper;
+
+class Print
+{
+public:
+	virtual ~Print() { }
+
+	virtual size_t write(uint8_t) = 0;
+	size_t write(const char *str);
+	virtual size_t write(const uint8_t *buffer, size_t size);
+
+	size_t print(const __FlashStringHelper *);
+	size_t print(const char[]);
+	size_t print(char);
+	size_t print(unsigned char, int = DEC);
+	size_t print(int, int = DEC);
+	size_t print(unsigned int, int = DEC);
+	size_t print(long, int = DEC);
+	size_t print(unsigned long, int = DEC);
+	size_t print(double, int = 2);
+
+	size_t println(const __FlashStringHelper *);
+	size_t println(const char[]);
+	size_t println(char);
+	size_t println(unsigned char, int = DEC);
+	size_t println(int, int = DEC);
+	size_t println(unsigned int, int = DEC);
+	size_t println(long, int = DEC);
+	size_t println(unsigned long, int = DEC);
+	size_t println(double, int = 2);
+	size_t println(void);
+
+private:
+	size_t printNumber(unsigned long, uint8_t);
+	size_t printFloat(double, uint8_t);
+};
\ No newline at end of file
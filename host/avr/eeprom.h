@@ -0,0 +1,14 @@
+#pragma once
+
+/*
+ * Host stand-in for <avr/eeprom.h>. The EEPROM is modelled by the simulated
+ * board (see "sim.cpp"), its image may be kept in a file between runs.
+ */
+
+#include <inttypes.h>
+
+#define E2END 0x3FF
+
+uint8_t eeprom_read_byte(const uint8_t* addr);
+void eeprom_write_byte(uint8_t* addr, uint8_t value);
+int eeprom_is_ready(void);
\ No newline at end of file
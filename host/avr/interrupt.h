@@ -0,0 +1,10 @@
+#pragma once
+
+/*
+ * Host stand-in for <avr/interrupt.h>. Interrupt handlers are plain
+ * functions named after their vectors, the simulated board calls them.
+ */
+
+#include "Arduino.h"
+
+#define ISR(vector, ...) extern "C" void vector(void); extern "C" void vector(void)
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+ * Host stand-in for <avr/io.h>. Only the ADC's and USART0's registers are modelled,
+ * as plain variables sampled by the simulated board (see "sim.cpp").
+ * Writing UDR0 starts a transmission, so it's an object rather than a variable,
+ * so is SREG, which only models the global interrupt flag.
+ */
+
+#include <inttypes.h>
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+extern "C"
+{
+	extern volatile uint8_t ADMUX;
+	extern volatile uint8_t ADCSRA;
+	extern volatile uint8_t ADCSRB;
+	extern volatile uint8_t DIDR0;
+	extern volatile uint16_t ADC;
+
+	extern volatile uint8_t UCSR0A;
+	extern volatile uint8_t UCSR0B;
+	extern volatile uint8_t UCSR0C;
+	extern volatile uint16_t UBRR0;
+}
+
+struct udr_t
+{
+	udr_t& operator=(uint8_t value);
+};
+
+extern udr_t UDR0;
+
+struct sreg_t
+{
+	operator uint8_t() const;
+	sreg_t& operator=(uint8_t value);
+};
+
+extern sreg_t SREG;
+
+/* SREG */
+#define SREG_I 7
+
+/* ADMUX */
+#define REFS1 7
+#define REFS0 6
+#define ADLAR 5
+#define MUX3 3
+#define MUX2 2
+#define MUX1 1
+#define MUX0 0
+
+/* ADCSRA */
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+
+/* ADCSRB */
+#define ADTS2 2
+#define ADTS1 1
+#define ADTS0 0
+
+/* UCSR0A */
+#define RXC0 7
+#define TXC0 6
+#define UDRE0 5
+#define U2X0 1
+
+/* UCSR0B */
+#define RXCIE0 7
+#define TXCIE0 6
+#define UDRIE0 5
+#define RXEN0 4
+#define TXEN0 3
+
+/* UCSR0C */
+#define UCSZ01 2
+#define UCSZ00 1
\ No newline at end of file
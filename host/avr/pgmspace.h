@@ -0,0 +1,7 @@
+#pragma once
+
+/*
+ * Host stand-in for <avr/pgmspace.h>. Program memory helpers live in "Arduino.h".
+ */
+
+#include "Arduino.h"
\ No newline at end of file
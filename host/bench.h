@@ -0,0 +1,64 @@
+#pragma once
+
+#include <time.h>
+
+/*
+ * Micro-benchmark helpers for the host benches.
+ *
+ * Host timings only rank code paths against each other: the host has
+ * hardware floating point and a fast divider, so AVR costs are reported
+ * separately as operation counts.
+ */
+namespace bench
+{
+	/*
+	 * Timing repeats, the fastest one is reported
+	 */
+	const int REPEATS = 5;
+
+	/*
+	 * Gets the process' CPU time, in nanoseconds
+	 */
+	inline double cpu_ns()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+		return ts.tv_sec * 1e9 + ts.tv_nsec;
+	}
+
+	/*
+	 * Keeps a computed value from being optimized away
+	 */
+	template<typename T>
+	inline void keep(const T& value)
+	{
+		asm volatile("" : : "r"(&value) : "memory");
+	}
+
+	/*
+	 * Times a function called with every argument in [0, count) for a number of rounds
+	 * @returns	host nanoseconds per call, the fastest of REPEATS
+	 */
+	template<typename F>
+	double time_per_call(F f, unsigned long count, unsigned long rounds)
+	{
+		double best = 0;
+		for (int r = 0; r < REPEATS; r++)
+		{
+			double start = cpu_ns();
+			for (unsigned long i = 0; i < rounds; i++)
+			{
+				for (unsigned long n = 0; n < count; n++)
+				{
+					keep(f(n));
+				}
+			}
+			double ns = (cpu_ns() - start) / (static_cast<double>(count) * rounds);
+			if (r == 0 || ns < best)
+			{
+				best = ns;
+			}
+		}
+		return best;
+	}
+}
\ No newline at end of file
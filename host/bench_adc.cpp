@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <math.h>
+#include "Arduino.h"
+#include "sim.h"
+#include "adc.h"
+#include "bench.h"
+
+using namespace thermograph;
+
+/*
+ * ADC oversampling bench: effective bits of the scanner's filtered
+ * readings against the conversions and CPU time they take.
+ *
+ *	usage: bench_adc
+ *
+ * A channel per oversampling setting is scanned on the simulated ADC,
+ * all of them fed the same LM35-like signal: a slow drift plus gaussian
+ * noise, quantized to 10 bits. A filtered reading's error is its distance
+ * from the noiseless signal, effective bits are 10 - log2(rms error * sqrt(12)).
+ */
+
+namespace
+{
+	const sim::usec_t SECOND = 1000000ULL;
+	const sim::usec_t MINUTE = 60 * SECOND;
+
+	/*
+	 * Signal: mid-range code, its drift amplitude and period, noise deviation, in 10-bit LSB
+	 */
+	const double SIGNAL_LEVEL = 250.3;
+	const double SIGNAL_DRIFT = 0.5;
+	const sim::usec_t SIGNAL_PERIOD = 10 * MINUTE;
+	const double SIGNAL_NOISE = 0.7;
+
+	/*
+	 * Scanning time and the filters' warm-up before readings are scored
+	 */
+	const sim::usec_t RUN_TIME = 20 * MINUTE;
+	const sim::usec_t WARMUP = 30 * SECOND;
+
+	/*
+	 * Channels per oversampling setting n: A(1 + n)
+	 */
+	const uint8_t SETTINGS = adc_scanner_t::MAX_OVERSAMPLING + 1;
+
+	const unsigned long CONVERSIONS = 1UL << 16;
+	const unsigned long ROUNDS = 200;
+
+	/*
+	 * Deterministic gaussian noise: a linear congruential generator and Box-Muller transform
+	 */
+	uint32_t random_state = 12345;
+
+	double uniform()
+	{
+		random_state = random_state * 1664525UL + 1013904223UL;
+		return (random_state + 0.5) / 4294967296.0;
+	}
+
+	double gaussian()
+	{
+		return sqrt(-2 * log(uniform())) * cos(2 * M_PI * uniform());
+	}
+
+	double signal(sim::usec_t now)
+	{
+		return SIGNAL_LEVEL + SIGNAL_DRIFT * sin(2 * M_PI * static_cast<double>(now % SIGNAL_PERIOD) / SIGNAL_PERIOD);
+	}
+
+	int noisy_signal(uint8_t channel, sim::usec_t now)
+	{
+		return static_cast<int>(floor(signal(now) + SIGNAL_NOISE * gaussian() + 0.5));
+	}
+
+	/*
+	 * Squared errors of a channel's filtered readings, in 10-bit LSB
+	 */
+	struct score_t
+	{
+		double sum;
+		unsigned long count;
+
+		double effective_bits() const
+		{
+			return 10 - log2(sqrt(sum / count) * sqrt(12.0));
+		}
+	};
+
+	/*
+	 * Times the scanner's conversion handler with a single channel
+	 * @returns	host nanoseconds per conversion
+	 */
+	double time_conversions(uint8_t oversampling)
+	{
+		static adc_scanner_t scanner;
+		scanner = adc_scanner_t();
+		scanner.add(A1, DEFAULT, oversampling);
+		scanner.start();
+
+		return bench::time_per_call([](unsigned long n)
+		{
+			ADC = 250 + (n & 1);
+			scanner.on_conversion();
+			return scanner.filtered(A1);
+		}, CONVERSIONS, ROUNDS);
+	}
+}
+
+int main()
+{
+	for (uint8_t n = 0; n < SETTINGS; n++)
+	{
+		sim::set_analog_source(A1 + n, noisy_signal);
+		adc_scanner.add(A1 + n, DEFAULT, n);
+	}
+	adc_scanner.start();
+
+	score_t scores[SETTINGS] = { };
+	uint16_t revision = 0;
+	while (sim::now() < RUN_TIME)
+	{
+		sim::advance(1000);
+		if (adc_scanner.get_revision() == revision || sim::now() < WARMUP)
+		{
+			continue;
+		}
+		revision = adc_scanner.get_revision();
+
+		double truth = signal(sim::now());
+		for (uint8_t n = 0; n < SETTINGS; n++)
+		{
+			double error = adc_scanner.filtered(A1 + n) / 64.0 - truth;
+			scores[n].sum += error * error;
+			scores[n].count++;
+		}
+	}
+
+	// The scanner stops interrupting once the simulated time stops moving
+	uint64_t conversions = sim::counters().adc_conversions;
+
+	printf("adc oversampling, %u channels scanned, noise %.1f LSB, drift %.1f LSB, filter shift %d\n",
+		SETTINGS, SIGNAL_NOISE, SIGNAL_DRIFT, APP_ADC_FILTER_SHIFT);
+	printf("  n  effective bits  conversions per value  values per second  host ns per conversion\n");
+	for (uint8_t n = 0; n < SETTINGS; n++)
+	{
+		double rate = static_cast<double>(conversions) / SETTINGS / (RUN_TIME / SECOND) / (1 << (2 * n));
+		printf("  %u  %14.2f  %21d  %17.1f  %22.1f\n", n, scores[n].effective_bits(), 1 << (2 * n), rate, time_conversions(n));
+	}
+	printf("  conversions are Timer0 triggered, so every n costs the same ADC interrupts: %.0f per second\n",
+		static_cast<double>(conversions) / (RUN_TIME / SECOND));
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <string.h>
+#include "Arduino.h"
+#include "format.h"
+#include "number_format.h"
+#include "bench.h"
+
+using namespace thermograph;
+
+/*
+ * Number formatting bench: number_format_t against the util::print_number()
+ * and Print::print() paths it replaced.
+ *
+ *	usage: bench_format
+ *
+ * Both paths print into the same sink and must produce the same text.
+ * AVR costs are estimated from the divisions each path makes, the former
+ * path's copy below counts them as it goes.
+ */
+
+namespace
+{
+	/*
+	 * Approximate libgcc routine costs on an ATmega328P, in cycles
+	 */
+	const unsigned long CYCLES_DIV16 = 220;
+	const unsigned long CYCLES_DIV32 = 650;
+
+	const unsigned long CALLS = 1000;
+	const unsigned long ROUNDS = 2000;
+
+	/*
+	 * Divisions made by the former path
+	 */
+	unsigned long divisions16;
+	unsigned long divisions32;
+
+	/*
+	 * Printer that keeps the text of its last call
+	 */
+	class sink_t : public Print
+	{
+	public:
+		sink_t() : _length(0) { }
+
+		virtual size_t write(uint8_t c)
+		{
+			if (_length < sizeof(_text) - 1)
+			{
+				_text[_length++] = c;
+			}
+			return 1;
+		}
+
+		void clear() { _length = 0; }
+
+		const char* text() { _text[_length] = '\0'; return _text; }
+
+	private:
+		char _text[64];
+		size_t _length;
+	};
+
+	sink_t sink;
+
+	/*
+	 * Former util.cpp, with division counters
+	 */
+	int powerOf10(int pow)
+	{
+		int16_t x = 1;
+		for (int i = 0; i < pow; i++)
+		{
+			x *= 10;
+		}
+
+		return x;
+	}
+
+	int get_number(int value, int index)
+	{
+		int16_t d1 = powerOf10(index + 1);
+		int16_t d2 = powerOf10(index);
+		int16_t x = (value % d1 - value % d2) / d2;
+		divisions16 += 3;
+		return x;
+	}
+
+	/*
+	 * Prints a number through Print, one 32-bit division per digit
+	 */
+	void print_long(Print& print, long value)
+	{
+		unsigned long n = value < 0 ? -value : value;
+		do
+		{
+			divisions32++;
+			n /= 10;
+		} while (n != 0);
+		print.print(value);
+	}
+
+	void print_number(Print& print, int value, int precision, char placeholder)
+	{
+		for (int i = precision - 1; i >= 0; i--)
+		{
+			int16_t x = get_number(value, i);
+
+			if (x == 0 && i != 0)
+			{
+				print.print(placeholder);
+			}
+			else
+			{
+				print_long(print, x);
+			}
+		}
+	}
+
+	void print_fixed(Print& print, long value, int decimals)
+	{
+		if (value < 0)
+		{
+			print.print('-');
+			value = -value;
+		}
+
+		int scale = powerOf10(decimals);
+		divisions32++;
+		print_long(print, value / scale);
+		if (decimals > 0)
+		{
+			print.print('.');
+			print_number(print, value % scale, decimals, '0');
+		}
+	}
+
+	/*
+	 * A log line's timestamps: local and global time
+	 */
+	void former_timestamp(Print& out, const sys_time_t& local, const thermograph::time_t& global)
+	{
+		print_number(out, local.h, 4, ' ');
+		out.print(':');
+		print_number(out, local.min, 2, '0');
+		out.print(':');
+		print_number(out, local.sec, 2, '0');
+		out.print('.');
+		print_number(out, local.ms, 3, '0');
+		out.print(' ');
+		print_number(out, global.h, 2, '0');
+		out.print(':');
+		print_number(out, global.min, 2, '0');
+		out.print(':');
+		print_number(out, global.sec, 2, '0');
+	}
+
+	void timestamp(Print& out, const sys_time_t& local, const thermograph::time_t& global)
+	{
+		format_time(out, local);
+		out.print(' ');
+		format_time(out, global);
+	}
+
+	/*
+	 * Benchmark case: a value to print both ways
+	 */
+	struct case_t
+	{
+		const char* name;
+		void (*former)(unsigned long n);
+		void (*current)(unsigned long n);
+		unsigned long (*divisions32)(unsigned long n);
+	};
+
+	sys_time_t local_time(unsigned long n)
+	{
+		sys_time_t t = { static_cast<uint16_t>(1234 + n % 7), static_cast<uint8_t>(n % 60), static_cast<uint8_t>(59 - n % 60), static_cast<uint16_t>(n % 1000) };
+		return t;
+	}
+
+	thermograph::time_t global_time(unsigned long n)
+	{
+		thermograph::time_t t = { static_cast<uint8_t>(n % 24), static_cast<uint8_t>(n % 60), static_cast<uint8_t>(n % 59) };
+		return t;
+	}
+
+	long fixed_value(unsigned long n)
+	{
+		return -1234 - static_cast<long>(n % 3);
+	}
+
+	long long_value(unsigned long n)
+	{
+		return 35981781L + static_cast<long>(n);
+	}
+
+	/*
+	 * Long divisions number_format_t makes: one per four digits above 16 bits
+	 */
+	unsigned long long_divisions(unsigned long n)
+	{
+		unsigned long divisions = 0;
+		for (unsigned long value = n; value > 0xFFFF; value /= 10000)
+		{
+			divisions++;
+		}
+		return divisions;
+	}
+
+	const case_t cases[] =
+	{
+		{
+			"log timestamp, 7 fields",
+			[](unsigned long n) { former_timestamp(sink, local_time(n), global_time(n)); },
+			[](unsigned long n) { timestamp(sink, local_time(n), global_time(n)); },
+			[](unsigned long n) { return 0UL; }
+		},
+		{
+			"fixed -12.34",
+			[](unsigned long n) { print_fixed(sink, fixed_value(n), 2); },
+			[](unsigned long n) { number_format_t(fixed_value(n), 2).print(sink); },
+			[](unsigned long n) { return long_divisions(1234); }
+		},
+		{
+			"long 35981781",
+			[](unsigned long n) { print_long(sink, long_value(n)); },
+			[](unsigned long n) { number_format_t(long_value(n)).print(sink); },
+			[](unsigned long n) { return long_divisions(long_value(n)); }
+		}
+	};
+}
+
+int main()
+{
+	int mismatches = 0;
+
+	printf("number formatting, host ns and estimated avr cycles per call\n");
+	printf("  %-24s  %10s  %10s  %12s  %12s\n", "case", "former ns", "current ns", "former avr", "current avr");
+	for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+	{
+		const case_t& c = cases[i];
+
+		// Same text both ways, the former path's divisions are counted meanwhile
+		divisions16 = divisions32 = 0;
+		unsigned long current_divisions = 0;
+		for (unsigned long n = 0; n < CALLS; n++)
+		{
+			char former[64];
+			sink.clear();
+			c.former(n);
+			strcpy(former, sink.text());
+
+			sink.clear();
+			c.current(n);
+			current_divisions += c.divisions32(n);
+			if (strcmp(former, sink.text()) != 0)
+			{
+				printf("  mismatch: \"%s\" vs \"%s\"\n", former, sink.text());
+				mismatches++;
+			}
+		}
+
+		unsigned long former_cycles = (divisions16 * CYCLES_DIV16 + divisions32 * CYCLES_DIV32) / CALLS;
+		unsigned long current_cycles = current_divisions * CYCLES_DIV32 / CALLS;
+
+		double former_ns = bench::time_per_call([&c](unsigned long n) { sink.clear(); c.former(n); return 0; }, CALLS, ROUNDS);
+		double current_ns = bench::time_per_call([&c](unsigned long n) { sink.clear(); c.current(n); return 0; }, CALLS, ROUNDS);
+
+		printf("  %-24s  %10.1f  %10.1f  %12lu  %12lu\n", c.name, former_ns, current_ns, former_cycles, current_cycles);
+	}
+	printf("  avr figures count divisions only: ~%lu cycles per 16-bit and ~%lu per 32-bit one,\n", CYCLES_DIV16, CYCLES_DIV32);
+	printf("  number_format_t splits 16-bit values by reciprocal multiplication instead\n");
+	printf("  %d mismatches\n", mismatches);
+
+	return mismatches;
+}
\ No newline at end of file
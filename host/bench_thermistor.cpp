@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Arduino.h"
+#include "sensor.h"
+#include "thermistor_table.h"
+#include "bench.h"
+
+using namespace thermograph;
+
+/*
+ * Thermistor conversion bench: the firmware's table lookup against the
+ * floating point path it replaced.
+ *
+ *	usage: bench_thermistor
+ *
+ * Reports host time per conversion, the soft-float operations the former
+ * path makes on AVR, and the two paths' largest disagreement.
+ */
+
+namespace
+{
+	/*
+	 * Approximate soft-float routine costs on an ATmega328P, in cycles (avr-libc fplib)
+	 */
+	const unsigned long CYCLES_ADD = 110;
+	const unsigned long CYCLES_MUL = 150;
+	const unsigned long CYCLES_DIV = 480;
+	const unsigned long CYCLES_CMP = 50;
+	const unsigned long CYCLES_CONVERT = 70;
+
+	const int ADC_RANGE = 1024;
+	const unsigned long ROUNDS = 2000;
+
+	/*
+	 * Soft-float operation counters
+	 */
+	struct operations_t
+	{
+		unsigned long add, mul, div, cmp, convert;
+
+		unsigned long cycles() const
+		{
+			return add * CYCLES_ADD + mul * CYCLES_MUL + div * CYCLES_DIV + cmp * CYCLES_CMP + convert * CYCLES_CONVERT;
+		}
+	};
+
+	operations_t operations;
+
+	/*
+	 * Floating point number that counts the operations made with it
+	 */
+	struct counted_t
+	{
+		float v;
+
+		counted_t(float value = 0) : v(value) { }
+		counted_t(int value) : v(value) { operations.convert++; }
+
+		operator float() const { return v; }
+	};
+
+	counted_t operator+(counted_t a, counted_t b) { operations.add++; return counted_t(a.v + b.v); }
+	counted_t operator-(counted_t a, counted_t b) { operations.add++; return counted_t(a.v - b.v); }
+	counted_t operator*(counted_t a, counted_t b) { operations.mul++; return counted_t(a.v * b.v); }
+	counted_t operator/(counted_t a, counted_t b) { operations.div++; return counted_t(a.v / b.v); }
+	bool operator<=(counted_t a, counted_t b) { operations.cmp++; return a.v <= b.v; }
+
+	/*
+	 * Former conversion path of thermistor_sensor_node_t::update(), double is float on AVR
+	 */
+	template<typename T>
+	struct float_path_t
+	{
+		struct temperature_point_t
+		{
+			float t;
+			float r;
+		};
+
+		static const temperature_point_t* points(size_t& count)
+		{
+			static const temperature_point_t temperature_points[] =
+			{
+				{ -55.0, 121.46 }, { -50.0, 84.439 }, { -45.0, 59.243 }, { -40.0, 41.938 }, { -35.0, 29.947 },
+				{ -30.0, 21.567 }, { -25.0, 15.641 }, { -20.0, 11.466 }, { -15.0, 8.451 }, { -10.0, 6.2927 },
+				{  -5.0, 4.7077 }, {   0.0, 3.5563 }, {   5.0, 2.7119 }, {  10.0, 2.086  }, {  15.0, 1.6204 },
+				{  20.0, 1.2683 }, {  25.0, 1.0000 }, {  30.0, 0.7942 }, {  35.0, 0.63268 },
+				{  40.0, 0.5074 }, {  45.0, 0.41026 }, {  50.0, 0.33363 }, {  55.0, 0.27243 }
+			};
+			count = sizeof(temperature_points) / sizeof(temperature_points[0]);
+			return temperature_points;
+		}
+
+		/*
+		 * Converts an ADC code, returns NAN outside of the points' range
+		 */
+		static float convert(int a)
+		{
+			size_t count;
+			const temperature_point_t* p = points(count);
+
+			T a_t = T(a) / T(1023.0f);
+			T r_t = T(1.0f * 1000) * (T(1.0f) - a_t) / a_t;
+			T k = r_t / T(10.0f * 1000);
+
+			size_t index = count;
+			for (size_t i = 1; i < count; i++)
+			{
+				if (T(p[i].r) <= k)
+				{
+					index = i - 1;
+					break;
+				}
+			}
+			if (index == count)
+			{
+				return NAN;
+			}
+
+			T slope = (T(p[index + 1].t) - T(p[index].t)) / (T(p[index + 1].r) - T(p[index].r));
+			T b = T(p[index].t) - slope * T(p[index].r);
+			return slope * k + b;
+		}
+	};
+}
+
+int main()
+{
+	// Accuracy over the codes the table covers
+	int valid = 0;
+	double worst = 0;
+	int worst_code = 0;
+	for (int a = 0; a < ADC_RANGE; a++)
+	{
+		temperature_t centi_t = thermistor_sensor_node_t::convert(a << 6);
+		if (centi_t == THERMISTOR_TABLE_INVALID)
+		{
+			continue;
+		}
+
+		valid++;
+		double difference = fabs(centi_t - float_path_t<float>::convert(a) * 100);
+		if (difference > worst)
+		{
+			worst = difference;
+			worst_code = a;
+		}
+	}
+
+	// Soft-float operations of the former path, averaged over the valid codes
+	operations_t total = { 0, 0, 0, 0, 0 };
+	for (int a = 0; a < ADC_RANGE; a++)
+	{
+		if (thermistor_sensor_node_t::convert(a << 6) == THERMISTOR_TABLE_INVALID)
+		{
+			continue;
+		}
+
+		operations = total;
+		float_path_t<counted_t>::convert(a);
+		total = operations;
+	}
+
+	double float_ns = bench::time_per_call([](unsigned long a) { return float_path_t<float>::convert(a); }, ADC_RANGE, ROUNDS);
+	double table_ns = bench::time_per_call([](unsigned long a) { return thermistor_sensor_node_t::convert(a << 6); }, ADC_RANGE, ROUNDS);
+	double interpolated_ns = bench::time_per_call([](unsigned long a) { return thermistor_sensor_node_t::convert(a * 64 + 37); }, ADC_RANGE, ROUNDS);
+
+	printf("thermistor conversion, %d ADC codes, %d in table's range\n", ADC_RANGE, valid);
+	printf("  host float path        %6.1f ns per call\n", float_ns);
+	printf("  host table lookup      %6.1f ns per call\n", table_ns);
+	printf("  host table, fraction   %6.1f ns per call\n", interpolated_ns);
+	printf("  avr float path         %.1f add, %.1f mul, %.1f div, %.1f cmp, %.1f int->float per call\n",
+		static_cast<double>(total.add) / valid, static_cast<double>(total.mul) / valid, static_cast<double>(total.div) / valid,
+		static_cast<double>(total.cmp) / valid, static_cast<double>(total.convert) / valid);
+	printf("  avr float path         ~%lu cycles per call, estimated from soft-float routine costs\n", total.cycles() / valid);
+	printf("  avr table lookup       no soft-float calls, 2 PROGMEM words and a 16x8 bit multiply at most\n");
+	printf("  flash, float path      %d bytes of points, plus fplib division and comparison\n", static_cast<int>(23 * 2 * sizeof(float)));
+	printf("  flash, table           %d bytes\n", static_cast<int>(sizeof(thermistor_table)));
+	printf("  max difference         %.2f centi-degrees at code %d\n", worst, worst_code);
+
+	return worst <= 1 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#!/bin/sh
+#
+# Before/after report of two host builds: firmware code size, log lines by
+# level and the simulator's counters over a run, side by side.
+#
+#	usage: compare.sh before_tree after_tree days
+#
+# Each tree is a source tree whose host simulator has been built, see
+# "make compare" in the Makefile.
+#
+
+set -e
+
+if [ $# -ne 3 ]; then
+	echo "usage: $0 before_tree after_tree days" >&2
+	exit 2
+fi
+
+days=$3
+
+for side in before after; do
+	if [ $side = before ]; then tree=$1; else tree=$2; fi
+
+	"$tree/host/thermograph_sim" -d "$days" -q -s "$tree/serial.log" > "$tree/report.txt"
+
+	{
+		printf 'firmware .text    %s bytes\n' "$(size -t "$tree"/host/build/fw/*.o | tail -n 1 | awk '{ print $1 }')"
+		for level in ERR INF DBG; do
+			printf 'log %s lines     %s\n' $level "$(grep -c "	$level	" "$tree/serial.log" || true)"
+		done
+		cat "$tree/report.txt"
+		awk '
+			/^simulated time/ { simulated = $3 }
+			/^loop iterations/ { iterations = $3 }
+			/^busy time/ { busy = $3 }
+			END { printf "busy per loop     %.2f us\n", busy / 100 * simulated * 1e6 / iterations }
+		' "$tree/report.txt"
+	} > "$tree/compare.txt"
+done
+
+printf '%-17s %20s %20s\n' "" before after
+paste -d '\n' "$1/compare.txt" "$2/compare.txt" | awk '
+	NR % 2 == 1 { label = substr($0, 1, 17); before = substr($0, 18); next }
+	{ printf "%-17s %20s %20s\n", label, before, substr($0, 18) }
+'
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <set>
+#include <map>
+#include <ctype.h>
+
+/*
+ * Generates "log_formats.h": IDs of the firmware's format strings, used by
+ * the binary log protocol (see APP_LOG_BINARY).
+ *
+ *	usage: gen_log_formats source... > ../log_formats.h
+ *
+ * Every F("...") string literal of the sources is collected. A string's ID
+ * is its hash, the firmware computes it from the string the same way, at
+ * compile time for LOG_* macros' strings. The first hash seed giving every
+ * string a distinct nonzero ID is chosen, so the firmware only needs the
+ * seed, while the decoder gets the whole table. ID 0 marks no string.
+ */
+
+namespace
+{
+	/*
+	 * Computes a format string's ID, must match format_id_next() in "format.h"
+	 */
+	uint16_t format_id(const std::string& format, uint16_t seed)
+	{
+		uint16_t id = seed;
+		for (size_t i = 0; i < format.size(); i++)
+		{
+			id = static_cast<uint16_t>((id ^ static_cast<uint8_t>(format[i])) * 0x6F4B);
+			id ^= id >> 7;
+		}
+		return id;
+	}
+
+	bool is_identifier(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+	}
+
+	/*
+	 * Parses a string literal's escape sequence, pos is past the backslash
+	 */
+	char parse_escape(const std::string& text, size_t& pos)
+	{
+		char c = text[pos++];
+		switch (c)
+		{
+		case 'n': return '\n';
+		case 'r': return '\r';
+		case 't': return '\t';
+		case 'x':
+		{
+			int value = 0;
+			while (pos < text.size() && isxdigit(static_cast<unsigned char>(text[pos])))
+			{
+				char d = text[pos++];
+				value = value * 16 + (isdigit(static_cast<unsigned char>(d)) ? d - '0' : (tolower(d) - 'a' + 10));
+			}
+			return static_cast<char>(value);
+		}
+		default:
+			if (c >= '0' && c <= '7')
+			{
+				int value = c - '0';
+				for (int i = 0; i < 2 && pos < text.size() && text[pos] >= '0' && text[pos] <= '7'; i++)
+				{
+					value = value * 8 + (text[pos++] - '0');
+				}
+				return static_cast<char>(value);
+			}
+			return c;
+		}
+	}
+
+	/*
+	 * Parses F()'s argument: one or more adjacent string literals, pos is past "F("
+	 */
+	bool parse_literal(const std::string& text, size_t& pos, std::string& value)
+	{
+		bool parsed = false;
+		while (true)
+		{
+			while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos])))
+			{
+				pos++;
+			}
+			if (pos >= text.size() || text[pos] != '"')
+			{
+				return parsed && pos < text.size() && text[pos] == ')';
+			}
+
+			pos++;
+			while (pos < text.size() && text[pos] != '"')
+			{
+				char c = text[pos++];
+				value += c == '\\' ? parse_escape(text, pos) : c;
+			}
+			pos++;
+			parsed = true;
+		}
+	}
+
+	/*
+	 * Collects F("...") strings of a source file
+	 */
+	bool scan(const char* path, std::set<std::string>& formats)
+	{
+		FILE* in = fopen(path, "rb");
+		if (in == NULL)
+		{
+			perror(path);
+			return false;
+		}
+
+		std::string text;
+		char chunk[4096];
+		size_t length;
+		while ((length = fread(chunk, 1, sizeof(chunk), in)) > 0)
+		{
+			text.append(chunk, length);
+		}
+		fclose(in);
+
+		for (size_t pos = text.find("F("); pos != std::string::npos; pos = text.find("F(", pos + 1))
+		{
+			if (pos > 0 && is_identifier(text[pos - 1]))
+			{
+				continue;
+			}
+
+			size_t end = pos + 2;
+			std::string value;
+			if (parse_literal(text, end, value))
+			{
+				formats.insert(value);
+			}
+		}
+		return true;
+	}
+
+	/*
+	 * Writes a string as a C string literal
+	 */
+	void print_literal(const std::string& value)
+	{
+		putchar('"');
+		for (size_t i = 0; i < value.size(); i++)
+		{
+			unsigned char c = value[i];
+			switch (c)
+			{
+			case '\t': fputs("\\t", stdout); break;
+			case '\n': fputs("\\n", stdout); break;
+			case '\r': fputs("\\r", stdout); break;
+			case '"': fputs("\\\"", stdout); break;
+			case '\\': fputs("\\\\", stdout); break;
+			default:
+				if (c < 0x20 || c >= 0x7F)
+				{
+					printf("\\%03o", c);
+				}
+				else
+				{
+					putchar(c);
+				}
+				break;
+			}
+		}
+		putchar('"');
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::set<std::string> formats;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!scan(argv[i], formats))
+		{
+			return 1;
+		}
+	}
+
+	// The first seed without ID collisions, ID 0 is reserved
+	uint32_t seed = 0;
+	std::map<uint16_t, std::string> table;
+	for (; seed <= 0xFFFF; seed++)
+	{
+		table.clear();
+		table[0] = std::string();
+		std::set<std::string>::const_iterator it = formats.begin();
+		for (; it != formats.end(); ++it)
+		{
+			if (!table.insert(std::make_pair(format_id(*it, seed), *it)).second)
+			{
+				break;
+			}
+		}
+		if (it == formats.end())
+		{
+			break;
+		}
+	}
+	if (seed > 0xFFFF)
+	{
+		fprintf(stderr, "no seed gives distinct IDs to %u format strings\n", static_cast<unsigned>(formats.size()));
+		return 1;
+	}
+
+	printf("#pragma once\n\n");
+	printf("/*\n");
+	printf(" * IDs of the firmware's format strings, used by the binary log protocol.\n");
+	printf(" * Generated by host/gen_log_formats.cpp, do not edit.\n");
+	printf(" */\n\n");
+
+	printf("/*\n");
+	printf(" * Format string ID hash seed, every format string has a distinct ID with it\n");
+	printf(" */\n");
+	printf("#define LOG_FORMAT_SEED 0x%04X\n\n", static_cast<unsigned>(seed));
+
+	printf("/*\n");
+	printf(" * Format strings by ID, for the log decoder\n");
+	printf(" */\n");
+	printf("#ifdef LOG_FORMAT_TABLE\n");
+	printf("static const struct\n{\n\tuint16_t id;\n\tconst char* format;\n} log_formats[] =\n{\n");
+	table.erase(0);
+	for (std::map<uint16_t, std::string>::const_iterator it = table.begin(); it != table.end(); ++it)
+	{
+		printf("\t{ 0x%04X, ", it->first);
+		print_literal(it->second);
+		printf(" },\n");
+	}
+	printf("};\n");
+	printf("#endif");
+
+	return 0;
+}
\ No newline at end of file
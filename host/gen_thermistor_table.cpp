@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <math.h>
+
+/*
+ * Generates "thermistor_table.h": thermistor's ADC reading to temperature
+ * lookup table, used by thermistor_sensor_node_t.
+ *
+ *	usage: gen_thermistor_table > ../thermistor_table.h
+ *
+ * Every 10-bit ADC reading is converted into thermistor's resistance and
+ * then into temperature by linear interpolation between the points below.
+ * Readings outside of the approximation range are marked as invalid.
+ */
+
+namespace
+{
+	/*
+	 * Thermistor voltage dividor resistor's resistance
+	 */
+	const double R_D = 1.0 * 1000;
+
+	/*
+	 * Thermistor's resistance at 25 Celsium degrees
+	 */
+	const double R_25 = 10.0 * 1000;
+
+	/*
+	 * Thermistor's approximation data: temperature and resistance relative to R_25
+	 */
+	const struct
+	{
+		double t;
+		double r;
+	} temperature_points[] =
+	{
+		{ -55.0, 121.46 },
+		{ -50.0, 84.439 },
+		{ -45.0, 59.243 },
+		{ -40.0, 41.938 },
+		{ -35.0, 29.947 },
+
+		{ -30.0, 21.567 },
+		{ -25.0, 15.641 },
+		{ -20.0, 11.466 },
+		{ -15.0, 8.451 },
+		{ -10.0, 6.2927 },
+
+		{  -5.0, 4.7077 },
+		{   0.0, 3.5563 },
+		{   5.0, 2.7119 },
+		{  10.0, 2.086  },
+		{  15.0, 1.6204 },
+
+		{  20.0, 1.2683 },
+		{  25.0, 1.0000 },
+		{  30.0, 0.7942 },
+		{  35.0, 0.63268 },
+
+		{  40.0, 0.5074 },
+		{  45.0, 0.41026 },
+		{  50.0, 0.33363 },
+		{  55.0, 0.27243 }
+	};
+
+	const int POINTS_COUNT = sizeof(temperature_points) / sizeof(temperature_points[0]);
+
+	const int ADC_RANGE = 1024;
+	const int INVALID = -32768;
+
+	/*
+	 * Converts an ADC reading into temperature, in hundredths of Celsius degree
+	 */
+	int convert(int a)
+	{
+		double a_t = a / 1023.0;
+		double k = R_D * (1.0 - a_t) / a_t / R_25;
+
+		if (a == 0 || k > temperature_points[0].r || k < temperature_points[POINTS_COUNT - 1].r)
+		{
+			return INVALID;
+		}
+
+		int i = 1;
+		while (temperature_points[i].r > k)
+		{
+			i++;
+		}
+
+		double slope = (temperature_points[i].t - temperature_points[i - 1].t) / (temperature_points[i].r - temperature_points[i - 1].r);
+		double t = temperature_points[i - 1].t + slope * (k - temperature_points[i - 1].r);
+		return static_cast<int>(lround(t * 100));
+	}
+}
+
+int main()
+{
+	printf("#pragma once\n");
+	printf("\n");
+	printf("#include \"Arduino.h\"\n");
+	printf("\n");
+	printf("/*\n");
+	printf(" * Thermistor's ADC reading to temperature lookup table, in hundredths of Celsius degree.\n");
+	printf(" * Generated by host/gen_thermistor_table.cpp, do not edit.\n");
+	printf(" */\n");
+	printf("\n");
+	printf("/*\n");
+	printf(" * A reading outside of thermistor's approximation range\n");
+	printf(" */\n");
+	printf("#define THERMISTOR_TABLE_INVALID ((int16_t)%d)\n", INVALID);
+	printf("\n");
+	printf("static const int16_t thermistor_table[%d] PROGMEM =\n", ADC_RANGE);
+	printf("{");
+
+	for (int a = 0; a < ADC_RANGE; a++)
+	{
+		printf(a % 8 == 0 ? "\n\t" : " ");
+		printf("%6d%s", convert(a), a + 1 < ADC_RANGE ? "," : "");
+	}
+
+	printf("\n};");
+	return 0;
+}
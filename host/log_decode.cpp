@@ -0,0 +1,350 @@
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "Arduino.h"
+#include "number_format.h"
+#define LOG_FORMAT_TABLE
+#include "log_formats.h"
+
+/*
+ * Binary log decoder: restores the text log from records the firmware
+ * sends if APP_LOG_BINARY is defined (see the record layout in "log.h").
+ *
+ *	usage: log_decode [serial.log]
+ *
+ * Reads the standard input if no file is given and writes the text log
+ * into the standard output, as the firmware would have sent it.
+ * Text is formatted by the same Print and number_format_t code the firmware uses.
+ */
+
+namespace
+{
+	const uint8_t LOG_TIME_FULL = 0x04;
+	const uint8_t LOG_ESCAPE = 0xDB;
+	const uint8_t LOG_ESCAPED_END = 0xDC;
+	const uint8_t LOG_ESCAPED_ESCAPE = 0xDD;
+
+	/*
+	 * Standard output printer
+	 */
+	class stdout_print_t : public Print
+	{
+	public:
+		virtual size_t write(uint8_t c)
+		{
+			return fputc(c, stdout) == EOF ? 0 : 1;
+		}
+		using Print::write;
+	};
+
+	stdout_print_t out;
+
+	/*
+	 * Unescaped record reader
+	 */
+	class record_t
+	{
+	public:
+		record_t(const std::string& bytes) : _bytes(bytes), _pos(0), _valid(true) { }
+
+		bool at_end() const { return _pos >= _bytes.size(); }
+		bool valid() const { return _valid; }
+
+		uint8_t byte()
+		{
+			if (at_end())
+			{
+				_valid = false;
+				return 0;
+			}
+			return _bytes[_pos++];
+		}
+
+		unsigned long bytes(uint8_t count)
+		{
+			unsigned long value = 0;
+			for (uint8_t i = 0; i < count; i++)
+			{
+				value |= static_cast<unsigned long>(byte()) << (8 * i);
+			}
+			return value;
+		}
+
+		long varint()
+		{
+			unsigned long value = 0;
+			uint8_t shift = 0;
+			uint8_t b;
+			do
+			{
+				b = byte();
+				value |= static_cast<unsigned long>(b & 0x7F) << shift;
+				shift += 7;
+			} while ((b & 0x80) && _valid);
+
+			return static_cast<long>(value >> 1) ^ -static_cast<long>(value & 1);
+		}
+
+		float real()
+		{
+			uint32_t bits = bytes(4);
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+	private:
+		const std::string& _bytes;
+		size_t _pos;
+		bool _valid;
+	};
+
+	/*
+	 * Millisecond timestamps' high half, tracked across records
+	 */
+	unsigned long time_high = 0;
+	uint16_t time_low = 0;
+
+	const char* find_format(uint16_t id)
+	{
+		for (size_t i = 0; i < sizeof(log_formats) / sizeof(log_formats[0]); i++)
+		{
+			if (log_formats[i].id == id)
+			{
+				return log_formats[i].format;
+			}
+		}
+		return NULL;
+	}
+
+	/*
+	 * Prints a global time the way log_t::print_time() does
+	 */
+	void print_time(uint8_t h, uint8_t min, uint8_t sec)
+	{
+		thermograph::number_format_t(h, 0, 2, '0').print(out);
+		out.print(':');
+		thermograph::number_format_t(min, 0, 2, '0').print(out);
+		out.print(':');
+		thermograph::number_format_t(sec, 0, 2, '0').print(out);
+	}
+
+	/*
+	 * Prints a local time the way log_t::print_time() does
+	 */
+	void print_time(uint16_t h, uint8_t min, uint8_t sec, uint16_t ms)
+	{
+		thermograph::number_format_t(h, 0, 4, ' ').print(out);
+		out.print(':');
+		thermograph::number_format_t(min, 0, 2, '0').print(out);
+		out.print(':');
+		thermograph::number_format_t(sec, 0, 2, '0').print(out);
+		out.print('.');
+		thermograph::number_format_t(ms, 0, 3, '0').print(out);
+	}
+
+	/*
+	 * Prints a record header the way log_t::print_header() does
+	 */
+	void print_header(record_t& record)
+	{
+		uint8_t header = record.byte();
+		unsigned long ms;
+		if (header & LOG_TIME_FULL)
+		{
+			ms = record.bytes(4);
+			time_high = ms >> 16;
+		}
+		else
+		{
+			uint16_t low = record.bytes(2);
+			if (low < time_low)
+			{
+				time_high++;
+			}
+			ms = time_high << 16 | low;
+		}
+		time_low = ms & 0xFFFF;
+
+		unsigned long sec = ms / 1000;
+		unsigned long min = sec / 60;
+		unsigned long h = min / 60;
+		print_time(h, min % 60, sec % 60, ms % 1000);
+		out.print('\t');
+		print_time(static_cast<uint8_t>(h), min % 60, sec % 60);
+		out.print('\t');
+
+		static const char* const levels[] = { "ERR", "INF", "DBG", "???" };
+		out.print(levels[header & 0x03]);
+		out.print('\t');
+	}
+
+	/*
+	 * Prints a format string with its arguments the way log_t::print_message() does
+	 */
+	bool print_message(record_t& record)
+	{
+		uint16_t id = record.bytes(2);
+		const char* format = find_format(id);
+		if (format == NULL)
+		{
+			printf("<unknown format 0x%04X>", id);
+			return false;
+		}
+
+		for (; *format != '\0'; format++)
+		{
+			if (*format != '%')
+			{
+				out.print(*format);
+				continue;
+			}
+
+			format++;
+			switch (*format)
+			{
+			case '\0':
+				return record.valid();
+			case '%':
+				out.print('%');
+				break;
+			case 's':
+				for (char c; (c = record.byte()) != '\0' && record.valid(); )
+				{
+					out.print(c);
+				}
+				break;
+			case 'd':
+			case 'i':
+			case 'l':
+			case 'c':
+				thermograph::number_format_t(record.varint()).print(out);
+				break;
+			case 'x':
+				out.print(static_cast<int>(record.varint()), HEX);
+				break;
+			case 'X':
+				out.print("0x");
+				out.print(static_cast<int>(record.varint()), HEX);
+				break;
+			case 'b':
+				out.print(static_cast<int>(record.varint()), BIN);
+				break;
+			case 'B':
+				out.print("0b");
+				out.print(static_cast<int>(record.varint()), BIN);
+				break;
+			case 't':
+				out.print(record.varint() == 1 ? "T" : "F");
+				break;
+			case 'T':
+				out.print(record.varint() == 1 ? "true" : "false");
+				break;
+			case 'u':
+			{
+				uint8_t h = record.byte();
+				uint8_t min = record.byte();
+				print_time(h, min, record.byte());
+				break;
+			}
+			case 'U':
+			{
+				uint16_t h = record.bytes(2);
+				uint8_t min = record.byte();
+				uint8_t sec = record.byte();
+				print_time(h, min, sec, record.bytes(2));
+				break;
+			}
+			case 'h':
+				thermograph::number_format_t(record.varint(), 2).print(out);
+				break;
+			case 'f':
+			case 'F':
+				out.print(record.real());
+				break;
+			case 'm':
+			{
+				uint16_t message = record.bytes(2);
+				const char* text = find_format(message);
+				if (text != NULL)
+				{
+					out.print(text);
+				}
+				else
+				{
+					printf("<unknown format 0x%04X>", message);
+				}
+				break;
+			}
+			default:
+				out.print(*format);
+				break;
+			}
+		}
+		return record.valid();
+	}
+
+	void decode(const std::string& bytes)
+	{
+		if (bytes.empty())
+		{
+			return;
+		}
+
+		record_t record(bytes);
+		print_header(record);
+		while (!record.at_end() && print_message(record))
+		{
+		}
+		if (!record.valid())
+		{
+			out.print("<truncated>");
+		}
+		out.println();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	FILE* in = stdin;
+	if (argc > 1)
+	{
+		in = fopen(argv[1], "rb");
+		if (in == NULL)
+		{
+			perror(argv[1]);
+			return 1;
+		}
+	}
+
+	std::string bytes;
+	bool escaped = false;
+	for (int c; (c = fgetc(in)) != EOF; )
+	{
+		if (c == '\n')
+		{
+			decode(bytes);
+			bytes.clear();
+			escaped = false;
+		}
+		else if (escaped)
+		{
+			bytes += static_cast<char>(c == LOG_ESCAPED_END ? '\n' : (c == LOG_ESCAPED_ESCAPE ? LOG_ESCAPE : c));
+			escaped = false;
+		}
+		else if (c == LOG_ESCAPE)
+		{
+			escaped = true;
+		}
+		else
+		{
+			bytes += static_cast<char>(c);
+		}
+	}
+
+	if (in != stdin)
+	{
+		fclose(in);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "Arduino.h"
+#include "sim.h"
+#include "_config.h"
+
+/*
+ * Host entry point: runs the firmware on the simulated board for a given
+ * amount of virtual time against a scripted environment.
+ *
+ *	usage: thermograph_sim [-d days] [-h hours] [-s serial.log] [-e eeprom.bin] [-q]
+ *
+ *	-d, -h	simulated run length (default: 7 days)
+ *	-s		file to capture serial output into, "-" for stdout
+ *	-e		EEPROM image, loaded before the run if it exists and saved after it
+ *	-q		don't print the final LCD picture
+ */
+
+namespace
+{
+	const double PI = 3.14159265358979323846;
+	const sim::usec_t SECOND = 1000000ULL;
+	const sim::usec_t MINUTE = 60 * SECOND;
+	const sim::usec_t HOUR = 60 * MINUTE;
+	const sim::usec_t DAY = 24 * HOUR;
+
+	double daily_wave(sim::usec_t now, double phase)
+	{
+		return sin(2 * PI * (static_cast<double>(now % DAY) / DAY + phase));
+	}
+
+	/*
+	 * Indoor climate: mild daily swing
+	 */
+	bool indoor_climate(sim::usec_t now, float& temperature, float& humidity)
+	{
+		temperature = 22.0 + 1.5 * daily_wave(now, 0.0);
+		humidity = 40.0 + 5.0 * daily_wave(now, 0.5);
+		return true;
+	}
+
+	/*
+	 * Outdoor climate: wide daily swing, the sensor drops off for an hour every 3rd day
+	 */
+	bool outdoor_climate(sim::usec_t now, float& temperature, float& humidity)
+	{
+		temperature = 8.0 + 6.0 * daily_wave(now, -0.25);
+		humidity = 70.0 + 15.0 * daily_wave(now, 0.25);
+		return (now % (3 * DAY)) < (3 * DAY - HOUR);
+	}
+
+	/*
+	 * Keypad on A0: SELECT every 7 minutes, LEFT every 11 minutes, UP every 13 minutes
+	 */
+	int keypad(uint8_t channel, sim::usec_t now)
+	{
+		const sim::usec_t PRESS = 300 * 1000;
+
+		if (now % (7 * MINUTE) < PRESS) return 640;
+		if (now % (11 * MINUTE) < PRESS) return 400;
+		if (now % (13 * MINUTE) < PRESS) return 100;
+
+		return 1023;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	sim::usec_t duration = 7 * DAY;
+	const char* serial_path = NULL;
+	const char* eeprom_path = NULL;
+	bool quiet = false;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "d:h:s:e:q")) != -1)
+	{
+		switch (opt)
+		{
+		case 'd':
+			duration = static_cast<sim::usec_t>(atof(optarg) * DAY);
+			break;
+		case 'h':
+			duration = static_cast<sim::usec_t>(atof(optarg) * HOUR);
+			break;
+		case 's':
+			serial_path = optarg;
+			break;
+		case 'e':
+			eeprom_path = optarg;
+			break;
+		case 'q':
+			quiet = true;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-d days] [-h hours] [-s serial.log] [-e eeprom.bin] [-q]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	FILE* serial_out = NULL;
+	if (serial_path != NULL)
+	{
+		serial_out = strcmp(serial_path, "-") == 0 ? stdout : fopen(serial_path, "w");
+		if (serial_out == NULL)
+		{
+			perror(serial_path);
+			return 1;
+		}
+	}
+
+	FILE* eeprom_in = eeprom_path != NULL ? fopen(eeprom_path, "rb") : NULL;
+	sim::load_eeprom(eeprom_in);
+	if (eeprom_in != NULL)
+	{
+		fclose(eeprom_in);
+	}
+
+	sim::set_serial_output(serial_out);
+	sim::set_analog_source(A0, keypad);
+	sim::attach_dht(APP_INDOOR_SENSOR_PORT, 11, indoor_climate);
+	sim::attach_dht(APP_OUTDOOR_SENSOR_PORT, 11, outdoor_climate);
+	sim::lcd().attach(LCD_RS_PORT, LCD_ENABLE_PORT, LCD_D0_PORT, LCD_D1_PORT, LCD_D2_PORT, LCD_D3_PORT);
+
+	clock_t wall_start = clock();
+
+	uint64_t iterations = 0;
+	setup();
+	while (sim::now() < duration)
+	{
+		loop();
+		iterations++;
+	}
+
+	double wall = static_cast<double>(clock() - wall_start) / CLOCKS_PER_SEC;
+
+	if (serial_out != NULL && serial_out != stdout)
+	{
+		fclose(serial_out);
+	}
+
+	if (eeprom_path != NULL)
+	{
+		FILE* eeprom_out = fopen(eeprom_path, "wb");
+		if (eeprom_out == NULL)
+		{
+			perror(eeprom_path);
+			return 1;
+		}
+		sim::save_eeprom(eeprom_out);
+		fclose(eeprom_out);
+	}
+
+	const sim::counters_t& c = sim::counters();
+	FILE* report = serial_out == stdout ? stderr : stdout;
+
+	if (!quiet)
+	{
+		sim::lcd().dump(report, LCD_WIDTH, LCD_HEIGHT);
+	}
+
+	double simulated = static_cast<double>(sim::now()) / SECOND;
+	fprintf(report, "simulated time   %.0f s\n", simulated);
+	fprintf(report, "host cpu time    %.3f s\n", wall);
+	fprintf(report, "loop iterations  %llu\n", static_cast<unsigned long long>(iterations));
+	fprintf(report, "busy time        %.1f %%\n", 100.0 * (sim::now() - c.delay_us) / sim::now());
+	fprintf(report, "serial bytes     %llu\n", static_cast<unsigned long long>(c.serial_bytes));
+	fprintf(report, "serial wait      %.3f s\n", static_cast<double>(c.serial_wait_us) / SECOND);
+	fprintf(report, "delay time       %.3f s\n", static_cast<double>(c.delay_us) / SECOND);
+	fprintf(report, "analog reads     %llu\n", static_cast<unsigned long long>(c.analog_reads));
+	fprintf(report, "adc conversions  %llu\n", static_cast<unsigned long long>(c.adc_conversions));
+	fprintf(report, "digital reads    %llu\n", static_cast<unsigned long long>(c.digital_reads));
+	fprintf(report, "digital writes   %llu\n", static_cast<unsigned long long>(c.digital_writes));
+	fprintf(report, "dht frames       %llu\n", static_cast<unsigned long long>(c.dht_frames));
+	fprintf(report, "lcd commands     %llu\n", static_cast<unsigned long long>(c.lcd_commands));
+	fprintf(report, "lcd data writes  %llu\n", static_cast<unsigned long long>(c.lcd_data));
+	fprintf(report, "eeprom reads     %llu\n", static_cast<unsigned long long>(c.eeprom_reads));
+	fprintf(report, "eeprom writes    %llu\n", static_cast<unsigned long long>(c.eeprom_writes));
+
+	return 0;
+}
\ No newline at end of file
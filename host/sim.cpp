@@ -0,0 +1,1051 @@
+#include <string.h>
+#include "Arduino.h"
+#include "avr/io.h"
+#include "avr/eeprom.h"
+#include "sim.h"
+
+/*
+ * Simulated Arduino Uno board for the host build.
+ */
+
+/*
+ * ADC conversion complete interrupt handler, if the firmware defines one
+ */
+extern "C" void ADC_vect(void) __attribute__((weak));
+
+/*
+ * USART data register empty interrupt handler, if the firmware defines one
+ */
+extern "C" void USART_UDRE_vect(void) __attribute__((weak));
+
+namespace
+{
+	/*
+	 * I/O cost model, in microseconds, for an ATmega328P at 16 MHz
+	 */
+	const sim::usec_t ANALOG_READ_COST  = 112;
+	const sim::usec_t DIGITAL_READ_COST = 4;
+	const sim::usec_t DIGITAL_WRITE_COST = 4;
+	const sim::usec_t ISR_COST = 4;
+
+	/*
+	 * EEPROM: a byte write takes 3.4 ms in the background,
+	 * eeprom_write_byte() and eeprom_read_byte() busy-wait for the previous one
+	 */
+	const sim::usec_t EEPROM_WRITE_COST = 3400;
+	const unsigned EEPROM_SIZE = E2END + 1;
+
+	/*
+	 * ADC: 13 clock conversion with /128 prescaler, Timer0 overflows every 1024 us
+	 */
+	const sim::usec_t ADC_CONVERSION = 104;
+	const sim::usec_t TIMER0_OVERFLOW = 1024;
+	const uint8_t ADC_TRIGGER_TIMER0_OVERFLOW = 4;
+
+	/*
+	 * Serial transmitter: 8N1 framing, 64 byte TX buffer
+	 */
+	const unsigned SERIAL_TX_BUFFER = 64;
+
+	const uint8_t PIN_COUNT = 20;
+	const uint8_t ADC_CHANNELS = 6;
+	const uint8_t MAX_DHT = 4;
+	const uint8_t EXTERNAL_INTERRUPTS = 2;
+	const uint8_t DHT_EDGES = 84;
+
+	/*
+	 * DHT response waveform timing, in microseconds since the host released the bus
+	 */
+	const sim::usec_t DHT_START_LOW   = 800;
+	const sim::usec_t DHT_RESPONSE    = 30;
+	const sim::usec_t DHT_ACK_LOW     = 80;
+	const sim::usec_t DHT_ACK_HIGH    = 80;
+	const sim::usec_t DHT_BIT_LOW     = 50;
+	const sim::usec_t DHT_BIT_0_HIGH  = 27;
+	const sim::usec_t DHT_BIT_1_HIGH  = 70;
+
+	struct dht_model_t
+	{
+		uint8_t pin;
+		uint8_t type;
+		sim::climate_source_t source;
+		sim::dht_fault_t fault;
+
+		/* time the host pulled the bus low, 0 if it didn't */
+		sim::usec_t low_since;
+
+		/* time the current response frame started, 0 if there's none */
+		sim::usec_t frame_start;
+		bool connected;
+		uint8_t frame[5];
+
+		/* data bits the response carries */
+		uint8_t bits;
+
+		/* bus level changes since frame start, and the next one to deliver */
+		sim::usec_t edges[DHT_EDGES];
+		uint8_t edge_count;
+		uint8_t edge_index;
+	};
+
+	struct interrupt_t
+	{
+		void (*isr)(void);
+		int mode;
+		uint8_t level;
+	};
+
+	sim::usec_t clock_us = 0;
+
+	uint8_t pin_modes[PIN_COUNT];
+	uint8_t pin_levels[PIN_COUNT];
+
+	sim::analog_source_t analog_sources[ADC_CHANNELS];
+
+	/* trigger time of the last auto-triggered conversion */
+	sim::usec_t adc_last_trigger = 0;
+
+	interrupt_t interrupts[EXTERNAL_INTERRUPTS];
+	bool interrupts_enabled = true;
+	bool in_isr = false;
+
+	dht_model_t dhts[MAX_DHT];
+	uint8_t dht_count = 0;
+
+	FILE* serial_out = NULL;
+	sim::usec_t serial_byte_time = 0;
+	sim::usec_t serial_tx_done = 0;
+
+	/* time the USART's transmitter finishes the bytes written into UDR0 */
+	sim::usec_t usart_tx_done = 0;
+
+	/* erased EEPROM cells read as 0xFF, see sim::load_eeprom() */
+	uint8_t eeprom[EEPROM_SIZE];
+
+	/* time the EEPROM's last write completes */
+	sim::usec_t eeprom_write_done = 0;
+
+	void eeprom_wait()
+	{
+		if (eeprom_write_done > clock_us)
+		{
+			sim::advance(eeprom_write_done - clock_us);
+		}
+	}
+
+	sim::hd44780_t lcd_model;
+	sim::counters_t io_counters;
+
+	dht_model_t* find_dht(uint8_t pin)
+	{
+		for (uint8_t i = 0; i < dht_count; i++)
+		{
+			if (dhts[i].pin == pin)
+			{
+				return &dhts[i];
+			}
+		}
+		return NULL;
+	}
+
+	/*
+	 * Builds a 40-bit DHT frame from the climate source
+	 */
+	void dht_start_frame(dht_model_t& dht)
+	{
+		float t = 0, h = 0;
+		dht.connected = dht.source(clock_us, t, h);
+		dht.frame_start = clock_us;
+		dht.edge_count = 0;
+		dht.edge_index = 0;
+		if (!dht.connected)
+		{
+			return;
+		}
+
+		if (dht.type == 11)
+		{
+			dht.frame[0] = static_cast<uint8_t>(constrain(h, 0.0f, 99.0f) + 0.5f);
+			dht.frame[1] = 0;
+			dht.frame[2] = static_cast<uint8_t>(constrain(t, 0.0f, 50.0f) + 0.5f);
+			dht.frame[3] = 0;
+		}
+		else
+		{
+			uint16_t hh = static_cast<uint16_t>(constrain(h, 0.0f, 99.9f) * 10 + 0.5f);
+			uint16_t tt = static_cast<uint16_t>(fabs(t) * 10 + 0.5f);
+			dht.frame[0] = hh >> 8;
+			dht.frame[1] = hh & 0xFF;
+			dht.frame[2] = ((tt >> 8) & 0x7F) | (t < 0 ? 0x80 : 0);
+			dht.frame[3] = tt & 0xFF;
+		}
+		dht.frame[4] = dht.frame[0] + dht.frame[1] + dht.frame[2] + dht.frame[3];
+		io_counters.dht_frames++;
+
+		dht.bits = dht.fault == sim::DHT_FAULT_TRUNCATE ? 20 : 40;
+		if (dht.fault == sim::DHT_FAULT_CHECKSUM)
+		{
+			dht.frame[3] ^= 0x01;
+		}
+
+		// Bus level changes: acknowledge, data bits, end of frame
+		sim::usec_t edge = DHT_RESPONSE;
+		uint8_t n = 0;
+		dht.edges[n++] = edge;
+		dht.edges[n++] = edge += DHT_ACK_LOW;
+		dht.edges[n++] = edge += DHT_ACK_HIGH;
+		for (uint8_t bit = 0; bit < dht.bits; bit++)
+		{
+			bool one = (dht.frame[bit / 8] >> (7 - bit % 8)) & 1;
+			dht.edges[n++] = edge += DHT_BIT_LOW;
+			dht.edges[n++] = edge += one ? DHT_BIT_1_HIGH : DHT_BIT_0_HIGH;
+		}
+		dht.edges[n++] = edge += DHT_BIT_LOW;
+		dht.edge_count = n;
+		dht.edge_index = 0;
+	}
+
+	/*
+	 * Gets the bus level driven by a DHT sensor
+	 */
+	int dht_level(const dht_model_t& dht)
+	{
+		if (dht.frame_start == 0 || !dht.connected)
+		{
+			return HIGH;
+		}
+
+		sim::usec_t t = clock_us - dht.frame_start;
+		if (t < DHT_RESPONSE) return HIGH;
+		t -= DHT_RESPONSE;
+		if (t < DHT_ACK_LOW) return LOW;
+		t -= DHT_ACK_LOW;
+		if (t < DHT_ACK_HIGH) return HIGH;
+		t -= DHT_ACK_HIGH;
+
+		for (uint8_t bit = 0; bit < dht.bits; bit++)
+		{
+			if (t < DHT_BIT_LOW) return LOW;
+			t -= DHT_BIT_LOW;
+
+			bool one = (dht.frame[bit / 8] >> (7 - bit % 8)) & 1;
+			sim::usec_t high = one ? DHT_BIT_1_HIGH : DHT_BIT_0_HIGH;
+			if (t < high) return HIGH;
+			t -= high;
+		}
+
+		if (t < DHT_BIT_LOW) return LOW;
+		return HIGH;
+	}
+
+	void dht_on_write(dht_model_t& dht, uint8_t mode, uint8_t level)
+	{
+		if (mode == OUTPUT && level == LOW)
+		{
+			if (dht.low_since == 0)
+			{
+				dht.low_since = clock_us;
+			}
+			dht.frame_start = 0;
+			dht.edge_count = 0;
+			return;
+		}
+
+		if (dht.low_since != 0 && clock_us - dht.low_since >= DHT_START_LOW)
+		{
+			// Host released the bus after a start signal
+			dht_start_frame(dht);
+		}
+		dht.low_since = 0;
+	}
+
+	/*
+	 * Gets a pin's bus level without I/O costs
+	 */
+	uint8_t bus_level(uint8_t pin)
+	{
+		if (pin_modes[pin] == OUTPUT)
+		{
+			return pin_levels[pin];
+		}
+
+		dht_model_t* dht = find_dht(pin);
+		if (dht != NULL)
+		{
+			return dht_level(*dht);
+		}
+
+		// Inputs are pulled up
+		return HIGH;
+	}
+
+	/*
+	 * Samples an analog input source
+	 */
+	int analog_sample(uint8_t channel)
+	{
+		if (channel >= ADC_CHANNELS || analog_sources[channel] == NULL)
+		{
+			return 1023;
+		}
+
+		return constrain(analog_sources[channel](channel, clock_us), 0, 1023);
+	}
+
+	/*
+	 * Gets the completion time of the next auto-triggered ADC conversion, 0 if there's none
+	 */
+	sim::usec_t adc_next_completion()
+	{
+		uint8_t enabled = _BV(ADEN) | _BV(ADATE);
+		if ((ADCSRA & enabled) != enabled || (ADCSRB & 0x07) != ADC_TRIGGER_TIMER0_OVERFLOW)
+		{
+			return 0;
+		}
+
+		// A conversion triggered by the last overflow may still be running
+		sim::usec_t trigger = clock_us / TIMER0_OVERFLOW * TIMER0_OVERFLOW;
+		if (trigger <= adc_last_trigger || trigger + ADC_CONVERSION < clock_us)
+		{
+			trigger += TIMER0_OVERFLOW;
+		}
+		return trigger + ADC_CONVERSION;
+	}
+
+	/*
+	 * Runs the ADC conversion complete interrupt handler if it's enabled and pending
+	 */
+	void adc_interrupt()
+	{
+		if (!(ADCSRA & _BV(ADIF)) || !(ADCSRA & _BV(ADIE)) || !interrupts_enabled || in_isr || ADC_vect == NULL)
+		{
+			return;
+		}
+
+		ADCSRA &= ~_BV(ADIF);
+		in_isr = true;
+		sim::advance(ISR_COST);
+		ADC_vect();
+		in_isr = false;
+	}
+
+	/*
+	 * Completes an auto-triggered ADC conversion
+	 */
+	void adc_complete()
+	{
+		adc_last_trigger = clock_us - ADC_CONVERSION;
+		ADC = analog_sample(ADMUX & 0x07);
+		ADCSRA |= _BV(ADIF);
+		io_counters.adc_conversions++;
+		adc_interrupt();
+	}
+
+	/*
+	 * Gets USART0's byte time from its baud rate registers, 8N1 framing at 16 MHz
+	 */
+	sim::usec_t usart_byte_time()
+	{
+		// baud = F_CPU / (U2X0 ? 8 : 16) / (UBRR0 + 1), 10 bits per byte
+		return (UCSR0A & _BV(U2X0) ? 5 : 10) * (static_cast<sim::usec_t>(UBRR0) + 1);
+	}
+
+	/*
+	 * Gets the time USART0's data register empty interrupt fires, 0 if it can't
+	 */
+	sim::usec_t usart_next_empty()
+	{
+		uint8_t enabled = _BV(TXEN0) | _BV(UDRIE0);
+		if ((UCSR0B & enabled) != enabled || !interrupts_enabled || in_isr || USART_UDRE_vect == NULL)
+		{
+			return 0;
+		}
+
+		// The shift register holds the byte being sent, UDR0 holds the next one
+		sim::usec_t byte_time = usart_byte_time();
+		return usart_tx_done > clock_us + byte_time ? usart_tx_done - byte_time : clock_us;
+	}
+
+	/*
+	 * Runs the USART data register empty interrupt handler if it's enabled and pending
+	 */
+	void usart_interrupt()
+	{
+		sim::usec_t t = usart_next_empty();
+		if (t == 0 || t > clock_us)
+		{
+			return;
+		}
+
+		in_isr = true;
+		sim::advance(ISR_COST);
+		USART_UDRE_vect();
+		in_isr = false;
+	}
+
+	/*
+	 * Fires an external interrupt if its pin's level has changed
+	 */
+	void sense(uint8_t pin)
+	{
+		int8_t irq = pin == 2 ? 0 : (pin == 3 ? 1 : -1);
+		if (irq < 0 || interrupts[irq].isr == NULL)
+		{
+			return;
+		}
+
+		interrupt_t& i = interrupts[irq];
+		uint8_t level = bus_level(pin);
+		if (level == i.level)
+		{
+			return;
+		}
+		i.level = level;
+
+		bool matches = i.mode == CHANGE || (i.mode == RISING && level == HIGH) || (i.mode == FALLING && level == LOW);
+		if (!matches || !interrupts_enabled || in_isr)
+		{
+			return;
+		}
+
+		in_isr = true;
+		sim::advance(ISR_COST);
+		i.isr();
+		in_isr = false;
+	}
+}
+
+/*
+ ************************************************************************
+ *	Arduino core stand-in
+ ************************************************************************
+ */
+
+HardwareSerial Serial;
+
+volatile uint8_t ADMUX;
+volatile uint8_t ADCSRA;
+volatile uint8_t ADCSRB;
+volatile uint8_t DIDR0;
+volatile uint16_t ADC;
+
+volatile uint8_t UCSR0A;
+volatile uint8_t UCSR0B;
+volatile uint8_t UCSR0C;
+volatile uint16_t UBRR0;
+udr_t UDR0;
+
+udr_t& udr_t::operator=(uint8_t value)
+{
+	io_counters.serial_bytes++;
+	if (serial_out != NULL)
+	{
+		fputc(value, serial_out);
+	}
+
+	if (usart_tx_done < clock_us)
+	{
+		usart_tx_done = clock_us;
+	}
+	usart_tx_done += usart_byte_time();
+	return *this;
+}
+
+sreg_t SREG;
+
+sreg_t::operator uint8_t() const
+{
+	return interrupts_enabled ? _BV(SREG_I) : 0;
+}
+
+sreg_t& sreg_t::operator=(uint8_t value)
+{
+	if (value & _BV(SREG_I))
+	{
+		sei();
+	}
+	else
+	{
+		cli();
+	}
+	return *this;
+}
+
+void cli()
+{
+	interrupts_enabled = false;
+}
+
+void sei()
+{
+	interrupts_enabled = true;
+	adc_interrupt();
+	usart_interrupt();
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode)
+{
+	if (interrupt >= EXTERNAL_INTERRUPTS)
+	{
+		return;
+	}
+
+	interrupts[interrupt].isr = isr;
+	interrupts[interrupt].mode = mode;
+	interrupts[interrupt].level = bus_level(interrupt == 0 ? 2 : 3);
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+	if (interrupt < EXTERNAL_INTERRUPTS)
+	{
+		interrupts[interrupt].isr = NULL;
+	}
+}
+
+unsigned long millis()
+{
+	return static_cast<unsigned long>(clock_us / 1000);
+}
+
+unsigned long micros()
+{
+	return static_cast<unsigned long>(clock_us);
+}
+
+void delay(unsigned long ms)
+{
+	io_counters.delay_us += ms * 1000ULL;
+	sim::advance(ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	io_counters.delay_us += us;
+	sim::advance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	if (pin >= PIN_COUNT)
+	{
+		return;
+	}
+
+	pin_modes[pin] = mode;
+
+	dht_model_t* dht = find_dht(pin);
+	if (dht != NULL)
+	{
+		dht_on_write(*dht, mode, pin_levels[pin]);
+	}
+
+	sense(pin);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	if (pin >= PIN_COUNT)
+	{
+		return;
+	}
+
+	io_counters.digital_writes++;
+	sim::advance(DIGITAL_WRITE_COST);
+
+	uint8_t level = value ? HIGH : LOW;
+	pin_levels[pin] = level;
+
+	dht_model_t* dht = find_dht(pin);
+	if (dht != NULL)
+	{
+		dht_on_write(*dht, pin_modes[pin], level);
+	}
+
+	lcd_model.on_pin(pin, level, pin_levels);
+	sense(pin);
+}
+
+int digitalRead(uint8_t pin)
+{
+	if (pin >= PIN_COUNT)
+	{
+		return LOW;
+	}
+
+	io_counters.digital_reads++;
+	sim::advance(DIGITAL_READ_COST);
+
+	return bus_level(pin);
+}
+
+int analogRead(uint8_t pin)
+{
+	if (pin >= A0)
+	{
+		pin -= A0;
+	}
+
+	io_counters.analog_reads++;
+	sim::advance(ANALOG_READ_COST);
+
+	return analog_sample(pin);
+}
+
+void analogReference(uint8_t mode)
+{ }
+
+uint8_t eeprom_read_byte(const uint8_t* addr)
+{
+	eeprom_wait();
+	io_counters.eeprom_reads++;
+	return eeprom[reinterpret_cast<uintptr_t>(addr) % EEPROM_SIZE];
+}
+
+void eeprom_write_byte(uint8_t* addr, uint8_t value)
+{
+	eeprom_wait();
+	io_counters.eeprom_writes++;
+	eeprom_write_done = clock_us + EEPROM_WRITE_COST;
+	eeprom[reinterpret_cast<uintptr_t>(addr) % EEPROM_SIZE] = value;
+}
+
+int eeprom_is_ready(void)
+{
+	return clock_us >= eeprom_write_done;
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+	// 8N1 framing, 10 bits per byte
+	serial_byte_time = 10000000ULL / baud;
+	serial_tx_done = clock_us;
+}
+
+void HardwareSerial::end()
+{
+	flush();
+}
+
+int HardwareSerial::available()
+{
+	return 0;
+}
+
+int HardwareSerial::read()
+{
+	return -1;
+}
+
+void HardwareSerial::flush()
+{
+	if (serial_tx_done > clock_us)
+	{
+		io_counters.serial_wait_us += serial_tx_done - clock_us;
+		sim::advance(serial_tx_done - clock_us);
+	}
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	io_counters.serial_bytes++;
+	if (serial_out != NULL)
+	{
+		fputc(c, serial_out);
+	}
+
+	if (serial_tx_done < clock_us)
+	{
+		serial_tx_done = clock_us;
+	}
+	serial_tx_done += serial_byte_time;
+
+	// Block while TX buffer is full
+	sim::usec_t buffered = SERIAL_TX_BUFFER * serial_byte_time;
+	if (serial_tx_done - clock_us > buffered)
+	{
+		sim::usec_t wait = serial_tx_done - clock_us - buffered;
+		io_counters.serial_wait_us += wait;
+		sim::advance(wait);
+	}
+
+	return 1;
+}
+
+/*
+ ************************************************************************
+ *	sim::hd44780_t
+ *	HD44780 LCD controller model
+ ************************************************************************
+ */
+
+sim::hd44780_t::hd44780_t()
+	: _attached(false), _four_bit(false), _has_high_nibble(false), _high_nibble(0),
+	  _two_lines(false), _increment(true), _display_on(false), _cgram_target(false), _address(0)
+{
+	memset(_ddram, ' ', sizeof(_ddram));
+	memset(_cgram, 0, sizeof(_cgram));
+}
+
+void sim::hd44780_t::attach(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7)
+{
+	_rs_pin = rs;
+	_enable_pin = enable;
+	_data_pins[0] = d4;
+	_data_pins[1] = d5;
+	_data_pins[2] = d6;
+	_data_pins[3] = d7;
+	_attached = true;
+}
+
+void sim::hd44780_t::on_pin(uint8_t pin, uint8_t level, const uint8_t* levels)
+{
+	static uint8_t last_enable = LOW;
+
+	if (!_attached || pin != _enable_pin)
+	{
+		return;
+	}
+
+	// The controller latches data on the falling edge of E
+	if (last_enable == HIGH && level == LOW)
+	{
+		uint8_t nibble = 0;
+		for (uint8_t i = 0; i < 4; i++)
+		{
+			nibble |= (levels[_data_pins[i]] ? 1 : 0) << i;
+		}
+		latch(levels[_rs_pin], nibble);
+	}
+	last_enable = level;
+}
+
+void sim::hd44780_t::latch(uint8_t rs, uint8_t nibble)
+{
+	if (!_four_bit)
+	{
+		// DB0-DB3 are not connected and read as zeros
+		if (rs)
+		{
+			data(nibble << 4);
+		}
+		else
+		{
+			command(nibble << 4);
+		}
+		return;
+	}
+
+	if (!_has_high_nibble)
+	{
+		_high_nibble = nibble;
+		_has_high_nibble = true;
+		return;
+	}
+
+	_has_high_nibble = false;
+	uint8_t value = (_high_nibble << 4) | nibble;
+	if (rs)
+	{
+		data(value);
+	}
+	else
+	{
+		command(value);
+	}
+}
+
+void sim::hd44780_t::command(uint8_t value)
+{
+	io_counters.lcd_commands++;
+
+	if (value & 0x80)
+	{
+		_address = value & 0x7F;
+		_cgram_target = false;
+	}
+	else if (value & 0x40)
+	{
+		_address = value & 0x3F;
+		_cgram_target = true;
+	}
+	else if (value & 0x20)
+	{
+		bool four_bit = !(value & 0x10);
+		if (four_bit != _four_bit)
+		{
+			_four_bit = four_bit;
+			_has_high_nibble = false;
+		}
+		_two_lines = value & 0x08;
+	}
+	else if (value & 0x10)
+	{
+		// Cursor or display shift, only cursor moves are modelled
+		if (!(value & 0x08))
+		{
+			_address += (value & 0x04) ? 1 : -1;
+		}
+	}
+	else if (value & 0x08)
+	{
+		_display_on = value & 0x04;
+	}
+	else if (value & 0x04)
+	{
+		_increment = value & 0x02;
+	}
+	else if (value & 0x02)
+	{
+		_address = 0;
+		_cgram_target = false;
+	}
+	else if (value & 0x01)
+	{
+		memset(_ddram, ' ', sizeof(_ddram));
+		_address = 0;
+		_increment = true;
+		_cgram_target = false;
+	}
+}
+
+void sim::hd44780_t::data(uint8_t value)
+{
+	io_counters.lcd_data++;
+
+	if (_cgram_target)
+	{
+		_cgram[_address & 0x3F] = value & 0x1F;
+		_address = (_address + (_increment ? 1 : -1)) & 0x3F;
+		return;
+	}
+
+	_ddram[_address & 0x7F] = value;
+	if (_increment)
+	{
+		_address++;
+		if (_two_lines && _address == 0x28) _address = 0x40;
+		if (_address >= 0x68) _address = 0x00;
+	}
+	else
+	{
+		_address--;
+	}
+	_address &= 0x7F;
+}
+
+uint8_t sim::hd44780_t::at(uint8_t col, uint8_t row) const
+{
+	return _ddram[(row ? 0x40 : 0x00) + col];
+}
+
+void sim::hd44780_t::dump(FILE* out, uint8_t cols, uint8_t rows) const
+{
+	bool has_custom = false;
+
+	fputc('+', out);
+	for (uint8_t c = 0; c < cols; c++) fputc('-', out);
+	fputs("+\n", out);
+	for (uint8_t r = 0; r < rows; r++)
+	{
+		fputc('|', out);
+		for (uint8_t c = 0; c < cols; c++)
+		{
+			uint8_t ch = _display_on ? at(c, r) : ' ';
+			if (ch < 0x10)
+			{
+				// CGRAM characters are shown as their slot numbers
+				fputc('0' + (ch & 0x07), out);
+				has_custom = true;
+			}
+			else if (ch == 0xDF)
+			{
+				fputc('o', out);
+			}
+			else if (ch < 0x20 || ch >= 0x7F)
+			{
+				fputc('?', out);
+			}
+			else
+			{
+				fputc(ch, out);
+			}
+		}
+		fputs("|\n", out);
+	}
+	fputc('+', out);
+	for (uint8_t c = 0; c < cols; c++) fputc('-', out);
+	fputs("+\n", out);
+
+	if (!has_custom)
+	{
+		return;
+	}
+
+	// CGRAM slots 0..3 over 4..7, the way LCDBitmap lays them out
+	for (uint8_t half = 0; half < 2; half++)
+	{
+		for (uint8_t line = 0; line < 8; line++)
+		{
+			for (uint8_t slot = half * 4; slot < half * 4 + 4; slot++)
+			{
+				uint8_t bits = _cgram[slot * 8 + line];
+				for (int8_t b = 4; b >= 0; b--)
+				{
+					fputc((bits >> b) & 1 ? '#' : '.', out);
+				}
+			}
+			fputc('\n', out);
+		}
+	}
+}
+
+/*
+ ************************************************************************
+ *	sim
+ *	Simulated board
+ ************************************************************************
+ */
+
+sim::usec_t sim::now()
+{
+	return clock_us;
+}
+
+void sim::advance(usec_t us)
+{
+	usec_t target = clock_us + us;
+
+	// Deliver bus level changes driven by sensors, ADC conversions and USART interrupts on the way
+	while (!in_isr)
+	{
+		dht_model_t* next = NULL;
+		usec_t next_time = 0;
+		bool usart = false;
+
+		usec_t adc_time = adc_next_completion();
+		if (adc_time != 0 && adc_time <= target)
+		{
+			next_time = adc_time;
+		}
+
+		usec_t usart_time = usart_next_empty();
+		if (usart_time != 0 && usart_time <= target && (next_time == 0 || usart_time < next_time))
+		{
+			next_time = usart_time;
+			usart = true;
+		}
+
+		for (uint8_t i = 0; i < dht_count; i++)
+		{
+			dht_model_t& dht = dhts[i];
+			if (dht.frame_start == 0 || dht.edge_index >= dht.edge_count)
+			{
+				continue;
+			}
+
+			usec_t t = dht.frame_start + dht.edges[dht.edge_index];
+			if (t <= target && (next_time == 0 || t < next_time))
+			{
+				next = &dht;
+				next_time = t;
+				usart = false;
+			}
+		}
+
+		if (next_time == 0)
+		{
+			break;
+		}
+
+		if (next_time > clock_us)
+		{
+			clock_us = next_time;
+		}
+
+		if (usart)
+		{
+			usart_interrupt();
+			continue;
+		}
+
+		if (next == NULL)
+		{
+			adc_complete();
+			continue;
+		}
+
+		next->edge_index++;
+		sense(next->pin);
+	}
+
+	if (clock_us < target)
+	{
+		clock_us = target;
+	}
+}
+
+void sim::set_analog_source(uint8_t channel, analog_source_t source)
+{
+	if (channel >= A0)
+	{
+		channel -= A0;
+	}
+	if (channel < ADC_CHANNELS)
+	{
+		analog_sources[channel] = source;
+	}
+}
+
+void sim::attach_dht(uint8_t pin, uint8_t type, climate_source_t source)
+{
+	if (dht_count >= MAX_DHT)
+	{
+		return;
+	}
+
+	dht_model_t& dht = dhts[dht_count++];
+	memset(&dht, 0, sizeof(dht));
+	dht.pin = pin;
+	dht.type = type;
+	dht.source = source;
+}
+
+void sim::set_dht_fault(uint8_t pin, dht_fault_t fault)
+{
+	dht_model_t* dht = find_dht(pin);
+	if (dht != NULL)
+	{
+		dht->fault = fault;
+	}
+}
+
+void sim::set_serial_output(FILE* out)
+{
+	serial_out = out;
+}
+
+void sim::load_eeprom(FILE* in)
+{
+	memset(eeprom, 0xFF, sizeof(eeprom));
+
+	if (in != NULL && fread(eeprom, 1, sizeof(eeprom), in) != sizeof(eeprom))
+	{
+		memset(eeprom, 0xFF, sizeof(eeprom));
+	}
+}
+
+void sim::save_eeprom(FILE* out)
+{
+	fwrite(eeprom, 1, sizeof(eeprom), out);
+}
+
+sim::hd44780_t& sim::lcd()
+{
+	return lcd_model;
+}
+
+const sim::counters_t& sim::counters()
+{
+	return io_counters;
+}
\ No newline at end of file
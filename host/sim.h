@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stdio.h>
+#include <inttypes.h>
+
+/*
+ * Simulated Arduino Uno board for the host build.
+ *
+ * All time is virtual: it only moves when firmware code waits (delay(),
+ * delayMicroseconds(), serial back-pressure) or performs an I/O call whose
+ * cost is modelled (analogRead(), digitalRead(), digitalWrite()). A run is
+ * therefore deterministic and independent of the host's speed.
+ *
+ * The EEPROM keeps its contents between runs if its image is loaded from
+ * and saved into a file, so reboots can be simulated by consecutive runs.
+ *
+ * The ADC's registers are modelled for Timer0 overflow auto-triggered
+ * conversions, completing into the ADC_vect interrupt handler.
+ * USART0's transmitter is modelled as UDR0 and a shift register, fed by
+ * the USART_UDRE_vect interrupt handler.
+ */
+namespace sim
+{
+	/**
+	 *	Virtual time, in microseconds
+	 **/
+	typedef uint64_t usec_t;
+
+	/**
+	 *	Analog input source, returns an ADC code in [0, 1023] range
+	 **/
+	typedef int (*analog_source_t)(uint8_t channel, usec_t now);
+
+	/**
+	 *	Climate source for a DHT sensor model
+	 *	@param		now			virtual time
+	 *	@param		temperature	temperature to report, in Celsium degrees
+	 *	@param		humidity	relative humidity to report, in percents
+	 *	@returns	false if the sensor is disconnected at the moment
+	 **/
+	typedef bool (*climate_source_t)(usec_t now, float& temperature, float& humidity);
+
+	/**
+	 *	Faults a DHT sensor model injects into its responses
+	 **/
+	enum dht_fault_t
+	{
+		/**
+		 *	Frames are sent intact
+		 **/
+		DHT_FAULT_NONE,
+
+		/**
+		 *	A data bit is flipped after the checksum is computed
+		 **/
+		DHT_FAULT_CHECKSUM,
+
+		/**
+		 *	The sensor stops sending halfway through the data bits
+		 **/
+		DHT_FAULT_TRUNCATE
+	};
+
+	/**
+	 *	Simulated board's I/O counters
+	 **/
+	struct counters_t
+	{
+		uint64_t analog_reads;
+		uint64_t adc_conversions;
+		uint64_t digital_reads;
+		uint64_t digital_writes;
+		uint64_t serial_bytes;
+		uint64_t serial_wait_us;
+		uint64_t delay_us;
+		uint64_t dht_frames;
+		uint64_t lcd_commands;
+		uint64_t lcd_data;
+		uint64_t eeprom_reads;
+		uint64_t eeprom_writes;
+	};
+
+	/**
+	 *	HD44780 LCD controller model, wired in 4-bit mode
+	 **/
+	class hd44780_t
+	{
+	public:
+		hd44780_t();
+
+		/**
+		 *	Connects the model to the board's pins
+		 **/
+		void attach(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7);
+
+		/**
+		 *	Handles a pin level change
+		 **/
+		void on_pin(uint8_t pin, uint8_t level, const uint8_t* levels);
+
+		/**
+		 *	Gets a DDRAM character displayed at specified position
+		 **/
+		uint8_t at(uint8_t col, uint8_t row) const;
+
+		/**
+		 *	Writes a picture of the display into a file
+		 **/
+		void dump(FILE* out, uint8_t cols, uint8_t rows) const;
+
+	private:
+		void latch(uint8_t rs, uint8_t nibble);
+		void command(uint8_t value);
+		void data(uint8_t value);
+
+		bool _attached;
+		uint8_t _rs_pin, _enable_pin, _data_pins[4];
+
+		bool _four_bit;
+		bool _has_high_nibble;
+		uint8_t _high_nibble;
+
+		bool _two_lines;
+		bool _increment;
+		bool _display_on;
+		bool _cgram_target;
+		uint8_t _address;
+
+		uint8_t _ddram[0x80];
+		uint8_t _cgram[0x40];
+	};
+
+	/**
+	 *	Gets current virtual time
+	 **/
+	usec_t now();
+
+	/**
+	 *	Moves virtual time forward
+	 **/
+	void advance(usec_t us);
+
+	/**
+	 *	Assigns an analog input source to an ADC channel
+	 **/
+	void set_analog_source(uint8_t channel, analog_source_t source);
+
+	/**
+	 *	Connects a DHT11/DHT22 sensor model to a pin
+	 *	@param	pin		data pin
+	 *	@param	type	11 for DHT11, 22 for DHT22
+	 *	@param	source	climate source
+	 **/
+	void attach_dht(uint8_t pin, uint8_t type, climate_source_t source);
+
+	/**
+	 *	Makes a DHT sensor model inject a fault into its following responses
+	 *	@param	pin		data pin the model is connected to
+	 *	@param	fault	fault to inject, DHT_FAULT_NONE restores intact responses
+	 **/
+	void set_dht_fault(uint8_t pin, dht_fault_t fault);
+
+	/**
+	 *	Sets a file to capture serial output into, NULL discards it
+	 **/
+	void set_serial_output(FILE* out);
+
+	/**
+	 *	Loads the EEPROM image from a file, NULL or a short file erases the EEPROM
+	 **/
+	void load_eeprom(FILE* in);
+
+	/**
+	 *	Writes the EEPROM image into a file
+	 **/
+	void save_eeprom(FILE* out);
+
+	/**
+	 *	Gets the LCD model
+	 **/
+	hd44780_t& lcd();
+
+	/**
+	 *	Gets the board's I/O counters
+	 **/
+	const counters_t& counters();
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include "Arduino.h"
+#include "sim.h"
+#include "DHT.h"
+
+/*
+ * DHT driver test: decodes frames the simulated sensors send as timed bus
+ * edges, including the ones the driver must reject.
+ *
+ *	usage: test_dht
+ *
+ * Prints a line per check and exits with the number of failed checks.
+ */
+
+namespace
+{
+	const uint8_t DHT11_PIN = 2;
+	const uint8_t DHT22_PIN = 3;
+
+	/*
+	 * Transaction's time limit: start signal, response and some slack, in ms
+	 */
+	const unsigned long TRANSACTION_LIMIT = 100;
+
+	/*
+	 * Virtual time a non-blocking call may take, in us
+	 */
+	const sim::usec_t CALL_LIMIT = 50;
+
+	int failures = 0;
+
+	float climate_temperature;
+	float climate_humidity;
+	bool climate_connected;
+
+	bool climate(sim::usec_t now, float& temperature, float& humidity)
+	{
+		temperature = climate_temperature;
+		humidity = climate_humidity;
+		return climate_connected;
+	}
+
+	void set_climate(float temperature, float humidity, bool connected)
+	{
+		climate_temperature = temperature;
+		climate_humidity = humidity;
+		climate_connected = connected;
+	}
+
+	void check(bool passed, const char* what)
+	{
+		printf("%s\t%s\n", passed ? "ok" : "FAIL", what);
+		if (!passed)
+		{
+			failures++;
+		}
+	}
+
+	/*
+	 * Runs a transaction to its end, polling the driver every millisecond
+	 */
+	bool transact(DHT& dht, DHTFrame& frame)
+	{
+		// Keep transactions apart by the sensor's min interval
+		delay(DHT_MIN_INTERVAL);
+
+		sim::usec_t before = sim::now();
+		bool started = dht.start();
+		check(sim::now() - before <= CALL_LIMIT, "start() returns at once");
+		if (!started)
+		{
+			return false;
+		}
+
+		sim::usec_t slowest = 0;
+		for (unsigned long ms = 0; ms < TRANSACTION_LIMIT && !dht.complete(); ms++)
+		{
+			sim::advance(1000);
+
+			before = sim::now();
+			dht.poll();
+			if (sim::now() - before > slowest)
+			{
+				slowest = sim::now() - before;
+			}
+		}
+		check(slowest <= CALL_LIMIT, "poll() returns at once");
+
+		return dht.read(frame);
+	}
+
+	void test_dht11(DHT& dht)
+	{
+		DHTFrame frame;
+		set_climate(23.0f, 45.0f, true);
+		check(transact(dht, frame), "DHT11 transaction completes");
+		check(frame.status == DHT_FRAME_OK, "DHT11 frame is accepted");
+		check(frame.temperature == 2300, "DHT11 temperature is 23.00 C");
+		check(frame.humidity == 4500, "DHT11 humidity is 45.00 %");
+		check(!dht.complete(), "read() consumes the transaction");
+	}
+
+	void test_dht22(DHT& dht)
+	{
+		DHTFrame frame;
+		set_climate(21.7f, 61.3f, true);
+		check(transact(dht, frame), "DHT22 transaction completes");
+		check(frame.status == DHT_FRAME_OK, "DHT22 frame is accepted");
+		check(frame.temperature == 2170, "DHT22 temperature is 21.70 C");
+		check(frame.humidity == 6130, "DHT22 humidity is 61.30 %");
+
+		set_climate(-5.3f, 88.8f, true);
+		check(transact(dht, frame), "DHT22 transaction below zero completes");
+		check(frame.status == DHT_FRAME_OK, "DHT22 frame below zero is accepted");
+		check(frame.temperature == -530, "DHT22 temperature is -5.30 C");
+		check(frame.humidity == 8880, "DHT22 humidity is 88.80 %");
+	}
+
+	void test_checksum(DHT& dht)
+	{
+		DHTFrame frame;
+		set_climate(23.0f, 45.0f, true);
+		sim::set_dht_fault(DHT11_PIN, sim::DHT_FAULT_CHECKSUM);
+		check(transact(dht, frame), "corrupted transaction completes");
+		check(frame.status == DHT_FRAME_CHECKSUM, "corrupted frame fails the checksum");
+		check(frame.temperature == 0 && frame.humidity == 0, "corrupted frame reports no values");
+
+		sim::set_dht_fault(DHT11_PIN, sim::DHT_FAULT_NONE);
+		check(transact(dht, frame) && frame.status == DHT_FRAME_OK, "next intact frame is accepted");
+	}
+
+	void test_timeout(DHT& dht)
+	{
+		DHTFrame frame;
+		set_climate(23.0f, 45.0f, false);
+		check(transact(dht, frame), "unanswered transaction completes");
+		check(frame.status == DHT_FRAME_TIMEOUT, "unanswered transaction times out");
+
+		set_climate(23.0f, 45.0f, true);
+		sim::set_dht_fault(DHT11_PIN, sim::DHT_FAULT_TRUNCATE);
+		check(transact(dht, frame), "truncated transaction completes");
+		check(frame.status == DHT_FRAME_TIMEOUT, "truncated frame times out");
+		check(frame.temperature == 0 && frame.humidity == 0, "truncated frame reports no values");
+
+		sim::set_dht_fault(DHT11_PIN, sim::DHT_FAULT_NONE);
+		check(transact(dht, frame) && frame.status == DHT_FRAME_OK, "next intact frame is accepted");
+	}
+
+	void test_interval(DHT& dht)
+	{
+		DHTFrame frame;
+		set_climate(23.0f, 45.0f, true);
+		check(transact(dht, frame), "transaction completes");
+		check(!dht.start(), "start() is refused within the min interval");
+
+		delay(DHT_MIN_INTERVAL);
+		check(dht.start(), "start() is accepted after the min interval");
+		check(!dht.start(), "start() is refused while a transaction runs");
+		check(!dht.read(frame), "read() is refused while a transaction runs");
+		while (!dht.complete())
+		{
+			sim::advance(1000);
+			dht.poll();
+		}
+		check(dht.read(frame) && frame.status == DHT_FRAME_OK, "transaction completes after the refusals");
+	}
+}
+
+int main()
+{
+	sim::attach_dht(DHT11_PIN, DHT11, climate);
+	sim::attach_dht(DHT22_PIN, DHT22, climate);
+
+	DHT dht11(DHT11_PIN, DHT11);
+	DHT dht22(DHT22_PIN, DHT22);
+	dht11.begin();
+	dht22.begin();
+
+	test_dht11(dht11);
+	test_dht22(dht22);
+	test_checksum(dht11);
+	test_timeout(dht11);
+	test_interval(dht11);
+
+	printf("%d failed\n", failures);
+	return failures;
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <string.h>
+#include <avr/eeprom.h>
+#include "Arduino.h"
+#include "sim.h"
+#include "eeprom_log.h"
+
+using namespace thermograph;
+
+/*
+ * EEPROM record log test: records written before a simulated reboot must
+ * be replayed oldest first by a new log instance, after the log wrapped
+ * around and with records torn by a power loss or corrupted in place.
+ *
+ *	usage: test_eeprom_log
+ *
+ * Prints a line per check and exits with the number of failed checks.
+ */
+
+namespace
+{
+	/*
+	 * A log area of 5 records
+	 */
+	const uint16_t ADDRESS = 64;
+	const uint16_t SLOTS = 5;
+	const uint16_t LENGTH = SLOTS * eeprom_log_t::RECORD_SIZE;
+
+	int failures = 0;
+
+	void check(bool passed, const char* what)
+	{
+		printf("%s\t%s\n", passed ? "ok" : "FAIL", what);
+		if (!passed)
+		{
+			failures++;
+		}
+	}
+
+	/*
+	 * Starts a log on a freshly booted board, the EEPROM keeps its contents
+	 */
+	struct boot_t
+	{
+		eeprom_log_t log;
+
+		boot_t() : log(ADDRESS, LENGTH)
+		{
+			log.init();
+		}
+
+		/*
+		 * Appends a record whose payload is its number, writes all of it or some bytes only
+		 */
+		void append(uint8_t n, uint8_t bytes = eeprom_log_t::RECORD_SIZE)
+		{
+			uint8_t payload[eeprom_log_t::PAYLOAD];
+			memset(payload, n, sizeof(payload));
+			log.append(payload);
+
+			// A byte per poll at most, an EEPROM write takes 3.4 ms
+			for (uint8_t polls = 0; log.busy() && polls < bytes; polls++)
+			{
+				log.poll();
+				sim::advance(4000);
+			}
+		}
+
+		/*
+		 * Replays the log, compares the records' numbers, oldest first, with the expected ones
+		 */
+		bool replays(const uint8_t* expected, uint8_t count)
+		{
+			eeprom_log_t::reader_t reader(log);
+			uint8_t payload[eeprom_log_t::PAYLOAD];
+			uint8_t read = 0;
+			bool passed = true;
+			while (reader.next(payload))
+			{
+				uint8_t intact[eeprom_log_t::PAYLOAD];
+				memset(intact, payload[0], sizeof(intact));
+				passed = passed && read < count && payload[0] == expected[read] && memcmp(payload, intact, sizeof(intact)) == 0;
+				read++;
+			}
+			return passed && read == count;
+		}
+	};
+
+	/*
+	 * Flips a bit of a slot's byte in place
+	 */
+	void corrupt(uint16_t slot, uint8_t offset)
+	{
+		uint8_t* cell = reinterpret_cast<uint8_t*>(ADDRESS + slot * eeprom_log_t::RECORD_SIZE + offset);
+		eeprom_write_byte(cell, eeprom_read_byte(cell) ^ 0x10);
+	}
+
+	void test_empty()
+	{
+		sim::load_eeprom(NULL);
+		boot_t boot;
+		check(boot.log.get_capacity() == SLOTS, "the area fits whole records only");
+		check(boot.replays(NULL, 0), "an erased area replays nothing");
+	}
+
+	void test_reboot()
+	{
+		sim::load_eeprom(NULL);
+		{
+			boot_t boot;
+			boot.append(1);
+			boot.append(2);
+			boot.append(3);
+		}
+
+		boot_t boot;
+		const uint8_t expected[] = { 1, 2, 3 };
+		check(boot.replays(expected, 3), "records replay in order after a reboot");
+	}
+
+	void test_wrap_around()
+	{
+		sim::load_eeprom(NULL);
+		{
+			boot_t boot;
+			for (uint8_t n = 1; n <= 12; n++)
+			{
+				boot.append(n);
+			}
+		}
+
+		{
+			boot_t boot;
+			const uint8_t expected[] = { 8, 9, 10, 11, 12 };
+			check(boot.replays(expected, 5), "the newest records replay in order after the log wrapped around");
+			boot.append(13);
+		}
+
+		boot_t boot;
+		const uint8_t expected[] = { 9, 10, 11, 12, 13 };
+		check(boot.replays(expected, 5), "a record appended after a reboot continues the sequence");
+	}
+
+	void test_torn()
+	{
+		sim::load_eeprom(NULL);
+		{
+			boot_t boot;
+			for (uint8_t n = 1; n <= 7; n++)
+			{
+				boot.append(n);
+			}
+
+			// Power is lost while the 8th record overwrites the 3rd one
+			boot.append(8, 6);
+		}
+
+		{
+			boot_t boot;
+			const uint8_t expected[] = { 4, 5, 6, 7 };
+			check(boot.replays(expected, 4), "a torn record is skipped, the ones around it replay");
+			boot.append(9);
+		}
+
+		boot_t boot;
+		const uint8_t expected[] = { 4, 5, 6, 7, 9 };
+		check(boot.replays(expected, 5), "the next record takes the torn record's slot");
+	}
+
+	void test_corrupt()
+	{
+		sim::load_eeprom(NULL);
+		{
+			boot_t boot;
+			for (uint8_t n = 1; n <= 4; n++)
+			{
+				boot.append(n);
+			}
+		}
+
+		// The 2nd record's payload and the 3rd record's sequence number go bad
+		corrupt(1, 5);
+		corrupt(2, 0);
+
+		{
+			boot_t boot;
+			const uint8_t expected[] = { 1, 4 };
+			check(boot.replays(expected, 2), "records failing their CRC are skipped");
+			boot.append(5);
+		}
+
+		boot_t boot;
+		const uint8_t expected[] = { 1, 4, 5 };
+		check(boot.replays(expected, 3), "the newest record is found past the corrupt ones");
+	}
+}
+
+int main()
+{
+	test_empty();
+	test_reboot();
+	test_wrap_around();
+	test_torn();
+	test_corrupt();
+
+	printf("%d failed\n", failures);
+	return failures;
+}
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <string.h>
+#include "Arduino.h"
+#include "format.h"
+
+using namespace thermograph;
+
+/*
+ * Log message formatter test: format strings must print their arguments
+ * per the format table in "log.h", and FORMAT_CHECK must accept the
+ * argument types the conversions take only.
+ *
+ *	usage: test_format
+ *
+ * Prints a line per check and exits with the number of failed checks.
+ *
+ * Compiled with -DFORMAT_MISMATCH=n, the n-th mismatched format string
+ * below must fail to compile; the Makefile compiles each of them first.
+ */
+
+namespace
+{
+	enum mode_t { MODE_OFF, MODE_ON };
+
+	struct point_t { int x, y; };
+
+	const thermograph::time_t global = { 7, 5, 9 };
+	const sys_time_t local = { 12, 34, 56, 78 };
+
+	/*
+	 * Matching format strings compile
+	 */
+	FORMAT_CHECK("%d %i %x %X %b %B %c %t %T", 1, 2, 3, 4, 5, 6, 'c', true, false);
+	FORMAT_CHECK("%l %h %l %h", 1L, 2L, 3, static_cast<int16_t>(4));
+	FORMAT_CHECK("%f %F", 1.0f, 2.0);
+	FORMAT_CHECK("%s %s", "literal", static_cast<const char*>("pointer"));
+	FORMAT_CHECK("%u %U", global, local);
+	FORMAT_CHECK("%d", MODE_ON);
+	FORMAT_CHECK("100%% %d%%", 1);
+	FORMAT_CHECK("no conversions");
+
+#if FORMAT_MISMATCH == 1
+	FORMAT_CHECK("%d", 1L);
+#elif FORMAT_MISMATCH == 2
+	FORMAT_CHECK("%s", 1);
+#elif FORMAT_MISMATCH == 3
+	FORMAT_CHECK("%d", 1.0f);
+#elif FORMAT_MISMATCH == 4
+	FORMAT_CHECK("%f", 1);
+#elif FORMAT_MISMATCH == 5
+	FORMAT_CHECK("%u", local);
+#elif FORMAT_MISMATCH == 6
+	FORMAT_CHECK("%d %d", 1);
+#elif FORMAT_MISMATCH == 7
+	FORMAT_CHECK("%d", 1, 2);
+#elif FORMAT_MISMATCH == 8
+	FORMAT_CHECK("%q", 1);
+#elif FORMAT_MISMATCH == 9
+	FORMAT_CHECK("%m", "not an F() string");
+#elif FORMAT_MISMATCH == 10
+	FORMAT_CHECK("%d", point_t());
+#endif
+
+	int failures = 0;
+
+	void check(bool passed, const char* what)
+	{
+		printf("%s\t%s\n", passed ? "ok" : "FAIL", what);
+		if (!passed)
+		{
+			failures++;
+		}
+	}
+
+	/*
+	 * Printer that keeps the text of its last message
+	 */
+	class sink_t : public Print
+	{
+	public:
+		sink_t() : _length(0) { }
+
+		virtual size_t write(uint8_t c)
+		{
+			if (_length < sizeof(_text) - 1)
+			{
+				_text[_length++] = c;
+			}
+			return 1;
+		}
+
+		void clear() { _length = 0; }
+
+		const char* text() { _text[_length] = '\0'; return _text; }
+
+	private:
+		char _text[128];
+		size_t _length;
+	};
+
+	/*
+	 * Formats a message the way the log does, compares it with the expected text
+	 */
+	template<typename... A>
+	bool formats(const char* expected, const char* format, A... args)
+	{
+		const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+		sink_t sink;
+		format_message(sink, format, false, list);
+		if (strcmp(sink.text(), expected) != 0)
+		{
+			printf("\t\"%s\" printed \"%s\"\n", format, sink.text());
+			return false;
+		}
+		return true;
+	}
+
+	void test_integers()
+	{
+		check(formats("0 -1 32767", "%d %i %d", 0, -1, 32767), "integers print in decimal");
+		check(formats("-2147483648 2147483647", "%l %l", -2147483647L - 1, 2147483647L), "longs print in decimal");
+		check(formats("FF 0x1F 101 0b11", "%x %X %b %B", 255, 31, 5, 3), "integers print in hex and binary, with prefixes");
+		check(formats("T F true false", "%t %t %T %T", true, false, true, false), "booleans print as letters and words");
+		check(formats("1", "%d", MODE_ON), "enumerations print as integers");
+	}
+
+	void test_fixed_point()
+	{
+		check(formats("21.50 0.00", "%h %h", 2150, 0), "hundredths print with two decimals");
+		check(formats("-0.05 -12.34", "%h %h", -5, -1234L), "negative hundredths keep their sign below one");
+		check(formats("1.50 -2.25", "%f %F", 1.5f, -2.25), "floats print with two decimals");
+	}
+
+	void test_text_and_times()
+	{
+		char buffer[] = "buffer";
+		check(formats("literal buffer", "%s %s", "literal", buffer), "strings print as is");
+		check(formats("07:05:09", "%u", global), "global time prints as hh:mm:ss");
+		check(formats("  12:34:56.078", "%U", local), "local time prints as hhhh:mm:ss.mmm");
+		check(formats("sensor #2: 21.50 at 07:05:09", "sensor #%d: %h at %u", 2, 2150, global), "text around conversions prints as is");
+		check(formats("100% 5%", "100%% %d%%", 5), "%% prints a percent sign");
+	}
+
+	void test_mismatches()
+	{
+		check(formats("? 2", "%s %d", 1, 2), "an argument not fitting its conversion prints '?' and is skipped");
+		check(formats("1 ?", "%d %d", 1), "a conversion past the arguments prints '?'");
+		check(formats("1", "%d", 1, 2), "arguments past the conversions are ignored");
+		check(formats("1", "%d%", 1), "a trailing '%' is dropped");
+	}
+}
+
+int main()
+{
+	test_integers();
+	test_fixed_point();
+	test_text_and_times();
+	test_mismatches();
+
+	printf("%d failed\n", failures);
+	return failures;
+}
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include "Arduino.h"
+#include "sim.h"
+#include "data_history.h"
+
+using namespace thermograph;
+
+/*
+ * Measurement history test: bucket times derived from slots, around the
+ * history's origin and the global time's wrap-around, and time range
+ * aggregates over the finest tier, gaps included.
+ *
+ *	usage: test_history
+ *
+ * Prints a line per check and exits with the number of failed checks.
+ */
+
+namespace
+{
+	const sensor_id SENSOR = 0;
+
+	int failures = 0;
+
+	void check(bool passed, const char* what)
+	{
+		printf("%s\t%s\n", passed ? "ok" : "FAIL", what);
+		if (!passed)
+		{
+			failures++;
+		}
+	}
+
+	/*
+	 * Global time period, global time wraps around after 256 hours
+	 */
+	const long TIME_PERIOD = 256L * 3600;
+
+	thermograph::time_t at(uint8_t h, uint8_t min, uint8_t sec)
+	{
+		thermograph::time_t time = { h, min, sec };
+		return time;
+	}
+
+	/*
+	 * Moves a global time by a number of seconds, either way
+	 */
+	thermograph::time_t shifted(const thermograph::time_t& time, long sec)
+	{
+		sec = ((time.h * 3600L + time.min * 60 + time.sec + sec) % TIME_PERIOD + TIME_PERIOD) % TIME_PERIOD;
+		return at(sec / 3600, sec / 60 % 60, sec % 60);
+	}
+
+	bool same(const thermograph::time_t& a, const thermograph::time_t& b)
+	{
+		return a.h == b.h && a.min == b.min && a.sec == b.sec;
+	}
+
+	/*
+	 * Starts a history at a time and closes a number of finest buckets, one per interval
+	 */
+	void start(data_history_t& history, const thermograph::time_t& time, int buckets)
+	{
+		history.advance(SENSOR, time);
+		for (int i = 1; i <= buckets; i++)
+		{
+			history.advance(SENSOR, shifted(time, i * APP_HISTORY_INTERVAL));
+		}
+	}
+
+	void test_get_time()
+	{
+		data_history_t history;
+		thermograph::time_t origin = at(10, 0, 0);
+		start(history, origin, 2);
+		check(same(history.get_time(SENSOR, 0, 0), shifted(origin, APP_HISTORY_INTERVAL)), "newest bucket started an interval ago");
+		check(same(history.get_time(SENSOR, 0, 1), origin), "oldest bucket started at the origin");
+		check(same(history.get_time(SENSOR, 0, 2), shifted(origin, -APP_HISTORY_INTERVAL)), "bucket before the origin is an interval earlier");
+		check(same(history.get_time(SENSOR, 1, 0), shifted(origin, -static_cast<long>(data_history_t::get_interval(1)))), "coarse bucket before the origin is a span earlier");
+	}
+
+	void test_get_time_wrap()
+	{
+		data_history_t history;
+		thermograph::time_t origin = at(0, 0, 0);
+		start(history, origin, 1);
+		check(same(history.get_time(SENSOR, 0, 0), origin), "newest bucket started at the origin");
+		check(same(history.get_time(SENSOR, 0, 5), at(255, 55, 0)), "bucket before the origin wraps around to hour 255");
+	}
+
+	/*
+	 * Query results receiver which keeps them
+	 */
+	class collector_t : public history_visitor_t
+	{
+	public:
+		history_aggregate_t results[8];
+		int count;
+
+		collector_t() : count(0) { }
+
+		virtual void visit(const history_aggregate_t& aggregate)
+		{
+			if (count < 8)
+			{
+				results[count] = aggregate;
+			}
+			count++;
+		}
+	};
+
+	/*
+	 * A minute's temperature: rises by 0.10 a minute from 20.00
+	 */
+	temperature_t line(int minute)
+	{
+		return 2000 + minute * 10;
+	}
+
+	void test_query()
+	{
+		// 20 minutes: a spread of +-3.00 around minute 5, no measurements in minutes 10 to 14
+		data_history_t history;
+		thermograph::time_t origin = at(10, 0, 0);
+		history.advance(SENSOR, origin);
+		for (int minute = 0; minute < 20; minute++)
+		{
+			if (minute == 5)
+			{
+				history.push(SENSOR, METRIC_TEMPERATURE, line(minute) - 300);
+				history.push(SENSOR, METRIC_TEMPERATURE, line(minute) + 300);
+			}
+			else if (minute < 10 || minute >= 15)
+			{
+				history.push(SENSOR, METRIC_TEMPERATURE, line(minute));
+			}
+			history.advance(SENSOR, shifted(origin, (minute + 1) * APP_HISTORY_INTERVAL));
+		}
+		check(history.get_buckets(SENSOR, 0, METRIC_TEMPERATURE).size() == 20, "the finest tier keeps the 20 minutes");
+
+		collector_t ten;
+		history.query(SENSOR, METRIC_TEMPERATURE, origin, shifted(origin, 1200), 600, ten);
+		check(ten.count == 2, "a range of two widths gives two aggregates");
+
+		const history_aggregate_t& a = ten.results[0];
+		check(same(a.start, origin), "the first aggregate starts at the range start");
+		check(a.count == 10, "the first aggregate has every bucket");
+		check(a.min == line(5) - 300 && a.max == line(5) + 300, "min and max come from buckets' min and max");
+		check(a.first == line(0) && a.last == line(9), "first and last are the edge buckets' means");
+		check(a.mean == (line(0) + line(9)) / 2, "mean is the buckets' average");
+		check(a.slope == 600, "slope of 0.10 a minute is 6.00 an hour");
+
+		const history_aggregate_t& b = ten.results[1];
+		check(same(b.start, shifted(origin, 600)), "the second aggregate starts a width later");
+		check(b.count == 5, "gaps aren't aggregated");
+		check(b.min == line(15) && b.max == line(19), "min and max skip the gaps");
+		check(b.first == line(15) && b.last == line(19), "first is the bucket after the gaps");
+		check(b.slope == 600, "slope after the gaps keeps the buckets' time positions");
+
+		collector_t gaps;
+		history.query(SENSOR, METRIC_TEMPERATURE, shifted(origin, 600), shifted(origin, 900), 300, gaps);
+		check(gaps.count == 1 && gaps.results[0].count == 0, "a range of gaps gives an empty aggregate");
+	}
+}
+
+int main()
+{
+	test_get_time();
+	test_get_time_wrap();
+	test_query();
+
+	printf("%d failed\n", failures);
+	return failures;
+}
@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include "Arduino.h"
+#include "history_stream.h"
+
+using namespace thermograph;
+
+/*
+ * Compressed history stream test: buckets pushed into a byte ring must
+ * read back the same, through keyframes, delta and spread entries, gap
+ * runs and evictions of the oldest blocks.
+ *
+ *	usage: test_history_stream
+ *
+ * Prints a line per check and exits with the number of failed checks.
+ */
+
+namespace
+{
+	const uint8_t RESOLUTION = 10;
+
+	/*
+	 * Buckets a test pushes, the model the stream's contents are checked against
+	 */
+	const int MAX_BUCKETS = 256;
+
+	int failures = 0;
+
+	void check(bool passed, const char* what)
+	{
+		printf("%s\t%s\n", passed ? "ok" : "FAIL", what);
+		if (!passed)
+		{
+			failures++;
+		}
+	}
+
+	history_bucket_t bucket(temperature_t min, temperature_t mean, temperature_t max)
+	{
+		history_bucket_t b = { min, max, mean };
+		return b;
+	}
+
+	history_bucket_t gap()
+	{
+		return bucket(history_bucket_t::GAP, history_bucket_t::GAP, history_bucket_t::GAP);
+	}
+
+	/*
+	 * A stream and the buckets pushed into it
+	 */
+	struct fixture_t
+	{
+		uint8_t bytes[history_stream_t::MAX_CAPACITY];
+		history_stream_t stream;
+		history_bucket_t pushed[MAX_BUCKETS];
+		int count;
+
+		fixture_t(uint8_t capacity) : count(0)
+		{
+			stream.attach(bytes, capacity, RESOLUTION);
+		}
+
+		void push(const history_bucket_t& b)
+		{
+			if (b.is_gap())
+			{
+				stream.push_gap();
+			}
+			else
+			{
+				stream.push(b);
+			}
+			pushed[count++] = b;
+		}
+
+		/*
+		 * Checks the stream holds the newest pushed buckets, oldest first
+		 */
+		bool matches() const
+		{
+			if (stream.size() > count)
+			{
+				return false;
+			}
+
+			history_stream_t::reader_t reader(stream);
+			history_bucket_t b;
+			for (int i = count - stream.size(); i < count; i++)
+			{
+				if (!reader.next(b) || !same(b, pushed[i]))
+				{
+					printf("\tbucket %d of %d: (%d, %d, %d) read as (%d, %d, %d)\n", i, count,
+						pushed[i].min, pushed[i].mean, pushed[i].max, b.min, b.mean, b.max);
+					return false;
+				}
+			}
+			return !reader.next(b);
+		}
+
+		static bool same(const history_bucket_t& a, const history_bucket_t& b)
+		{
+			return a.is_gap() ? b.is_gap() : a.mean == b.mean && a.min == b.min && a.max == b.max;
+		}
+	};
+
+	void test_round_trip()
+	{
+		fixture_t f(history_stream_t::MAX_CAPACITY);
+		f.push(bucket(2150, 2150, 2150));
+		f.push(bucket(2150, 2160, 2170));
+		f.push(bucket(-530, -500, -480));
+		f.push(bucket(-2000, 1000, 4000));
+		f.push(bucket(12000, 12000, 12000));
+		f.push(bucket(-4000, -4000, -4000));
+		f.push(bucket(0, 0, 0));
+		f.push(bucket(-10, 0, 10));
+		f.push(bucket(2000, 2150, 2300));
+		check(f.stream.size() == 9, "every pushed bucket is counted");
+		check(f.matches(), "values, narrow and wide spreads read back across keyframes");
+	}
+
+	void test_gaps()
+	{
+		fixture_t f(history_stream_t::MAX_CAPACITY);
+		f.push(bucket(2150, 2150, 2150));
+		for (int i = 0; i < 40; i++)
+		{
+			f.push(gap());
+		}
+		f.push(bucket(2100, 2200, 2300));
+		f.push(gap());
+		f.push(bucket(2180, 2180, 2180));
+		f.push(gap());
+		check(f.stream.size() == 45, "every gap slot is counted");
+		check(f.stream.used() < 20, "gap runs take a byte per entry");
+		check(f.matches(), "gap runs longer than a one byte entry read back");
+	}
+
+	void test_quantization()
+	{
+		fixture_t f(history_stream_t::MAX_CAPACITY);
+		f.stream.push(bucket(2144, 2146, 2154));
+		f.stream.push(bucket(-2156, -2144, -2136));
+
+		history_stream_t::reader_t reader(f.stream);
+		history_bucket_t b;
+		reader.next(b);
+		check(b.mean == 2150 && b.min == 2140 && b.max == 2150, "positive values round to the nearest step");
+		reader.next(b);
+		check(b.mean == -2140 && b.min == -2160 && b.max == -2140, "negative values round to the nearest step");
+	}
+
+	void test_eviction()
+	{
+		fixture_t f(history_stream_t::MIN_CAPACITY);
+		for (int i = 0; i < 200; i++)
+		{
+			temperature_t mean = (i % 7 - 3) * 170 + (i / 50) * 1000;
+			f.push(i % 11 == 5 ? gap() : bucket(mean - (i % 3) * 40, mean, mean + (i % 5) * 200));
+		}
+		check(f.stream.used() <= history_stream_t::MIN_CAPACITY, "evictions keep the stream within its ring");
+		check(f.stream.size() >= history_stream_t::KEYFRAME_INTERVAL, "the newest block is never evicted");
+		check(f.stream.size() % history_stream_t::KEYFRAME_INTERVAL == 200 % history_stream_t::KEYFRAME_INTERVAL, "whole blocks are evicted");
+		check(f.matches(), "the newest buckets read back after the ring wrapped around");
+	}
+
+	void test_skip()
+	{
+		fixture_t f(history_stream_t::MAX_CAPACITY);
+		for (int i = 0; i < 30; i++)
+		{
+			f.push(i >= 10 && i < 20 ? gap() : bucket(1000 + i * 10, 1000 + i * 20, 1000 + i * 40));
+		}
+
+		bool passed = true;
+		for (int skipped = 0; skipped < 30; skipped++)
+		{
+			history_stream_t::reader_t reader(f.stream);
+			reader.skip(skipped);
+			history_bucket_t b;
+			passed = passed && reader.remaining() == 30 - skipped && reader.next(b) && fixture_t::same(b, f.pushed[skipped]);
+		}
+		check(passed, "skip() lands on every bucket, gap runs and keyframes included");
+	}
+}
+
+int main()
+{
+	test_round_trip();
+	test_gaps();
+	test_quantization();
+	test_eviction();
+	test_skip();
+
+	printf("%d failed\n", failures);
+	return failures;
+}
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arduino.h"
+#include "number_format.h"
+
+using namespace thermograph;
+
+/*
+ * Number formatter test: number_format_t must print what printf() does,
+ * for the firmware's whole 16 and 32-bit ranges, negative fractions and
+ * padded fields included.
+ *
+ *	usage: test_number_format
+ *
+ * Prints a line per check and exits with the number of failed checks.
+ * Values are the firmware's: long is 32 bits wide on AVR.
+ */
+
+namespace
+{
+	const long INT16_LIMIT = 32768L;
+	const long INT32_LIMIT = 2147483647L;
+
+	/*
+	 * Random 32-bit values compared with printf()
+	 */
+	const int RANDOM_VALUES = 200000;
+
+	int failures = 0;
+
+	void check(bool passed, const char* what)
+	{
+		printf("%s\t%s\n", passed ? "ok" : "FAIL", what);
+		if (!passed)
+		{
+			failures++;
+		}
+	}
+
+	/*
+	 * Compares a formatted number with the expected text
+	 */
+	bool formats(const char* expected, long value, uint8_t decimals = 0, uint8_t width = 0, char padding = ' ')
+	{
+		number_format_t n(value, decimals, width, padding);
+		if (strcmp(n.c_str(), expected) != 0 || n.length() != strlen(expected))
+		{
+			printf("\t%ld, %d decimals, width %d: \"%s\" printed \"%s\"\n", value, decimals, width, expected, n.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	/*
+	 * Formats a number with printf(): the digits with a leading zero per decimal, a point among them
+	 */
+	void reference(char* text, long value, uint8_t decimals)
+	{
+		char digits[32];
+		unsigned long n = value < 0 ? 0UL - static_cast<unsigned long>(value) : value;
+		int length = sprintf(digits, "%0*lu", decimals + 1, n);
+
+		char* p = text;
+		if (value < 0)
+		{
+			*p++ = '-';
+		}
+		memcpy(p, digits, length - decimals);
+		p += length - decimals;
+		if (decimals > 0)
+		{
+			*p++ = '.';
+			memcpy(p, digits + length - decimals, decimals);
+			p += decimals;
+		}
+		*p = '\0';
+	}
+
+	/*
+	 * Compares a formatted number with printf()'s, reports the first mismatches only
+	 */
+	bool matches_reference(long value, uint8_t decimals)
+	{
+		static int reported = 0;
+		char expected[32];
+		reference(expected, value, decimals);
+		number_format_t n(value, decimals);
+		if (strcmp(n.c_str(), expected) != 0)
+		{
+			if (reported++ < 5)
+			{
+				printf("\t%ld, %d decimals: \"%s\" printed \"%s\"\n", value, decimals, expected, n.c_str());
+			}
+			return false;
+		}
+		return true;
+	}
+
+	void test_limits()
+	{
+		check(formats("0", 0) && formats("0.00", 0, 2), "zero prints a digit before the point");
+		check(formats("-32768", -INT16_LIMIT) && formats("32767", INT16_LIMIT - 1), "int limits print in full");
+		check(formats("-2147483648", -INT32_LIMIT - 1) && formats("2147483647", INT32_LIMIT), "long limits print in full");
+		check(formats("-2.147483648", -INT32_LIMIT - 1, 9), "long min prints with max decimals");
+		check(formats("65535", 65535) && formats("65536", 65536) && formats("-65536", -65536), "values around 16 bits print in full");
+		check(formats("10000", 10000) && formats("43699", 43699) && formats("100000000", 100000000L), "powers of ten and the pair split's limit print in full");
+	}
+
+	void test_fractions()
+	{
+		check(formats("-0.05", -5, 2) && formats("-0.5", -5, 1), "negative fractions below one keep their sign");
+		check(formats("-12.34", -1234, 2) && formats("-1.00", -100, 2), "negative fractions print every decimal");
+		check(formats("0.005", 5, 3) && formats("-0.000000001", -1, 9), "fractions get their leading zeros");
+		check(formats("0.000000001", 1, 12), "decimals are limited to MAX_DECIMALS");
+	}
+
+	void test_padding()
+	{
+		check(formats("007", 7, 0, 3, '0') && formats("   7", 7, 0, 4), "numbers are padded up to the width");
+		check(formats("-007", -7, 0, 4, '0') && formats("-00.05", -5, 2, 6, '0'), "zeros go after the sign");
+		check(formats("  -7", -7, 0, 4) && formats("**-0.05", -5, 2, 7, '*'), "other placeholders go before the sign");
+		check(formats("12345", 12345, 0, 3, '0') && formats("-12.34", -1234, 2, 2, '0'), "a number wider than its field isn't cut");
+		check(formats("             1", 1, 0, 40), "the width is limited to MAX_WIDTH");
+
+		number_format_t n(-1234, 2, 8, '0');
+		check(n.length() == 8 && n[0] == '-' && n[1] == '0' && n[5] == '.' && n[7] == '4', "characters are indexed from the left");
+	}
+
+	void test_reference()
+	{
+		bool passed = true;
+		for (long value = -INT16_LIMIT; value < INT16_LIMIT; value++)
+		{
+			passed = matches_reference(value, 0) && matches_reference(value, 2) && passed;
+		}
+		check(passed, "every 16-bit value matches printf()");
+
+		passed = true;
+		for (long value = 0; value < 0x30000; value += 3)
+		{
+			passed = matches_reference(value, 1) && matches_reference(-value, 4) && passed;
+		}
+		check(passed, "values crossing 16 bits match printf()");
+
+		passed = true;
+		srand(1);
+		for (int i = 0; i < RANDOM_VALUES; i++)
+		{
+			long value = static_cast<long>(static_cast<int32_t>(static_cast<uint32_t>(rand()) << 16 ^ static_cast<uint32_t>(rand())));
+			passed = matches_reference(value, i % (number_format_t::MAX_DECIMALS + 1)) && passed;
+		}
+		check(passed, "random 32-bit values match printf()");
+	}
+}
+
+int main()
+{
+	test_limits();
+	test_fractions();
+	test_padding();
+	test_reference();
+
+	printf("%d failed\n", failures);
+	return failures;
+}
@@ -1,7 +1,11 @@
 #include "Arduino.h"
 #include <avr/pgmspace.h>
 #include "log.h"
-#include "util.h"
+extern "C" 
+{
+#include <avr/io.h>
+#include <avr/interrupt.h>
+}
 
 using namespace thermograph;
 
@@ -10,207 +14,432 @@ using namespace thermograph;
 **/
 log_t thermograph::log;
 
-/*
- ************************************************************************
- *	log_event_t
- *	Log event writer
- ************************************************************************
- */
+/**
+*	Binary log record header's flag of a full timestamp
+**/
+static const uint8_t LOG_TIME_FULL = 0x04;
 
 /**
-*	Constructor
-*	@param	enable	indicates whether current log writer instance is allowed to write any data into log
+*	Escape byte of a binary log record and what follows it instead of '\n' and itself
 **/
-log_event_t::log_event_t(bool enable)
-	: _enable(enable)
-{ }
+static const uint8_t LOG_ESCAPE = 0xDB;
+static const uint8_t LOG_ESCAPED_END = 0xDC;
+static const uint8_t LOG_ESCAPED_ESCAPE = 0xDD;
 
 /**
-*	Destructor
+*	Computes a format string's ID at run time, for format strings other than LOG_* macros' ones
+*	@param		format	format string
+*	@param		flash	indicates whether the format string is in flash memory
+*	@returns	format string's ID
 **/
-log_event_t::~log_event_t()
+static format_id_t runtime_format_id(const char* format, bool flash)
 {
-	if(_enable)
+	uint16_t id = LOG_FORMAT_SEED;
+	for(char c; (c = format_char(format, flash)) != '\0'; format++)
 	{
-		Serial.println();
-		Serial.flush();
+		id = format_id_next(id, c);
 	}
+	format_id_t result = { id };
+	return result;
 }
 
 /**
-*	Appends a formatted text into log
-*	@param	msg	format string
+*	Gets the argument type a conversion's argument is written as into a binary log record
+*	@param		conversion	conversion character following '%'
+*	@returns	argument type, FORMAT_ARG_NONE if the conversion has no argument
 **/
-void log_event_t::printf(const char* msg, ...)
+static format_arg_type conversion_type(char conversion)
 {
-	if(_enable)
+	switch(conversion)
 	{
-		va_list args;
-		va_start(args, msg);
-		log.print_message(msg, args);
+	case 'd':
+	case 'i':
+	case 'x':
+	case 'X':
+	case 'b':
+	case 'B':
+	case 'c':
+	case 't':
+	case 'T':
+	case 'h':
+	case 'l':
+		return FORMAT_ARG_INTEGER;
+	case 's':
+		return FORMAT_ARG_STRING;
+	case 'u':
+		return FORMAT_ARG_TIME;
+	case 'U':
+		return FORMAT_ARG_SYS_TIME;
+	case 'f':
+	case 'F':
+		return FORMAT_ARG_FLOAT;
+	case 'm':
+		return FORMAT_ARG_MESSAGE;
+	default:
+		return FORMAT_ARG_NONE;
 	}
 }
 
 /**
-*	Appends a formatted text into log
-*	@param	msg	format string
+*	USART data register empty interrupt handler.
+*	Serial isn't referenced anywhere, so the core's HardwareSerial with its own handler isn't linked
 **/
-void log_event_t::printf(__FlashStringHelper* msg, ...)
+ISR(USART_UDRE_vect)
 {
-	if(_enable)
-	{
-		va_list args;
-		va_start(args, msg);
-		log.print_message(msg, args);
-	}
+	thermograph::log.on_transmit();
 }
 
 /*
  ************************************************************************
- *	log_t
- *	Logger class
+ *	log_buffer_t
+ *	Log output buffer class
  ************************************************************************
  */
 
-/** public members **/
+/**
+*	Constructor
+**/
+log_buffer_t::log_buffer_t()
+	: _head(0), _tail(0), _write(0), _dropping(false), _dropped_bytes(0), _dropped_lines(0)
+{ }
 
 /**
-*	Initializes logging
-*	@param	baud	serial port baud rate
+*	Initializes the serial port transmitter, 8N1 framing
+*	@param	baud	baud rate
 **/
-void log_t::init(const long baud)
+void log_buffer_t::begin(const long baud)
+{
+	// Double speed mode, its baud rate error is lower
+	UBRR0 = (F_CPU / 4 / baud - 1) / 2;
+	UCSR0A = _BV(U2X0);
+	UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+	UCSR0B = _BV(TXEN0);
+}
+
+/**
+*	Queues a byte
+*	@param		c	a byte to write
+*	@returns	bytes written, dropped ones included
+**/
+size_t log_buffer_t::write(uint8_t c)
+{
+	if(_dropping)
+	{
+		_dropped_bytes++;
+		_dropping = c != '\n';
+		return 1;
+	}
+
+	// The interrupt moves the tail, a two byte position must be read at once.
+	// The log may be written with interrupts disabled, so their state is restored rather than enabled
+	uint8_t sreg = SREG;
+	cli();
+	bool full = wrap(_write + 1) == _tail;
+	SREG = sreg;
+
+	if(full && !(APP_LOG_OVERFLOW == LOG_DROP_OLDEST && drop_oldest()))
+	{
+		drop_newest();
+		_dropped_bytes++;
+		_dropping = c != '\n';
+		return 1;
+	}
+
+	_bytes[_write] = c;
+	_write = wrap(_write + 1);
+
+	if(c == '\n')
+	{
+		// Publish the line
+		sreg = SREG;
+		cli();
+		_head = _write;
+		UCSR0B |= _BV(UDRIE0);
+		SREG = sreg;
+	}
+	return 1;
+}
+
+/**
+*	Sends the next queued byte, called by the USART data register empty interrupt
+**/
+void log_buffer_t::transmit()
 {
-	Serial.begin(baud);
+	uint16_t tail = _tail;
+	if(tail == _head)
+	{
+		UCSR0B &= ~_BV(UDRIE0);
+		return;
+	}
+
+	UDR0 = _bytes[tail];
+	_tail = wrap(tail + 1);
 }
 
 /**
-*	Writes a formatted message with ERR log level into log
-*	@param	msg	format string
+*	Waits until queued lines have been sent. Interrupts must be enabled
 **/
-void log_t::error(const char* msg, ...)
+void log_buffer_t::flush()
 {
-	va_list args;
-	va_start(args, msg);
-	print(LOG_ERROR, msg, args);
+	for(;;)
+	{
+		// The interrupt moves the tail, a two byte position must be read at once
+		uint8_t sreg = SREG;
+		cli();
+		bool sent = _tail == _head;
+		SREG = sreg;
+
+		if(sent)
+		{
+			return;
+		}
+		delay(1);
+	}
 }
 
 /**
-*	Writes a formatted message with INF log level into log
-*	@param	msg	format string
+*	Drops the line being written
 **/
-void log_t::info(const char* msg, ...)
+void log_buffer_t::drop_newest()
 {
-	va_list args;
-	va_start(args, msg);
-	print(LOG_INFO, msg, args);
+	_dropped_bytes += _write >= _head ? _write - _head : _write + APP_LOG_BUFFER - _head;
+	_dropped_lines++;
+	_write = _head;
 }
 
 /**
-*	Writes a formatted message with DBG log level into log
-*	@param	msg	format string
+*	Drops the oldest queued line after the one being transmitted
+*	@returns	true if a line has been dropped, false if there's none
 **/
-void log_t::debug(const char* msg, ...)
+bool log_buffer_t::drop_oldest()
 {
-	va_list args;
-	va_start(args, msg);
-	print(LOG_DEBUG, msg, args);
+	bool dropped = false;
+
+	// The interrupt must not move the tail while the line being transmitted is moved
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t tail = _tail;
+	if(tail != _head)
+	{
+		uint16_t kept = get_line_length(tail);
+		uint16_t line = wrap(tail + kept);
+		if(line != _head)
+		{
+			// Move the rest of the line being transmitted over the dropped line
+			uint16_t length = get_line_length(line);
+			for(uint16_t i = kept; i-- > 0; )
+			{
+				_bytes[wrap(tail + length + i)] = _bytes[wrap(tail + i)];
+			}
+			_tail = wrap(tail + length);
+
+			_dropped_bytes += length;
+			_dropped_lines++;
+			dropped = true;
+		}
+	}
+	SREG = sreg;
+
+	return dropped;
 }
 
 /**
-*	Writes a formatted message with ERR log level into log
-*	@param	msg	format string
+*	Gets a line's length
+*	@param		pos		line's position
+*	@returns	bytes up to and including the line's '\n'
 **/
-void log_t::error(__FlashStringHelper* msg, ...)
+uint16_t log_buffer_t::get_line_length(uint16_t pos) const
 {
-	va_list args;
-	va_start(args, msg);
-	print(LOG_ERROR, msg, args);
+	uint16_t length = 1;
+	while(_bytes[pos] != '\n')
+	{
+		pos = wrap(pos + 1);
+		length++;
+	}
+	return length;
 }
 
+/*
+ ************************************************************************
+ *	log_event_t
+ *	Log event writer
+ ************************************************************************
+ */
+
+/**
+*	Constructor
+*	@param	enable	indicates whether current log writer instance is allowed to write any data into log
+**/
+log_event_t::log_event_t(bool enable)
+	: _enable(enable)
+{ }
+
 /**
-*	Writes a formatted message with INF log level into log
-*	@param	msg	format string
+*	Destructor
 **/
-void log_t::info(__FlashStringHelper* msg, ...)
+log_event_t::~log_event_t()
 {
-	va_list args;
-	va_start(args, msg);
-	print(LOG_INFO, msg, args);
+	if(_enable)
+	{
+		log.print_end();
+	}
 }
 
+/*
+ ************************************************************************
+ *	log_t
+ *	Logger class
+ ************************************************************************
+ */
+
+/** public members **/
+
 /**
-*	Writes a formatted message with DBG log level into log
-*	@param	msg	format string
+*	Constructor
 **/
-void log_t::debug(__FlashStringHelper* msg, ...)
+log_t::log_t()
+	: _repeats(), _time_high(0xFFFF)
+{ }
+
+/**
+*	Initializes logging
+*	@param	baud	serial port baud rate
+**/
+void log_t::init(const long baud)
 {
-	va_list args;
-	va_start(args, msg);
-	print(LOG_DEBUG, msg ,args);
+	_buffer.begin(baud);
 }
 
 /**
 *	Starts writing an event using log event writer.
+*	The event isn't filtered by module levels, guard it with LOG_ENABLED.
 *	@param		level	log level
 *	@returns	log event writer
 **/
 log_event_t log_t::begin_event(log_level level)
 {
-#ifndef ENABLE_DEBUG_LOGGING
-	if(level == LOG_DEBUG)
-	{
-		return log_event_t(false);
-	}
-#endif
-
 	print_header(level);
 	return log_event_t(true);
 }
 
+/**
+*	Writes dropped log text statistics and repeat counts of rate limited messages
+*	whose window has passed into log
+**/
+void log_t::log_stats()
+{
+	LOG_INF(APP, F("log\tstats: %l bytes in %l lines dropped"), _buffer.get_dropped_bytes(), static_cast<long>(_buffer.get_dropped_lines()));
+
+	unsigned long now = millis();
+	for(uint8_t i = 0; i < APP_LOG_REPEAT_SLOTS; i++)
+	{
+		repeat_t& repeat = _repeats[i];
+		if(repeat.format != log_format_t() && static_cast<long>(now - repeat.expires) >= 0)
+		{
+			print_repeats(repeat);
+			repeat.format = log_format_t();
+		}
+	}
+}
+
 /**	private members	**/
 
 /**
 *	Writes a formatted message into log
 *	@param	level	log level
 *	@param	format	format string
-*	@params	args	format arguments list
+*	@param	flash	indicates whether the format string is in flash memory
+*	@param	args	format arguments, ending with FORMAT_ARG_NONE
 **/
-void log_t::print(log_level level, const char* format, va_list args)
+void log_t::print(log_level level, const char* format, bool flash, const format_arg_t* args)
 {
-#ifndef ENABLE_DEBUG_LOGGING
-	if(level == LOG_DEBUG)
-	{
-		return;
-	}
-#endif
-
 	print_header(level);
 
-	print_message(format, args);
-	Serial.println();
-	Serial.flush();
+	print_message(format, flash, args);
+	print_end();
 }
 
+#ifdef APP_LOG_BINARY
 /**
 *	Writes a formatted message into log
 *	@param	level	log level
-*	@param	format	format string
-*	@params	args	format arguments list
+*	@param	format	format string's ID
+*	@param	args	format arguments, ending with FORMAT_ARG_NONE
 **/
-void log_t::print(log_level level, __FlashStringHelper* format, va_list args)
+void log_t::print(log_level level, format_id_t format, const format_arg_t* args)
 {
-#ifndef ENABLE_DEBUG_LOGGING
-	if(level == LOG_DEBUG)
+	write_header(level);
+
+	write_message(format, args);
+	print_end();
+}
+#endif
+
+/**
+*	Checks whether a rate limited message is to be written, counts it as a repeat otherwise
+*	@param		level	log level
+*	@param		window	call site's window, in milliseconds
+*	@param		format	format string, identifies the call site
+*	@returns	true if the message is to be written
+**/
+bool log_t::admit(log_level level, unsigned long window, log_format_t format)
+{
+	unsigned long now = millis();
+
+	// The call site's slot, a free one or the one whose window ends first
+	repeat_t* slot = &_repeats[0];
+	for(uint8_t i = 0; i < APP_LOG_REPEAT_SLOTS; i++)
 	{
-		return;
+		repeat_t& repeat = _repeats[i];
+		if(repeat.format == format)
+		{
+			slot = &repeat;
+			break;
+		}
+
+		if(slot->format != log_format_t() && (repeat.format == log_format_t() || static_cast<long>(repeat.expires - slot->expires) < 0))
+		{
+			slot = &repeat;
+		}
 	}
-#endif
 
-	print_header(level);
+	if(slot->format == format && static_cast<long>(now - slot->expires) < 0)
+	{
+		if(slot->count != 0xFFFF)
+		{
+			slot->count++;
+		}
+		return false;
+	}
+
+	if(slot->format != log_format_t())
+	{
+		print_repeats(*slot);
+	}
+
+	slot->format = format;
+	slot->expires = now + window;
+	slot->level = level;
+	return true;
+}
+
+/**
+*	Writes a call site's repeat count into log and resets it.
+*	The call site is identified by its format string, printed as is (its ID in binary log)
+*	@param	repeat	rate limited call site
+**/
+void log_t::print_repeats(repeat_t& repeat)
+{
+	if(repeat.count == 0)
+	{
+		return;
+	}
 
-	print_message(format, args);
-	Serial.println();
-	Serial.flush();
+	{
+		log_event_t e = begin_event(static_cast<log_level>(repeat.level));
+		LOG_APPEND(e, F("log\trepeated %d times: %m"), repeat.count, repeat.format);
+	}
+	repeat.count = 0;
 }
 
 /**
@@ -219,7 +448,10 @@ void log_t::print(log_level level, __FlashStringHelper* format, va_list args)
 */
 void log_t::print_header(log_level level)
 {
-	__FlashStringHelper* header;
+#ifdef APP_LOG_BINARY
+	write_header(level);
+#else
+	const __FlashStringHelper* header = F("DBG");
 	switch (level)
 	{
 	case LOG_ERROR:
@@ -228,330 +460,229 @@ void log_t::print_header(log_level level)
 	case LOG_INFO:
 		header = F("INF");
 		break;
-	case LOG_DEBUG:
-		header = F("DBG");
-		break;
 	default:
 		break;
 	}
 
 	// TIME LOCAL
-	print_time(time_service.get_systime());
-	Serial.print('\t');
+	format_time(_buffer, time_service.get_systime());
+	_buffer.print('\t');
 	// TIME GLOBAL
-	print_time(time_service.get_time());
-	Serial.print('\t');
+	format_time(_buffer, time_service.get_time());
+	_buffer.print('\t');
 
 	// LOG LEVEL
-	Serial.print(header);
-	Serial.print('\t');
+	_buffer.print(header);
+	_buffer.print('\t');
+#endif
 }
 
 /**
-*	Writes a formatted global time into log
-*	@param	time global time
+*	Ends a log message
 **/
-void log_t::print_time(const time_t& time)
+void log_t::print_end()
 {
-	print_formatted_number(time.h, 2);
-	Serial.print(':');
-	print_formatted_number(time.min, 2);
-	Serial.print(':');
-	print_formatted_number(time.sec, 2);
+#ifdef APP_LOG_BINARY
+	_buffer.write('\n');
+#else
+	_buffer.println();
+#endif
 }
 
 /**
-*	Writes a formatted local time into log
-*	@param	time local time
+*	Writes a formatted message into log
+*	@param	format	format string
+*	@param	flash	indicates whether the format string is in flash memory
+*	@param	args	format arguments, ending with FORMAT_ARG_NONE
 **/
-void log_t::print_time(const sys_time_t& time)
+void log_t::print_message(const char* format, bool flash, const format_arg_t* args)
 {
-	print_formatted_number(time.h, 4, ' ');
-	Serial.print(':');
-	print_formatted_number(time.min, 2);
-	Serial.print(':');
-	print_formatted_number(time.sec, 2);
-	Serial.print('.');
-	print_formatted_number(time.ms, 3);
+#ifdef APP_LOG_BINARY
+	write_message(format, flash, args);
+#else
+	format_message(_buffer, format, flash, args);
+#endif
 }
 
 /**
-*	Writes a formatted decimal number into log
-*	@param	value		a number to write
-*	@param	precision	amount of decimal places
-*	@param	placeholder	a placeholder character
+*	Writes a binary log record header
+*	@param	level	log level
 **/
-void log_t::print_formatted_number(int value, int precision, char placeholder)
+void log_t::write_header(log_level level)
 {
-	util::print_number(Serial, value, precision, placeholder);
-	return;
+	unsigned long ms = millis();
+	uint16_t high = ms >> 16;
+
+	uint8_t header = level;
+	if(high != _time_high)
+	{
+		header |= LOG_TIME_FULL;
+		_time_high = high;
+	}
+	write_byte(header);
+
+	for(uint8_t i = 0; i < (header & LOG_TIME_FULL ? 4 : 2); i++)
+	{
+		write_byte(ms >> (8 * i));
+	}
 }
 
 /**
-*	Writes a formatted message into log
+*	Writes a format string's ID and its arguments into a binary log record.
+*	A conversion without a fitting argument gets a zero value, so the record stays decodable
 *	@param	format	format string
-*	@params	args	format arguments list
+*	@param	flash	indicates whether the format string is in flash memory
+*	@param	args	format arguments, ending with FORMAT_ARG_NONE
 **/
-void log_t::print_message(__FlashStringHelper* format_ptr, va_list args) 
+void log_t::write_message(const char* format, bool flash, const format_arg_t* args)
 {
-	uint16_t address = reinterpret_cast<uint16_t>(format_ptr);
-	char c;
-	size_t i = -1;
-	while(true)
+	format_id_t id = runtime_format_id(format, flash);
+	write_byte(id.value);
+	write_byte(id.value >> 8);
+
+	for(char c; (c = format_char(format, flash)) != '\0'; format++)
 	{
-		i++;
-		c = pgm_read_byte(address + i);
-		if(c == '\0')
+		if(c != '%')
 		{
-			break;
+			continue;
 		}
 
-		if (c == '%') 
+		c = format_char(++format, flash);
+		if(c == '\0')
 		{
-			++i;
-			c = pgm_read_byte(address + i);
-
-			if (c == '\0') break;
-			if (c == '%') 
-			{
-				Serial.print(c);
-				continue;
-			}
-
-			if( c == 's' ) 
-			{
-				register char *s = (char *)va_arg( args, int );
-				Serial.print(s);
-				continue;
-			}
-
-			if( c == 'd' || c == 'i')
-			{
-				Serial.print(va_arg( args, int ),DEC);
-				continue;
-			}
-
-			if( c == 'x' )
-			{
-				Serial.print(va_arg( args, int ),HEX);
-				continue;
-			}
-
-			if( c == 'X' )
-			{
-				Serial.print("0x");
-				Serial.print(va_arg( args, int ),HEX);
-				continue;
-			}
-
-			if( c == 'b' ) 
-			{
-				Serial.print(va_arg( args, int ),BIN);
-				continue;
-			}
-
-			if( c == 'B' ) 
-			{
-				Serial.print("0b");
-				Serial.print(va_arg( args, int ),BIN);
-				continue;
-			}
-
-			if( c == 'l' )
-			{
-				Serial.print(va_arg( args, long ),DEC);
-				continue;
-			}
-
-
-			if( c == 'c' )
-			{
-				Serial.print(va_arg( args, int ));
-				continue;
-			}
-
-			if( c == 't' )
-			{
-				if (va_arg( args, int ) == 1)
-				{
-					Serial.print("T");
-				}
-				else 
-				{
-					Serial.print("F");
-				}
-				continue;
-			}
-
-			if( c == 'T' )
-			{
-				if (va_arg( args, int ) == 1) 
-				{
-					Serial.print("true");
-				}
-				else 
-				{
-					Serial.print("false");
-				}
-				continue;
-			}
-
-			if( c == 'u' ) 
-			{
-				time_t* t = (time_t *)va_arg( args, int );
-				print_time(*t);
-				continue;
-			}
-			if( c == 'U' ) 
-			{
-				sys_time_t* t = (sys_time_t *)va_arg( args, int );
-				print_time(*t);
-				continue;
-			}
-
-			if( c == 'f' ) 
-			{
-				float x = *(float *)va_arg( args, int );
-				Serial.print(x);
-				continue;
-			}
-			if( c == 'F' ) 
-			{
-				double x = *(double *)va_arg( args, int );
-				Serial.print(x);
-				continue;
-			}
+			return;
+		}
+		if(c == '%')
+		{
+			continue;
 		}
 
-		Serial.print(c);
+		const format_arg_t* arg = format_next_arg(args, c);
+		write_arg(conversion_type(c), arg);
 	}
 }
 
 /**
-*	Writes a formatted message into log
-*	@param	format	format string
-*	@params	args	format arguments list
+*	Writes a format string's ID and its arguments into a binary log record.
+*	The arguments are written by their types, LOG_* macros have checked them against the format string
+*	@param	format	format string's ID
+*	@param	args	format arguments, ending with FORMAT_ARG_NONE
 **/
-void log_t::print_message(const char *format, va_list args) 
+void log_t::write_message(format_id_t format, const format_arg_t* args)
 {
-	// loop through format string
-	for (; *format != 0; ++format)
-	{
-		if (*format == '%') 
-		{
-			++format;
-			if (*format == '\0') break;
-			if (*format == '%') 
-			{
-				Serial.print(*format);
-				continue;
-			}
-
-			if( *format == 's' ) 
-			{
-				register char *s = (char *)va_arg( args, int );
-				Serial.print(s);
-				continue;
-			}
-
-			if( *format == 'd' || *format == 'i')
-			{
-				Serial.print(va_arg( args, int ),DEC);
-				continue;
-			}
-
-			if( *format == 'x' )
-			{
-				Serial.print(va_arg( args, int ),HEX);
-				continue;
-			}
+	write_byte(format.value);
+	write_byte(format.value >> 8);
 
-			if( *format == 'X' )
-			{
-				Serial.print("0x");
-				Serial.print(va_arg( args, int ),HEX);
-				continue;
-			}
-
-			if( *format == 'b' ) 
-			{
-				Serial.print(va_arg( args, int ),BIN);
-				continue;
-			}
+	for(; args->type != FORMAT_ARG_NONE; args++)
+	{
+		write_arg(args->type, args);
+	}
+}
 
-			if( *format == 'B' ) 
-			{
-				Serial.print("0b");
-				Serial.print(va_arg( args, int ),BIN);
-				continue;
-			}
+/**
+*	Writes an argument into a binary log record
+*	@param	type	argument type the record holds
+*	@param	arg		the argument, NULL writes a zero value
+**/
+void log_t::write_arg(format_arg_type type, const format_arg_t* arg)
+{
+	switch(type)
+	{
+	case FORMAT_ARG_INTEGER:
+	case FORMAT_ARG_LONG:
+		write_varint(arg != NULL ? arg->integer : 0);
+		break;
 
-			if( *format == 'l' )
-			{
-				Serial.print(va_arg( args, long ),DEC);
-				continue;
-			}
+	case FORMAT_ARG_STRING:
+		if(arg != NULL)
+		{
+			write_bytes(arg->string, strlen(arg->string));
+		}
+		write_byte('\0');
+		break;
 
+	case FORMAT_ARG_TIME:
+	{
+		static const time_t none = { 0, 0, 0 };
+		const time_t& t = arg != NULL ? *arg->time : none;
+		write_byte(t.h);
+		write_byte(t.min);
+		write_byte(t.sec);
+		break;
+	}
 
-			if( *format == 'c' )
-			{
-				Serial.print(va_arg( args, int ));
-				continue;
-			}
+	case FORMAT_ARG_SYS_TIME:
+	{
+		static const sys_time_t none = { 0, 0, 0, 0 };
+		const sys_time_t& t = arg != NULL ? *arg->sys_time : none;
+		write_byte(t.h);
+		write_byte(t.h >> 8);
+		write_byte(t.min);
+		write_byte(t.sec);
+		write_byte(t.ms);
+		write_byte(t.ms >> 8);
+		break;
+	}
 
-			if( *format == 't' )
-			{
-				if (va_arg( args, int ) == 1)
-				{
-					Serial.print("T");
-				}
-				else 
-				{
-					Serial.print("F");
-				}
-				continue;
-			}
+	case FORMAT_ARG_FLOAT:
+	{
+		float x = arg != NULL ? arg->real : 0;
+		write_bytes(&x, sizeof(x));
+		break;
+	}
 
-			if( *format == 'T' )
-			{
-				if (va_arg( args, int ) == 1) 
-				{
-					Serial.print("true");
-				}
-				else 
-				{
-					Serial.print("false");
-				}
-				continue;
-			}
+	case FORMAT_ARG_MESSAGE:
+	{
+		uint16_t message = arg != NULL ? arg->id.value : 0;
+		write_byte(message);
+		write_byte(message >> 8);
+		break;
+	}
 
-			if( *format == 'u' ) 
-			{
-				time_t* t = (time_t *)va_arg( args, int );
-				print_time(*t);
-				continue;
-			}
-			if( *format == 'U' ) 
-			{
-				sys_time_t* t = (sys_time_t *)va_arg( args, int );
-				print_time(*t);
-				continue;
-			}
+	default:
+		break;
+	}
+}
 
-			if( *format == 'f' ) 
-			{
-				float x = *(float *)va_arg( args, int );
-				Serial.print(x);
-				continue;
-			}
-			if( *format == 'F' ) 
-			{
-				double x = *(double *)va_arg( args, int );
-				Serial.print(x);
-				continue;
-			}
-		}
+/**
+*	Writes a zigzag varint into a binary log record
+*	@param	value	a value to write
+**/
+void log_t::write_varint(long value)
+{
+	unsigned long zigzag = (static_cast<unsigned long>(value) << 1) ^ static_cast<unsigned long>(value < 0 ? -1L : 0L);
+	while(zigzag >= 0x80)
+	{
+		write_byte(static_cast<uint8_t>(zigzag) | 0x80);
+		zigzag >>= 7;
+	}
+	write_byte(static_cast<uint8_t>(zigzag));
+}
 
-		Serial.print(*format);
+/**
+*	Writes bytes into a binary log record
+*	@param	data	bytes to write
+*	@param	length	bytes count
+**/
+void log_t::write_bytes(const void* data, size_t length)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	while(length-- > 0)
+	{
+		write_byte(*bytes++);
 	}
 }
+
+/**
+*	Writes a byte into a binary log record, escaping the record delimiter
+*	@param	b	a byte to write
+**/
+void log_t::write_byte(uint8_t b)
+{
+	if(b == '\n' || b == LOG_ESCAPE)
+	{
+		_buffer.write(LOG_ESCAPE);
+		b = b == '\n' ? LOG_ESCAPED_END : LOG_ESCAPED_ESCAPE;
+	}
+	_buffer.write(b);
+}
\ No newline at end of file
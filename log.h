@@ -1,14 +1,15 @@
 #pragma once
 
 #include "_config.h"
-#include <stdarg.h>
 #include "Arduino.h"
 extern "C" 
 {
 #include <avr/io.h>
 }
 
+#include "format.h"
 #include "time.h"
+#include "log_formats.h"
 
 namespace thermograph
 {
@@ -21,20 +22,57 @@ namespace thermograph
 	 *	|	%s		|	string								|	char*			|
 	 *	|	%c		|	char								|	char			|
 	 *	|	%d		|	integer								|	int				|
-	 *	|	%l		|	long								|	long			|
+	 *	|	%l		|	long								|	any integer		|
 	 *	|	%x		|	integer (hex)						|	int				|
 	 *	|	%X		|	integer (hex with '0x' prefix)		|	int				|
 	 *	|	%b		|	integer (binary)					|	int				|
 	 *	|	%B		|	integer (binary with '0b' prefix)	|	int				|
 	 *	|	%t		|	boolean ('t' or 'f')				|	bool			|
 	 *	|	%T		|	boolear ('true' or 'false')			|	bool			|
-	 *	|	%u		|	global time							|	time_t*			|
-	 *	|	%U		|	system time							|	sys_time_t*		|
-	 *	|	%f		|	float point value					|	float*			|
-	 *	|	%F		|	float point value					|	double*			|
+	 *	|	%u		|	global time							|	time_t			|
+	 *	|	%U		|	system time							|	sys_time_t		|
+	 *	|	%h		|	fixed point value, in hundredths	|	any integer		|
+	 *	|	%f		|	float point value					|	float, double	|
+	 *	|	%F		|	float point value					|	float, double	|
+	 *	|	%m		|	log message's format string as is	|	F() string		|
 	 *	+-----------+-------------------------------------+-------------------+
+	 *	"int" is any integer no wider than int. LOG_* macros check F() format strings against
+	 *	their arguments at compile time, otherwise a conversion without a fitting argument prints '?'
 	 **/
 
+	/**
+	 *	Binary log record, sent instead of text if APP_LOG_BINARY is defined.
+	 *	Multi-byte values are little endian, integers are zigzag varints: 7 bits per byte,
+	 *	least significant first, the high bit marks a continuation.
+	 *	+-----------+-----------------------------------------------------------+
+	 *	|	Bytes	|	Description												|
+	 *	+-----------+-----------------------------------------------------------+
+	 *	|	1		|	log level in bits 0-1, bit 2 marks a full timestamp		|
+	 *	|	2 or 4	|	millis(), its low half only while the high one is the	|
+	 *	|			|	same as the previous record's							|
+	 *	|	2		|	format string ID, see "log_formats.h"					|
+	 *	|	...		|	arguments:	%d %i %x %X %b %B %c %t %T %h %l	integer	|
+	 *	|			|				%s		NUL-terminated string			|
+	 *	|			|				%u		h, min, sec bytes				|
+	 *	|			|				%U		h (2 bytes), min, sec, ms (2)	|
+	 *	|			|				%f %F	4 byte float					|
+	 *	|			|				%m		format string ID (2 bytes)		|
+	 *	|	...		|	more format string IDs and arguments of a log event		|
+	 *	+-----------+-----------------------------------------------------------+
+	 *	Records end with '\n'. A '\n' byte within a record is sent as 0xDB 0xDC, 0xDB as 0xDB 0xDD.
+	 *	LOG_* macros compute their format strings' IDs at compile time and pass them instead of the strings,
+	 *	so the strings aren't stored in the binary log build's flash memory
+	 **/
+
+	/**
+	 *	Log message's format string, as LOG_* macros pass it: F() string in text log, its ID in binary log
+	 **/
+#ifdef APP_LOG_BINARY
+	typedef format_id_t log_format_t;
+#else
+	typedef const __FlashStringHelper* log_format_t;
+#endif
+
 	/**
 	 *	Log levels enumeration
 	 **/
@@ -55,6 +93,135 @@ namespace thermograph
 		 **/
 		LOG_DEBUG
 	};
+
+	/**
+	 *	Log buffer overflow policies enumeration
+	 **/
+	enum log_overflow
+	{
+		/**
+		 *	Drops the line being written
+		 **/
+		LOG_DROP_NEWEST,
+
+		/**
+		 *	Drops the oldest queued lines
+		 **/
+		LOG_DROP_OLDEST
+	};
+
+	/**
+	 *	Log output buffer class.
+	 *	Queues log text into a byte ring which the USART data register empty interrupt sends,
+	 *	so writing doesn't wait for the serial port. A line becomes visible to the interrupt
+	 *	once its '\n' is written, so text which doesn't fit is dropped a whole line at a time
+	 *	according to APP_LOG_OVERFLOW, the line being transmitted is never cut
+	 **/
+	class log_buffer_t : public Print
+	{
+	public:
+		/**
+		 *	Constructor
+		 **/
+		log_buffer_t();
+
+		/**
+		 *	Initializes the serial port transmitter, 8N1 framing
+		 *	@param	baud	baud rate
+		 **/
+		void begin(const long baud);
+
+		/**
+		 *	Queues a byte
+		 *	@param		c	a byte to write
+		 *	@returns	bytes written, dropped ones included
+		 **/
+		virtual size_t write(uint8_t c);
+		using Print::write;
+
+		/**
+		 *	Sends the next queued byte, called by the USART data register empty interrupt
+		 **/
+		void transmit();
+
+		/**
+		 *	Waits until queued lines have been sent. Interrupts must be enabled
+		 **/
+		void flush();
+
+		/**
+		 *	Gets dropped bytes count
+		 *	@returns	bytes dropped since boot
+		 **/
+		unsigned long get_dropped_bytes() const { return _dropped_bytes; }
+
+		/**
+		 *	Gets dropped lines count
+		 *	@returns	lines dropped since boot
+		 **/
+		unsigned int get_dropped_lines() const { return _dropped_lines; }
+
+	private:
+		/**
+		 *	Queued bytes ring
+		 **/
+		uint8_t _bytes[APP_LOG_BUFFER];
+
+		/**
+		 *	Position past the last complete line, the interrupt sends bytes up to it
+		 **/
+		volatile uint16_t _head;
+
+		/**
+		 *	Position of the next byte to send
+		 **/
+		volatile uint16_t _tail;
+
+		/**
+		 *	Position the next byte of the line being written goes to
+		 **/
+		uint16_t _write;
+
+		/**
+		 *	Indicates whether the rest of the line being written is dropped
+		 **/
+		bool _dropping;
+
+		/**
+		 *	Dropped bytes count
+		 **/
+		unsigned long _dropped_bytes;
+
+		/**
+		 *	Dropped lines count
+		 **/
+		unsigned int _dropped_lines;
+
+		/**
+		 *	Drops the line being written
+		 **/
+		void drop_newest();
+
+		/**
+		 *	Drops the oldest queued line after the one being transmitted
+		 *	@returns	true if a line has been dropped, false if there's none
+		 **/
+		bool drop_oldest();
+
+		/**
+		 *	Gets a line's length
+		 *	@param		pos		line's position
+		 *	@returns	bytes up to and including the line's '\n'
+		 **/
+		uint16_t get_line_length(uint16_t pos) const;
+
+		/**
+		 *	Wraps a position around the ring
+		 *	@param		pos		a position, less than twice the ring's length
+		 *	@returns	the position within the ring
+		 **/
+		static uint16_t wrap(uint16_t pos) { return pos >= APP_LOG_BUFFER ? pos - APP_LOG_BUFFER : pos; }
+	};
 	
 	/**
 	 *	Log event writer
@@ -75,15 +242,29 @@ namespace thermograph
 
 		/**
 		 *	Appends a formatted text into log
-		 *	@param	msg	format string
+		 *	@param	format	format string
+		 *	@param	args	format arguments
+		 **/
+		template<typename... A>
+		void printf(const char* format, const A&... args);
+
+		/**
+		 *	Appends a formatted text into log
+		 *	@param	format	format string
+		 *	@param	args	format arguments
 		 **/
-		void printf(const char* msg, ...);
+		template<typename... A>
+		void printf(const __FlashStringHelper* format, const A&... args);
 
+#ifdef APP_LOG_BINARY
 		/**
 		 *	Appends a formatted text into log
-		 *	@param	msg	format string
+		 *	@param	format	format string's ID
+		 *	@param	args	format arguments
 		 **/
-		void printf(__FlashStringHelper* msg, ...);
+		template<typename... A>
+		void printf(format_id_t format, const A&... args);
+#endif
 
 	private:
 		/**
@@ -93,11 +274,18 @@ namespace thermograph
 	};
 
 	/**
-	 *	Logger class
+	 *	Logger class.
+	 *	Messages are written unconditionally, modules log through LOG_ERR, LOG_INF and LOG_DBG
+	 *	which compile out levels disabled by APP_LOG_LEVEL_* in "_config.h"
 	 **/
 	class log_t
 	{
 	public:
+		/**
+		 *	Constructor
+		 **/
+		log_t();
+
 		/**
 		 *	Initializes logging
 		 *	@param	baud	serial port baud rate
@@ -105,68 +293,170 @@ namespace thermograph
 		void init(const long baud);
 
 		/**
-		 *	Writes a formatted message with ERR log level into log
-		 *	@param	msg	format string
+		 *	Waits until queued messages have been sent, for bursts longer than the log buffer at boot.
+		 *	Interrupts must be enabled
 		 **/
-		void error(const char* msg, ...);
+		void flush() { _buffer.flush(); }
 
 		/**
-		 *	Writes a formatted message with INF log level into log
-		 *	@param	msg	format string
+		 *	Writes a formatted message with ERR log level into log
+		 *	@param	format	format string
+		 *	@param	args	format arguments
 		 **/
-		void info(const char* msg, ...);
+		template<typename... A>
+		void error(const char* format, const A&... args);
 
 		/**
-		 *	Writes a formatted message with DBG log level into log
-		 *	@param	msg	format string
+		 *	Writes a formatted message with ERR log level into log
+		 *	@param	format	format string
+		 *	@param	args	format arguments
 		 **/
-		void debug(const char* msg, ...);
-
+		template<typename... A>
+		void error(log_format_t format, const A&... args);
 
 		/**
-		 *	Writes a formatted message with ERR log level into log
-		 *	@param	msg	format string
+		 *	Writes a formatted message with INF log level into log
+		 *	@param	format	format string
+		 *	@param	args	format arguments
 		 **/
-		void error(__FlashStringHelper* msg, ...);
+		template<typename... A>
+		void info(const char* format, const A&... args);
 
 		/**
 		 *	Writes a formatted message with INF log level into log
-		 *	@param	msg	format string
+		 *	@param	format	format string
+		 *	@param	args	format arguments
 		 **/
-		void info(__FlashStringHelper* msg, ...);
+		template<typename... A>
+		void info(log_format_t format, const A&... args);
 
 		/**
 		 *	Writes a formatted message with DBG log level into log
-		 *	@param	msg	format string
+		 *	@param	format	format string
+		 *	@param	args	format arguments
 		 **/
-		void debug(__FlashStringHelper* msg, ...);
+		template<typename... A>
+		void debug(const char* format, const A&... args);
 
+		/**
+		 *	Writes a formatted message with DBG log level into log
+		 *	@param	format	format string
+		 *	@param	args	format arguments
+		 **/
+		template<typename... A>
+		void debug(log_format_t format, const A&... args);
+
+		/**
+		 *	Writes a formatted message into log unless its call site has written one within
+		 *	the call site's window, counts the repeat otherwise
+		 *	@param	level	log level
+		 *	@param	window	call site's window, in milliseconds
+		 *	@param	format	format string, identifies the call site
+		 *	@param	args	format arguments
+		 **/
+		template<typename... A>
+		void limited(log_level level, unsigned long window, log_format_t format, const A&... args);
 
 		/**
 		 *	Starts writing an event using log event writer.
+		 *	The event isn't filtered by module levels, guard it with LOG_ENABLED
+		 *	so that a disabled event compiles out along with the code composing it.
 		 *	@param		level	log level
 		 *	@returns	log event writer
 		 **/
 		log_event_t begin_event(log_level level);
 
+		/**
+		 *	Writes dropped log text statistics and repeat counts of rate limited messages
+		 *	whose window has passed into log
+		 **/
+		void log_stats();
+
+		/**
+		 *	Sends the next queued byte, called by the USART data register empty interrupt
+		 **/
+		void on_transmit() { _buffer.transmit(); }
+
 	private:
 		friend class log_event_t;
 
+		/**
+		 *	Rate limited call site
+		 **/
+		struct repeat_t
+		{
+			/**
+			 *	Call site's format string, a value-initialized one if the slot is free
+			 **/
+			log_format_t format;
+
+			/**
+			 *	Time the call site's window ends at, in milliseconds
+			 **/
+			unsigned long expires;
+
+			/**
+			 *	Repeats counted since
+			 **/
+			uint16_t count;
+
+			/**
+			 *	Call site's log level
+			 **/
+			uint8_t level;
+		};
+
+		/**
+		 *	Output buffer
+		 **/
+		log_buffer_t _buffer;
+
+		/**
+		 *	Rate limited call sites
+		 **/
+		repeat_t _repeats[APP_LOG_REPEAT_SLOTS];
+
+		/**
+		 *	Checks whether a rate limited message is to be written, counts it as a repeat otherwise
+		 *	@param		level	log level
+		 *	@param		window	call site's window, in milliseconds
+		 *	@param		format	format string, identifies the call site
+		 *	@returns	true if the message is to be written
+		 **/
+		bool admit(log_level level, unsigned long window, log_format_t format);
+
+		/**
+		 *	Writes a call site's repeat count into log and resets it
+		 *	@param	repeat	rate limited call site
+		 **/
+		void print_repeats(repeat_t& repeat);
+
 		/**
 		 *	Writes a formatted message into log
 		 *	@param	level	log level
 		 *	@param	format	format string
-		 *	@params	args	format arguments list
+		 *	@param	flash	indicates whether the format string is in flash memory
+		 *	@param	args	format arguments, ending with FORMAT_ARG_NONE
 		 **/
-		void print(log_level level, const char* format, va_list args);
+		void print(log_level level, const char* format, bool flash, const format_arg_t* args);
 
 		/**
 		 *	Writes a formatted message into log
 		 *	@param	level	log level
-		 *	@param	format	format string
-		 *	@params	args	format arguments list
+		 *	@param	format	format string in flash memory
+		 *	@param	args	format arguments, ending with FORMAT_ARG_NONE
+		 **/
+		void print(log_level level, const __FlashStringHelper* format, const format_arg_t* args) { print(level, reinterpret_cast<const char*>(format), true, args); }
+
+#ifdef APP_LOG_BINARY
+		/**
+		 *	Writes a formatted message into log
+		 *	@param	level	log level
+		 *	@param	format	format string's ID
+		 *	@param	args	format arguments, ending with FORMAT_ARG_NONE
 		 **/
-		void print(log_level level, __FlashStringHelper* format, va_list args);
+		void print(log_level level, format_id_t format, const format_arg_t* args);
+#endif
 
 		/**
 		 *	Writes a log message header
@@ -175,46 +465,295 @@ namespace thermograph
 		void print_header(log_level level);
 
 		/**
-		 *	Writes a formatted global time into log
-		 *	@param	time global time
+		 *	Ends a log message
 		 **/
-		void print_time(const time_t& time);
+		void print_end();
 
 		/**
-		 *	Writes a formatted local time into log
-		 *	@param	time local time
+		 *	Writes a formatted message into log
+		 *	@param	format	format string
+		 *	@param	flash	indicates whether the format string is in flash memory
+		 *	@param	args	format arguments, ending with FORMAT_ARG_NONE
 		 **/
-		void print_time(const sys_time_t& time);
+		void print_message(const char* format, bool flash, const format_arg_t* args);
 
 		/**
-		 *	Writes a formatted decimal number into log
-		 *	@param	value		a number to write
-		 *	@param	precision	amount of decimal places
-		 *	@param	placeholder	a placeholder character
+		 *	High half of the last binary record's timestamp. It starts as 0xFFFF, which millis() doesn't reach
+		 *	until day 49, so the first record after boot carries a full timestamp
 		 **/
-		void print_formatted_number(int value, int precision, char placeholder = '0');
+		uint16_t _time_high;
 
 		/**
-		 *	Writes a formatted message into log
-		 *	@param	format	format string
-		 *	@params	args	format arguments list
+		 *	Writes a binary log record header
+		 *	@param	level	log level
 		 **/
-		void print_message(const char* format, va_list args);
+		void write_header(log_level level);
 
 		/**
-		 *	Writes a formatted message into log
+		 *	Writes a format string's ID and its arguments into a binary log record
 		 *	@param	format	format string
-		 *	@params	args	format arguments list
+		 *	@param	flash	indicates whether the format string is in flash memory
+		 *	@param	args	format arguments, ending with FORMAT_ARG_NONE
+		 **/
+		void write_message(const char* format, bool flash, const format_arg_t* args);
+
+		/**
+		 *	Writes a format string's ID and its arguments into a binary log record
+		 *	@param	format	format string's ID
+		 *	@param	args	format arguments, ending with FORMAT_ARG_NONE
 		 **/
-		void print_message(__FlashStringHelper* format, va_list args);
+		void write_message(format_id_t format, const format_arg_t* args);
+
+		/**
+		 *	Writes an argument into a binary log record
+		 *	@param	type	argument type the record holds
+		 *	@param	arg		the argument, NULL writes a zero value
+		 **/
+		void write_arg(format_arg_type type, const format_arg_t* arg);
+
+		/**
+		 *	Writes a zigzag varint into a binary log record
+		 *	@param	value	a value to write
+		 **/
+		void write_varint(long value);
+
+		/**
+		 *	Writes bytes into a binary log record
+		 *	@param	data	bytes to write
+		 *	@param	length	bytes count
+		 **/
+		void write_bytes(const void* data, size_t length);
+
+		/**
+		 *	Writes a byte into a binary log record, escaping the record delimiter
+		 *	@param	b	a byte to write
+		 **/
+		void write_byte(uint8_t b);
 	};
 
 	/**
 	 *	Logger static instance
 	 **/
 	extern log_t log;
-}
 
+	/**
+	 *	Appends a formatted text into log
+	 *	@param	format	format string
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_event_t::printf(const char* format, const A&... args)
+	{
+		if(_enable)
+		{
+			const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+			log.print_message(format, false, list);
+		}
+	}
+
+	/**
+	 *	Appends a formatted text into log
+	 *	@param	format	format string
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_event_t::printf(const __FlashStringHelper* format, const A&... args)
+	{
+		if(_enable)
+		{
+			const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+			log.print_message(reinterpret_cast<const char*>(format), true, list);
+		}
+	}
+
+#ifdef APP_LOG_BINARY
+	/**
+	 *	Appends a formatted text into log
+	 *	@param	format	format string's ID
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_event_t::printf(format_id_t format, const A&... args)
+	{
+		if(_enable)
+		{
+			const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+			log.write_message(format, list);
+		}
+	}
+#endif
+
+	/**
+	 *	Writes a formatted message with ERR log level into log
+	 *	@param	format	format string
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_t::error(const char* format, const A&... args)
+	{
+		const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+		print(LOG_ERROR, format, false, list);
+	}
+
+	/**
+	 *	Writes a formatted message with ERR log level into log
+	 *	@param	format	format string
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_t::error(log_format_t format, const A&... args)
+	{
+		const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+		print(LOG_ERROR, format, list);
+	}
+
+	/**
+	 *	Writes a formatted message with INF log level into log
+	 *	@param	format	format string
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_t::info(const char* format, const A&... args)
+	{
+		const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+		print(LOG_INFO, format, false, list);
+	}
+
+	/**
+	 *	Writes a formatted message with INF log level into log
+	 *	@param	format	format string
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_t::info(log_format_t format, const A&... args)
+	{
+		const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+		print(LOG_INFO, format, list);
+	}
+
+	/**
+	 *	Writes a formatted message with DBG log level into log
+	 *	@param	format	format string
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_t::debug(const char* format, const A&... args)
+	{
+		const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+		print(LOG_DEBUG, format, false, list);
+	}
 
+	/**
+	 *	Writes a formatted message with DBG log level into log
+	 *	@param	format	format string
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_t::debug(log_format_t format, const A&... args)
+	{
+		const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+		print(LOG_DEBUG, format, list);
+	}
 
+	/**
+	 *	Writes a formatted message into log unless its call site has written one within
+	 *	the call site's window, counts the repeat otherwise
+	 *	@param	level	log level
+	 *	@param	window	call site's window, in milliseconds
+	 *	@param	format	format string, identifies the call site
+	 *	@param	args	format arguments
+	 **/
+	template<typename... A>
+	void log_t::limited(log_level level, unsigned long window, log_format_t format, const A&... args)
+	{
+		if(admit(level, window, format))
+		{
+			const format_arg_t list[] = { format_arg_t(args)..., format_arg_t() };
+			print(level, format, list);
+		}
+	}
+}
 
+/**
+ *	Gets a LOG_* macro's format string as log_format_t: the F() string, or its ID computed at compile time
+ *	if APP_LOG_BINARY is defined, so the string isn't stored
+ *	@param	literal	format string literal
+ *	@param	format	F() format string literal
+ **/
+#ifdef APP_LOG_BINARY
+#define LOG_FORMAT(literal, format) thermograph::format_id_constant<thermograph::format_id(literal, LOG_FORMAT_SEED)>()
+#else
+#define LOG_FORMAT(literal, format) format
+#endif
+
+/**
+ *	Checks whether a module's messages of a log level are compiled in, a constant expression
+ *	@param	module	SENSOR, DISPLAY, HISTORY or APP, see APP_LOG_LEVEL_* in "_config.h"
+ *	@param	level	LOG_ERROR, LOG_INFO or LOG_DEBUG
+ **/
+#define LOG_ENABLED(module, level) (thermograph::level <= thermograph::APP_LOG_LEVEL_##module)
+
+/**
+ *	Writes a formatted message with ERR log level into log if the module's level allows it,
+ *	the arguments aren't evaluated otherwise. The format string is checked against the arguments at compile time
+ *	@param	module	SENSOR, DISPLAY, HISTORY or APP
+ *	@param	format	F() format string literal
+ *	@param	...		format arguments
+ **/
+#define LOG_ERR(module, format, ...) do { FORMAT_CHECK(FORMAT_LITERAL_##format, ##__VA_ARGS__); if(LOG_ENABLED(module, LOG_ERROR)) thermograph::log.error(LOG_FORMAT(FORMAT_LITERAL_##format, format), ##__VA_ARGS__); } while(0)
+
+/**
+ *	Writes a formatted message with INF log level into log if the module's level allows it,
+ *	the arguments aren't evaluated otherwise. The format string is checked against the arguments at compile time
+ *	@param	module	SENSOR, DISPLAY, HISTORY or APP
+ *	@param	format	F() format string literal
+ *	@param	...		format arguments
+ **/
+#define LOG_INF(module, format, ...) do { FORMAT_CHECK(FORMAT_LITERAL_##format, ##__VA_ARGS__); if(LOG_ENABLED(module, LOG_INFO)) thermograph::log.info(LOG_FORMAT(FORMAT_LITERAL_##format, format), ##__VA_ARGS__); } while(0)
+
+/**
+ *	Writes a formatted message with DBG log level into log if the module's level allows it,
+ *	the arguments aren't evaluated otherwise. The format string is checked against the arguments at compile time
+ *	@param	module	SENSOR, DISPLAY, HISTORY or APP
+ *	@param	format	F() format string literal
+ *	@param	...		format arguments
+ **/
+#define LOG_DBG(module, format, ...) do { FORMAT_CHECK(FORMAT_LITERAL_##format, ##__VA_ARGS__); if(LOG_ENABLED(module, LOG_DEBUG)) thermograph::log.debug(LOG_FORMAT(FORMAT_LITERAL_##format, format), ##__VA_ARGS__); } while(0)
+
+/**
+ *	Writes a rate limited formatted message with ERR log level into log if the module's level allows it.
+ *	The format string is checked against the arguments at compile time
+ *	@param	module	SENSOR, DISPLAY, HISTORY or APP
+ *	@param	site	call site's name, its window is APP_LOG_REPEAT_WINDOW_<site> in "_config.h"
+ *	@param	format	F() format string literal
+ *	@param	...		format arguments
+ **/
+#define LOG_ERR_LIMITED(module, site, format, ...) do { FORMAT_CHECK(FORMAT_LITERAL_##format, ##__VA_ARGS__); if(LOG_ENABLED(module, LOG_ERROR)) thermograph::log.limited(thermograph::LOG_ERROR, APP_LOG_REPEAT_WINDOW_##site, LOG_FORMAT(FORMAT_LITERAL_##format, format), ##__VA_ARGS__); } while(0)
+
+/**
+ *	Writes a rate limited formatted message with INF log level into log if the module's level allows it.
+ *	The format string is checked against the arguments at compile time
+ *	@param	module	SENSOR, DISPLAY, HISTORY or APP
+ *	@param	site	call site's name, its window is APP_LOG_REPEAT_WINDOW_<site> in "_config.h"
+ *	@param	format	F() format string literal
+ *	@param	...		format arguments
+ **/
+#define LOG_INF_LIMITED(module, site, format, ...) do { FORMAT_CHECK(FORMAT_LITERAL_##format, ##__VA_ARGS__); if(LOG_ENABLED(module, LOG_INFO)) thermograph::log.limited(thermograph::LOG_INFO, APP_LOG_REPEAT_WINDOW_##site, LOG_FORMAT(FORMAT_LITERAL_##format, format), ##__VA_ARGS__); } while(0)
+
+/**
+ *	Writes a rate limited formatted message with DBG log level into log if the module's level allows it.
+ *	The format string is checked against the arguments at compile time
+ *	@param	module	SENSOR, DISPLAY, HISTORY or APP
+ *	@param	site	call site's name, its window is APP_LOG_REPEAT_WINDOW_<site> in "_config.h"
+ *	@param	format	F() format string literal
+ *	@param	...		format arguments
+ **/
+#define LOG_DBG_LIMITED(module, site, format, ...) do { FORMAT_CHECK(FORMAT_LITERAL_##format, ##__VA_ARGS__); if(LOG_ENABLED(module, LOG_DEBUG)) thermograph::log.limited(thermograph::LOG_DEBUG, APP_LOG_REPEAT_WINDOW_##site, LOG_FORMAT(FORMAT_LITERAL_##format, format), ##__VA_ARGS__); } while(0)
+
+/**
+ *	Appends a formatted text into a log event, the format string is checked against the arguments at compile time
+ *	@param	event	log event writer
+ *	@param	format	F() format string literal
+ *	@param	...		format arguments
+ **/
+#define LOG_APPEND(event, format, ...) do { FORMAT_CHECK(FORMAT_LITERAL_##format, ##__VA_ARGS__); (event).printf(LOG_FORMAT(FORMAT_LITERAL_##format, format), ##__VA_ARGS__); } while(0)
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+/*
+ * IDs of the firmware's format strings, used by the binary log protocol.
+ * Generated by host/gen_log_formats.cpp, do not edit.
+ */
+
+/*
+ * Format string ID hash seed, every format string has a distinct ID with it
+ */
+#define LOG_FORMAT_SEED 0x0000
+
+/*
+ * Format strings by ID, for the log decoder
+ */
+#ifdef LOG_FORMAT_TABLE
+static const struct
+{
+	uint16_t id;
+	const char* format;
+} log_formats[] =
+{
+	{ 0x0021, "] " },
+	{ 0x0139, "(%h, %d) " },
+	{ 0x0383, "t = %h deg C, " },
+	{ 0x0B6E, "adc_scanner\tstart(): channels = %B" },
+	{ 0x0EE8, "Dew point  " },
+	{ 0x111A, "thermistor_sensor\tupdate(%u): A = %d + %d/64, t = %h deg C" },
+	{ 0x1208, "Temp  " },
+	{ 0x20B6, "DBG" },
+	{ 0x230C, "app\tstarted" },
+	{ 0x29E7, "%s: t = %h deg C, h = %h%%, " },
+	{ 0x31D1, "sensor poll" },
+	{ 0x3230, "dht_sensor\tupdate(): sensor hasn't completed its reading" },
+	{ 0x32B7, "Humidity  " },
+	{ 0x32C3, "%s: " },
+	{ 0x3339, "VALUE_HUMIDITY" },
+	{ 0x3341, "data_history\tproject(): %d buckets in %d bytes, to %h [ " },
+	{ 0x34A2, "display\tdone" },
+	{ 0x3562, "<N/A>, " },
+	{ 0x3925, "%h%%" },
+	{ 0x40E9, "    " },
+	{ 0x4235, "dht_sensor\tupdate(): unable to read data from sensor, status = %d" },
+	{ 0x429F, "false" },
+	{ 0x4365, "Temp chart " },
+	{ 0x47CF, "data_history\tchart cache: hits = %l, misses = %l" },
+	{ 0x4BAB, "Humidity   " },
+	{ 0x4F97, "dht_sensor\tinit()" },
+	{ 0x5453, "temperature_display_mode\tprint_temperature(): temperature = " },
+	{ 0x54C0, "temperature_display_mode\tprint_temperature(): humidity = " },
+	{ 0x56F1, "log\trepeated %d times: %m" },
+	{ 0x5E53, "scheduler\tadd(): task #%d, period = %l ms, budget = %l ms" },
+	{ 0x5ED3, "display\tinit" },
+	{ 0x635C, "condensed_display_mode\tprint(): temperature = " },
+	{ 0x661B, "lm35_sensor\tupdate(): raw = %l, temp = %h" },
+	{ 0x6A13, ", active value = " },
+	{ 0x6E86, "data_history\tadvance(): new data point, t = %h deg, rev = #%d" },
+	{ 0x6EE3, "]" },
+	{ 0x708E, "scheduler\tadd(): too many tasks" },
+	{ 0x792B, "h = <N/A>, " },
+	{ 0x7959, "expanded_display_mode\thandle(const button): active sensor = #%d (%s)" },
+	{ 0x7B78, "scheduler\t" },
+	{ 0x7FE2, "0x" },
+	{ 0x80EF, "%h deg C" },
+	{ 0x821B, "app\tboot" },
+	{ 0x8758, ": runs = %l, overruns = %l, jitter = %l ms, max jitter = %l ms, max duration = %l ms" },
+	{ 0x8B0A, "temperature_chart_display_mode\tprint_chart(): tier %d, metric %s, rev = #%d" },
+	{ 0x90E0, "round = %l ms" },
+	{ 0x9DE7, "Temperature" },
+	{ 0xA2E6, "Humidity" },
+	{ 0xA7C8, "stats" },
+	{ 0xAB4A, "--.-" },
+	{ 0xADEA, "data_history\tinit(): %d of %d checkpoints restored in %l ms" },
+	{ 0xB5F4, "sensor_service\tupdate(): " },
+	{ 0xBA09, "data_history\t%s, %s: no data" },
+	{ 0xC207, "display" },
+	{ 0xC29C, "thermistor_sensor\tupdate(%u): A = %d, temp. point not found" },
+	{ 0xC2AA, "INF" },
+	{ 0xC93C, "sensor_service\tinit(): %d channels" },
+	{ 0xCC48, "VALUE_TEMPERATURE" },
+	{ 0xCF1A, "adc_scanner\tadd(): channel = %d, reference = %d, oversampling = %d" },
+	{ 0xCF5C, "data_history\tproject(): %d buckets in %d bytes, avg %h, amp %h -> [ " },
+	{ 0xCFD3, "%h deg C, " },
+	{ 0xDABB, "   " },
+	{ 0xE0B6, "<N/A>" },
+	{ 0xE29C, "0b" },
+	{ 0xE34A, "t = <N/A>, " },
+	{ 0xE497, "app\trun mode switced to #%d" },
+	{ 0xE5EA, "sensor" },
+	{ 0xE6BF, "humidity = <N/A>" },
+	{ 0xE77F, "history" },
+	{ 0xE7DA, "data_history\t%s, %s: %d buckets, min = %h, max = %h, mean = %h, first = %h, last = %h, slope = %l/h" },
+	{ 0xE816, "- " },
+	{ 0xE9E6, "h = %h%%, " },
+	{ 0xEA16, "ERR" },
+	{ 0xEB7F, "true" },
+	{ 0xEE5B, "log\tstats: %l bytes in %l lines dropped" },
+	{ 0xEFFB, "button" },
+	{ 0xF648, "sensor_service\tupdate(): previous round hasn't completed" },
+	{ 0xF931, "dht_sensor\ttrigger(): sensor is busy" },
+	{ 0xFEA1, "humidity = %h%%" },
+	{ 0xFF02, "data_history\tadvance(): gap, rev = #%d" },
+};
+#endif
\ No newline at end of file
@@ -5,7 +5,6 @@
 #include "log.h"
 #include "mode.h"
 #include "sensor.h"
-#include "util.h"
 
 using namespace thermograph;
 
@@ -17,17 +16,17 @@ using namespace thermograph;
 */
 
 /**
-*	Handles events
+*	Handles button events
 *	@returns	an event code
 **/
-mode_event mode_t::handle_events()
+mode_event thermograph::mode_t::handle_events()
 {
 	button btn = button_service.read_button();
 
 	switch (btn)
 	{
 	case thermograph::BTN_NONE:
-		return handle();
+		return ME_NONE;
 
 	case thermograph::BTN_SELECT:
 		return ME_SWITCH_MODE;
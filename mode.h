@@ -1,6 +1,7 @@
 #pragma once
 
 #include "button.h"
+#include "data_history.h"
 #include "sensor.h"
 
 namespace thermograph
@@ -26,12 +27,13 @@ namespace thermograph
 	 **/
 	class mode_t
 	{
-	public:
+	protected:
 		/**
-		 *	Destructor
+		 *	Destructor, modes are static members of the app
 		 **/
-		virtual ~mode_t() { }
+		~mode_t() { }
 
+	public:
 		/**
 		 *	Initializes an app mode
 		 **/
@@ -43,16 +45,26 @@ namespace thermograph
 		virtual void enter() { }
 
 		/**
-		 *	Handles events
+		 *	Handles button events
 		 *	@returns	an event code
 		 **/
 		mode_event handle_events();
+
+		/**
+		 *	Updates display
+		 **/
+		void refresh() { handle(); }
 		
 	protected:
+		/**
+		 *	A placeholder for a value that hasn't been displayed yet
+		 **/
+		static const int NO_VALUE = -32767 - 1;
+
 		/**
 		 *	Handles empty button event
 		 **/
-		virtual mode_event handle() { }
+		virtual mode_event handle() { return ME_NONE; }
 
 		/**
 		 *	Handles button event
@@ -104,7 +116,7 @@ namespace thermograph
 
 	private:
 		/**
-		 *	Last displayed temperature
+		 *	Last displayed value, in whole units
 		 **/
 		int _last_value;
 
@@ -165,12 +177,12 @@ namespace thermograph
 
 	private:
 		/**
-		 *	Last displayed temperature
+		 *	Last displayed temperature, in tenths of Celsius degree
 		 **/
 		int _last_temperature;
 
 		/**
-		 *	Last displayed humidity
+		 *	Last displayed humidity, in tenths of percent
 		 **/
 		int _last_humidity;
 
@@ -183,10 +195,16 @@ namespace thermograph
 		 *	Prints current values
 		 **/
 		void print();
+
+		/**
+		 *	Prints a value
+		 *	@param	value	a value, in tenths
+		 **/
+		void print_value(int value);
 	};
 
 	/**
-	 *	Temperature chart app mode
+	 *	Chart app mode, plots any history metric of a sensor
 	 **/
 	class temperature_chart_display_mode_t : public mode_t
 	{
@@ -219,11 +237,32 @@ namespace thermograph
 		 *	Active sensor ID
 		 **/
 		sensor_id _sensor_id;
+
+		/**
+		 *	Active history tier
+		 **/
+		uint8_t _tier;
+
+		/**
+		 *	Active history metric
+		 **/
+		history_metric _metric;
 		
 		/**
-		 *	Prints a temperature plot
+		 *	Prints a metric's plot
 		 *	@param	force	disable data revision check
 		 **/
 		void print_chart(bool force);
+
+		/**
+		 *	Prints a chart's title, the plotted metric
+		 **/
+		void print_title();
+
+		/**
+		 *	Prints a chart's time span
+		 *	@param	span	time span, in seconds
+		 **/
+		void print_span(unsigned long span);
 	};
 }
\ No newline at end of file
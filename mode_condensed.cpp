@@ -4,8 +4,8 @@
 #include "display.h"
 #include "log.h"
 #include "mode.h"
+#include "number_format.h"
 #include "sensor.h"
-#include "util.h"
 
 using namespace thermograph;
 
@@ -21,8 +21,8 @@ using namespace thermograph;
 **/
 void condensed_display_mode_t::enter()
 {
-	_last_temperature = 0;
-	_last_humidity = 0;
+	_last_temperature = NO_VALUE;
+	_last_humidity = NO_VALUE;
 	display.text().clear();
 	print();
 }
@@ -46,14 +46,19 @@ mode_event condensed_display_mode_t::handle(const button btn)
 	switch (btn)
 	{
 	case BTN_UP:
+		_sensor_id = (_sensor_id == 0) ? SENSOR_COUNT - 1 : _sensor_id - 1;
+		break;
+
 	case BTN_DOWN:
-		_sensor_id = (_sensor_id == SENSOR_ID_INDOOR) ? SENSOR_ID_OUTDOOR : SENSOR_ID_INDOOR;
+		_sensor_id = (_sensor_id + 1) % SENSOR_COUNT;
+		break;
+
 	default:
 		break;
 	}
 
-	_last_temperature = 0;
-	_last_humidity = 0;
+	_last_temperature = NO_VALUE;
+	_last_humidity = NO_VALUE;
 	print();
 	return ME_NONE;
 }
@@ -63,21 +68,16 @@ mode_event condensed_display_mode_t::handle(const button btn)
 **/
 void condensed_display_mode_t::print()
 {
-	bool temperature_outdated = false;
+	// An unavailable reading turns into NO_VALUE, so it's printed as such
 	optional_t<temperature_t> temperature = sensor.get_temperature(_sensor_id);
-	if(temperature.has_value() && _last_temperature != temperature.value())
-	{
-		_last_temperature = static_cast<int>(10 * temperature.value());
-		temperature_outdated = true;
-	}
+	int t = temperature.has_value() ? temperature.value() / 10 : NO_VALUE;
+	bool temperature_outdated = _last_temperature != t;
+	_last_temperature = t;
 
-	bool humidity_outdated = false;
 	optional_t<humidity_t> humidity = sensor.get_humidity(_sensor_id);
-	if(humidity.has_value() && _last_humidity != humidity.value())
-	{
-		_last_humidity = static_cast<int>(10 * humidity.value());
-		humidity_outdated = true;
-	}
+	int h = humidity.has_value() ? humidity.value() / 10 : NO_VALUE;
+	bool humidity_outdated = _last_humidity != h;
+	_last_humidity = h;
 
 	if(!temperature_outdated && !humidity_outdated)
 	{
@@ -87,43 +87,53 @@ void condensed_display_mode_t::print()
 	display.text().clear();
 
 	display.text().setCursor(0, 0);
-	display.text().print("Temp  ");
-	if(_last_temperature >= 100)
-	{
-		display.text().print(util::get_number(_last_temperature, 2));
-	}
-	display.text().print(util::get_number(_last_temperature, 1));
-	display.text().print('.');
-	display.text().print(util::get_number(_last_temperature, 0));
+	display.text().print(F("Temp  "));
+	print_value(_last_temperature);
 	display.text().print('\xDF');
 	display.text().print('C');
 	display.text().print(' ');
+	display.text().print(sensor.get_label(_sensor_id));
+
+	display.text().setCursor(0, 1);
+	display.text().print(F("Humidity  "));
+	print_value(_last_humidity);
+	display.text().print('%');
 
-	switch (_sensor_id)
+	if(LOG_ENABLED(DISPLAY, LOG_DEBUG))
 	{
-	case SENSOR_ID_OUTDOOR:
-		display.text().print("out");
-		break;
-	case SENSOR_ID_INDOOR:
-		display.text().print("in");
-		break;
-	default:
-		break;
+		log_event_t e = log.begin_event(LOG_DEBUG);
+		LOG_APPEND(e, F("condensed_display_mode\tprint(): temperature = "));
+		if(temperature.has_value())
+		{
+			LOG_APPEND(e, F("%h deg C, "), temperature.value());
+		}
+		else
+		{
+			LOG_APPEND(e, F("<N/A>, "));
+		}
+
+		if(humidity.has_value())
+		{
+			LOG_APPEND(e, F("humidity = %h%%"), humidity.value());
+		}
+		else
+		{
+			LOG_APPEND(e, F("humidity = <N/A>"));
+		}
 	}
+}
 
-	display.text().setCursor(0, 1);
-	display.text().print("Humidity  ");
-	if(_last_humidity >= 100)
+/**
+*	Prints a value
+*	@param	value	a value, in tenths
+**/
+void condensed_display_mode_t::print_value(int value)
+{
+	if(value == NO_VALUE)
 	{
-		display.text().print(util::get_number(_last_humidity, 2));
+		display.text().print(F("--.-"));
+		return;
 	}
-	display.text().print(util::get_number(_last_humidity, 1));
-	display.text().print('.');
-	display.text().print(util::get_number(_last_humidity, 0));
-	display.text().print('%');
 
-	log.debug(
-		F("temperature_and_time_display_mode\tprint_temperature(): temperature = %d deg C, humidity = %d%%"), 
-		_last_temperature / 10,
-		_last_humidity / 10);
+	number_format_t(value, 1).print(display.text());
 }
\ No newline at end of file
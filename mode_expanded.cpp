@@ -4,8 +4,8 @@
 #include "display.h"
 #include "log.h"
 #include "mode.h"
+#include "number_format.h"
 #include "sensor.h"
-#include "util.h"
 
 using namespace thermograph;
 
@@ -23,7 +23,7 @@ using namespace thermograph;
 **/
 void expanded_display_mode_t::enter()
 {
-	_last_value = 0;
+	_last_value = NO_VALUE;
 	display.text().clear();
 	update_display();
 }
@@ -47,8 +47,11 @@ mode_event expanded_display_mode_t::handle(const button btn)
 	switch (btn)
 	{
 	case BTN_LEFT:
+		_sensor_id = (_sensor_id == 0) ? SENSOR_COUNT - 1 : _sensor_id - 1;
+		break;
+
 	case BTN_RIGHT:
-		_sensor_id = (_sensor_id == SENSOR_ID_INDOOR) ? SENSOR_ID_OUTDOOR : SENSOR_ID_INDOOR;
+		_sensor_id = (_sensor_id + 1) % SENSOR_COUNT;
 		break;
 
 	case BTN_UP:
@@ -60,36 +63,26 @@ mode_event expanded_display_mode_t::handle(const button btn)
 		return ME_NONE;
 	}
 
+	if(LOG_ENABLED(DISPLAY, LOG_INFO))
 	{
 		log_event_t e = log.begin_event(LOG_INFO);
-		e.printf(F("expanded_display_mode\thandle(const button): active sensor = "));
-		switch (_sensor_id)
-		{
-		case SENSOR_ID_OUTDOOR:
-			e.printf(F("SENSOR_ID_OUTDOOR"));
-			break;
-		case SENSOR_ID_INDOOR:
-			e.printf(F("SENSOR_ID_INDOOR"));
-			break;
-		default:
-			break;
-		}
+		LOG_APPEND(e, F("expanded_display_mode\thandle(const button): active sensor = #%d (%s)"), _sensor_id, sensor.get_name(_sensor_id));
 
-		e.printf(F(", active value = "));
+		LOG_APPEND(e, F(", active value = "));
 		switch (_value_id)
 		{
 		case VALUE_TEMPERATURE:
-			e.printf(F("VALUE_TEMPERATURE"));
+			LOG_APPEND(e, F("VALUE_TEMPERATURE"));
 			break;
 		case VALUE_HUMIDITY:
-			e.printf(F("VALUE_HUMIDITY"));
+			LOG_APPEND(e, F("VALUE_HUMIDITY"));
 			break;
 		default:
 			break;
 		}
 	}
 
-	_last_value = 0;
+	_last_value = NO_VALUE;
 	update_display();
 	return ME_NONE;
 }
@@ -116,17 +109,7 @@ void expanded_display_mode_t::update_display()
 void expanded_display_mode_t::print_sensor_name()
 {
 	display.text().setCursor(0, 1);
-	switch (_sensor_id)
-	{
-	case SENSOR_ID_OUTDOOR:
-		display.text().print("outside");
-		break;
-	case SENSOR_ID_INDOOR:
-		display.text().print("in the room");
-		break;
-	default:
-		break;
-	}
+	display.text().print(sensor.get_name(_sensor_id));
 }
 
 /**
@@ -135,7 +118,7 @@ void expanded_display_mode_t::print_sensor_name()
 void expanded_display_mode_t::print_temperature()
 {
 	optional_t<temperature_t> temperature = sensor.get_temperature(_sensor_id);
-	if(temperature.has_value() && temperature.value() == _last_value)
+	if(temperature.has_value() && temperature.value() / 100 == _last_value)
 	{
 		return;
 	}
@@ -143,31 +126,54 @@ void expanded_display_mode_t::print_temperature()
 	display.graphics().clear();
 	display.graphics().clear_text();
 
+	// Two digits fit [-9, 99] degrees, below that the minus takes the 'C' cell. Out of range values are "??"
 	custom_char cc[4] = { CHAR_QUESTION, CHAR_QUESTION, CHAR_DEG, CHAR_C };
 	if(temperature.has_value())
 	{
-		int value = temperature.value();
-		cc[0] = display_t::to_custom_char(value / 10);
-		cc[1] = display_t::to_custom_char(value % 10);
+		int degrees = temperature.value() / 100;
+		number_format_t value(abs(degrees), 0, 2, '0');
+		if(value.length() == 2 && degrees >= 0)
+		{
+			cc[0] = display_t::to_custom_char(value[0] - '0');
+			cc[1] = display_t::to_custom_char(value[1] - '0');
+		}
+		else if(value.length() == 2 && value[0] == '0')
+		{
+			cc[0] = CHAR_MINUS;
+			cc[1] = display_t::to_custom_char(value[1] - '0');
+		}
+		else if(value.length() == 2)
+		{
+			cc[0] = CHAR_MINUS;
+			cc[1] = display_t::to_custom_char(value[0] - '0');
+			cc[2] = display_t::to_custom_char(value[1] - '0');
+			cc[3] = CHAR_DEG;
+		}
 	}
 
 	display.print_g(cc);
 	display.text().setCursor(0, 0);
-	display.text().print("Temperature");
+	display.text().print(F("Temperature"));
 
 	print_sensor_name();
 
-	log_event_t e = log.begin_event(LOG_DEBUG);
-	e.printf(F("temperature_display_mode\tprint_temperature(): temperature = "));
 	if(temperature.has_value())
 	{
-		int v = temperature.value();
-		e.printf(F("%d deg C"), v);
-		_last_value = v;
+		_last_value = temperature.value() / 100;
 	}
-	else
+
+	if(LOG_ENABLED(DISPLAY, LOG_DEBUG))
 	{
-		e.printf(F("<N/A>"));
+		log_event_t e = log.begin_event(LOG_DEBUG);
+		LOG_APPEND(e, F("temperature_display_mode\tprint_temperature(): temperature = "));
+		if(temperature.has_value())
+		{
+			LOG_APPEND(e, F("%h deg C"), temperature.value());
+		}
+		else
+		{
+			LOG_APPEND(e, F("<N/A>"));
+		}
 	}
 }
 
@@ -177,7 +183,7 @@ void expanded_display_mode_t::print_temperature()
 void expanded_display_mode_t::print_humidity()
 {
 	optional_t<humidity_t> humidity = sensor.get_humidity(_sensor_id);
-	if(humidity.has_value() && humidity.value() == _last_value)
+	if(humidity.has_value() && humidity.value() / 100 == _last_value)
 	{
 		return;
 	}
@@ -188,34 +194,38 @@ void expanded_display_mode_t::print_humidity()
 	custom_char cc[4] = { CHAR_QUESTION, CHAR_QUESTION, CHAR_QUESTION, CHAR_PERCENT };
 	if(humidity.has_value())
 	{
-		int value = humidity.value();
-		cc[0] = display_t::to_custom_char(value / 100);
-		if(cc[0] == CHAR_0)
+		number_format_t value(humidity.value() / 100, 0, 3, '0');
+		if(value.length() == 3)
 		{
-			cc[0] = CHAR_NONE;
+			cc[0] = value[0] == '0' ? CHAR_NONE : display_t::to_custom_char(value[0] - '0');
+			cc[1] = display_t::to_custom_char(value[1] - '0');
+			cc[2] = display_t::to_custom_char(value[2] - '0');
 		}
-		value = value % 100;
-		cc[1] = display_t::to_custom_char(value / 10);
-		cc[2] = display_t::to_custom_char(value % 10);
 	}
 
 	display.print_g(cc);
 	display.text().setCursor(0, 0);
-	display.text().print("Humidity");
+	display.text().print(F("Humidity"));
 
 	print_sensor_name();
 
-	log_event_t e = log.begin_event(LOG_DEBUG);
-	e.printf(F("temperature_display_mode\tprint_temperature(): humidity = "));
 	if(humidity.has_value())
 	{
-		int v = humidity.value();
-		e.printf(F("%d%%"), v);
-		_last_value = v;
+		_last_value = humidity.value() / 100;
 	}
-	else
+
+	if(LOG_ENABLED(DISPLAY, LOG_DEBUG))
 	{
-		e.printf(F("<N/A>"));
+		log_event_t e = log.begin_event(LOG_DEBUG);
+		LOG_APPEND(e, F("temperature_display_mode\tprint_temperature(): humidity = "));
+		if(humidity.has_value())
+		{
+			LOG_APPEND(e, F("%h%%"), humidity.value());
+		}
+		else
+		{
+			LOG_APPEND(e, F("<N/A>"));
+		}
 	}
 }
 
@@ -4,15 +4,15 @@
 #include "display.h"
 #include "log.h"
 #include "mode.h"
+#include "number_format.h"
 #include "sensor.h"
-#include "util.h"
 
 using namespace thermograph;
 
 /*
 ************************************************************************
 *	temperature_chart_display_mode_t
-*	Temperature chart app mode
+*	Chart app mode
 ************************************************************************
 */
 
@@ -44,52 +44,118 @@ mode_event temperature_chart_display_mode_t::handle(const button btn)
 {
 	switch (btn)
 	{
+	// LEFT and RIGHT walk over every sensor's metrics
 	case BTN_LEFT:
+		if(_metric == 0)
+		{
+			_metric = static_cast<history_metric>(METRIC_COUNT - 1);
+			_sensor_id = (_sensor_id == 0) ? SENSOR_COUNT - 1 : _sensor_id - 1;
+		}
+		else
+		{
+			_metric = static_cast<history_metric>(_metric - 1);
+		}
+		break;
+
 	case BTN_RIGHT:
-		_sensor_id = (_sensor_id == SENSOR_ID_INDOOR) ? SENSOR_ID_OUTDOOR : SENSOR_ID_INDOOR;
-	default:
+		_metric = static_cast<history_metric>((_metric + 1) % METRIC_COUNT);
+		if(_metric == 0)
+		{
+			_sensor_id = (_sensor_id + 1) % SENSOR_COUNT;
+		}
+		break;
+
+	case BTN_UP:
+		_tier = (_tier + 1) % data_history_t::TIER_COUNT;
+		break;
+
+	case BTN_DOWN:
+		_tier = (_tier == 0) ? data_history_t::TIER_COUNT - 1 : _tier - 1;
 		break;
+
+	default:
+		return ME_NONE;
 	}
 
-	print_chart(false);
+	print_chart(true);
 	return ME_NONE;
 }
 
 /**
-*	Prints a temperature plot
+*	Prints a metric's plot
 *	@param	force	disable data revision check
 **/
 void temperature_chart_display_mode_t::print_chart(bool force)
 {
-	uint8_t rev = data_history.get_revision();
+	int rev = data_history.get_revision(_sensor_id);
 	if(rev == _last_rev && !force)
 	{
 		return;
 	}
 
 	byte points[data_history_t::DATA_POINTS_COUNT];
-	data_history.get_points(_sensor_id, points);
+	data_history.get_points(_sensor_id, _tier, _metric, points, BITMAP_H);
 	display.graphics().barGraph(20, points, ON, UPDATE);
 
 	display.text().setCursor(0, 0);
-	display.text().print("Temp chart");
+	print_title();
 
 	display.text().setCursor(0, 1);
-	char* text;
-	switch (_sensor_id)
+	display.text().print('[');
+	display.text().print(sensor.get_label(_sensor_id));
+	display.text().print(F("] "));
+	print_span(data_history_t::get_span(_tier));
+
+	_last_rev = rev;
+
+	LOG_DBG(DISPLAY, F("temperature_chart_display_mode\tprint_chart(): tier %d, metric %s, rev = #%d"), _tier, data_history_t::get_label(_metric), rev);
+}
+
+/**
+*	Prints a chart's title, the plotted metric
+**/
+void temperature_chart_display_mode_t::print_title()
+{
+	switch (_metric)
 	{
-	case SENSOR_ID_OUTDOOR:
-		text = "[outside]";
+	case METRIC_HUMIDITY:
+		display.text().print(F("Humidity   "));
 		break;
-	case SENSOR_ID_INDOOR:
-		text = "[room]";
+
+	case METRIC_DEW_POINT:
+		display.text().print(F("Dew point  "));
 		break;
+
 	default:
+		display.text().print(F("Temp chart "));
 		break;
 	}
-	display.text().print(text);
+}
 
-	_last_rev = rev;
+/**
+*	Prints a chart's time span in the largest whole units, e.g. "20m", "24h" or "7d"
+*	@param	span	time span, in seconds
+**/
+void temperature_chart_display_mode_t::print_span(unsigned long span)
+{
+	char unit = 's';
+	if(span % 60 == 0)
+	{
+		span /= 60;
+		unit = 'm';
+		if(span % 60 == 0)
+		{
+			span /= 60;
+			unit = 'h';
+			if(span % 24 == 0 && span > 24)
+			{
+				span /= 24;
+				unit = 'd';
+			}
+		}
+	}
 
-	log.debug(F("temperature_chart_display_mode\tprint_chart(): rev = #%d"), rev);
+	number_format_t(span).print(display.text());
+	display.text().print(unit);
+	display.text().print(F("   "));
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "Arduino.h"
+#include "number_format.h"
+
+using namespace thermograph;
+
+/*
+ ************************************************************************
+ *	number_format_t
+ *	Decimal number formatter
+ ************************************************************************
+ */
+
+/**
+ *	Constructor
+ *	@param	value		a number, in units of 10^-decimals
+ *	@param	decimals	decimal places count, up to MAX_DECIMALS
+ *	@param	width		min field width, up to MAX_WIDTH, the sign and the decimal point included
+ *	@param	padding		a character the number is padded with on the left up to the width,
+ *						zeros go after the sign, other characters before it
+ **/
+number_format_t::number_format_t(long value, uint8_t decimals, uint8_t width, char padding)
+	: _start(sizeof(_buffer) - 1), _digits(0), _decimals(min(decimals, MAX_DECIMALS))
+{
+	_buffer[_start] = '\0';
+	width = min(width, MAX_WIDTH);
+
+	bool negative = value < 0;
+	unsigned long n = negative ? 0UL - static_cast<unsigned long>(value) : static_cast<unsigned long>(value);
+
+	// One long division per four digits while the value doesn't fit 16 bits
+	while(n > 0xFFFF)
+	{
+		unsigned long q = n / 10000;
+		uint16_t r = n - q * 10000;
+		uint16_t high = (r * 5243UL) >> 19;
+		put_pair(r - high * 100);
+		put_pair(high);
+		n = q;
+	}
+
+	// x * 0xCCCD >> 19 is x / 10 for any 16-bit x, x * 5243 >> 19 is x / 100 for x < 43699
+	uint16_t m = n;
+	if(m >= 10000)
+	{
+		uint16_t q = (m * 0xCCCDUL) >> 19;
+		put_digit(m - q * 10);
+		m = q;
+	}
+	while(m >= 100)
+	{
+		uint16_t q = (m * 5243UL) >> 19;
+		put_pair(m - q * 100);
+		m = q;
+	}
+	if(m >= 10)
+	{
+		put_pair(m);
+	}
+	else if(m != 0)
+	{
+		put_digit(m);
+	}
+
+	// Zeros of a fraction and of the integer part
+	while(_digits <= _decimals)
+	{
+		put_digit(0);
+	}
+
+	if(negative && padding == '0')
+	{
+		width = width > 0 ? width - 1 : 0;
+	}
+	else if(negative)
+	{
+		put('-');
+	}
+
+	while(length() < width)
+	{
+		put(padding);
+	}
+
+	if(negative && padding == '0')
+	{
+		put('-');
+	}
+}
+
+/**
+ *	Puts the next more significant digit, preceded by the decimal point where it belongs
+ *	@param	digit	a digit, [0, 9]
+ **/
+void number_format_t::put_digit(uint8_t digit)
+{
+	if(_digits == _decimals && _digits != 0)
+	{
+		put('.');
+	}
+	put('0' + digit);
+	_digits++;
+}
+
+/**
+ *	Puts the next two more significant digits
+ *	@param	pair	a two digit number, [0, 99]
+ **/
+void number_format_t::put_pair(uint8_t pair)
+{
+	// x * 103 >> 10 is x / 10 for x < 179
+	uint8_t tens = (pair * 103) >> 10;
+	put_digit(pair - tens * 10);
+	put_digit(tens);
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Arduino.h"
+
+namespace thermograph
+{
+	/**
+	 *	Decimal number formatter.
+	 *	Converts a number once into its own buffer, from the least significant digit up.
+	 *	Digits are extracted without division: 16-bit values are split by reciprocal multiplication,
+	 *	a wider value takes one long division per four digits until it fits 16 bits
+	 **/
+	class number_format_t
+	{
+	public:
+		/**
+		 *	Max decimal places
+		 **/
+		static const uint8_t MAX_DECIMALS = 9;
+
+		/**
+		 *	Max field width
+		 **/
+		static const uint8_t MAX_WIDTH = 14;
+
+		/**
+		 *	Constructor
+		 *	@param	value		a number, in units of 10^-decimals
+		 *	@param	decimals	decimal places count, up to MAX_DECIMALS
+		 *	@param	width		min field width, up to MAX_WIDTH, the sign and the decimal point included
+		 *	@param	padding		a character the number is padded with on the left up to the width,
+		 *						zeros go after the sign, other characters before it
+		 **/
+		number_format_t(long value, uint8_t decimals = 0, uint8_t width = 0, char padding = ' ');
+
+		/**
+		 *	Gets the formatted number
+		 *	@returns	NUL-terminated text
+		 **/
+		const char* c_str() const { return _buffer + _start; }
+
+		/**
+		 *	Gets the formatted number's length
+		 *	@returns	characters count
+		 **/
+		uint8_t length() const { return sizeof(_buffer) - 1 - _start; }
+
+		/**
+		 *	Gets a character of the formatted number
+		 *	@param		index	character's index, less than length()
+		 *	@returns	the character
+		 **/
+		char operator[](uint8_t index) const { return _buffer[_start + index]; }
+
+		/**
+		 *	Prints the formatted number
+		 *	@param		out		printer
+		 *	@returns	characters printed
+		 **/
+		size_t print(Print& out) const { return out.write(reinterpret_cast<const uint8_t*>(c_str()), length()); }
+
+	private:
+		/**
+		 *	Formatted number, right-aligned and NUL-terminated
+		 **/
+		char _buffer[MAX_WIDTH + 2];
+
+		/**
+		 *	Formatted number's position in the buffer
+		 **/
+		uint8_t _start;
+
+		/**
+		 *	Digits put so far
+		 **/
+		uint8_t _digits;
+
+		/**
+		 *	Decimal places count
+		 **/
+		uint8_t _decimals;
+
+		/**
+		 *	Puts the next more significant digit, preceded by the decimal point where it belongs
+		 *	@param	digit	a digit, [0, 9]
+		 **/
+		void put_digit(uint8_t digit);
+
+		/**
+		 *	Puts the next two more significant digits
+		 *	@param	pair	a two digit number, [0, 99]
+		 **/
+		void put_pair(uint8_t pair);
+
+		/**
+		 *	Puts a character in front of the number
+		 *	@param	c	a character
+		 **/
+		void put(char c) { _buffer[--_start] = c; }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <inttypes.h>
+
+namespace thermograph
+{
+	/**
+	 *	Fixed capacity ring buffer class.
+	 *	Pushing into a full buffer overwrites its oldest item, so push is O(1) whatever the capacity is.
+	 *	Items may be removed from both ends, so the buffer also serves as a bounded deque.
+	 *	Items are addressed by age: 0 is the newest item, size() - 1 is the oldest one
+	 *	@param	T	item type
+	 *	@param	N	capacity, items
+	 **/
+	template <typename T, uint16_t N>
+	class ring_buffer_t
+	{
+	public:
+		/**
+		 *	Forward iterator class, walks items from the oldest to the newest one
+		 **/
+		class iterator_t
+		{
+		public:
+			iterator_t(const ring_buffer_t* buffer, uint16_t age) : _buffer(buffer), _age(age) { }
+
+			const T& operator*() const { return (*_buffer)[_age]; }
+			const T* operator->() const { return &(*_buffer)[_age]; }
+			iterator_t& operator++() { _age--; return *this; }
+			bool operator!=(const iterator_t& other) const { return _age != other._age; }
+
+		private:
+			const ring_buffer_t* _buffer;
+			uint16_t _age;
+		};
+
+		/**
+		 *	Reverse iterator class, walks items from the newest to the oldest one
+		 **/
+		class reverse_iterator_t
+		{
+		public:
+			reverse_iterator_t(const ring_buffer_t* buffer, uint16_t age) : _buffer(buffer), _age(age) { }
+
+			const T& operator*() const { return (*_buffer)[_age]; }
+			const T* operator->() const { return &(*_buffer)[_age]; }
+			reverse_iterator_t& operator++() { _age++; return *this; }
+			bool operator!=(const reverse_iterator_t& other) const { return _age != other._age; }
+
+		private:
+			const ring_buffer_t* _buffer;
+			uint16_t _age;
+		};
+
+		/**
+		 *	Constructor
+		 **/
+		ring_buffer_t() : _head(0), _size(0) { }
+
+		/**
+		 *	Gets buffer's capacity
+		 *	@returns	max items count
+		 **/
+		static uint16_t capacity() { return N; }
+
+		/**
+		 *	Gets items count
+		 *	@returns	items count
+		 **/
+		uint16_t size() const { return _size; }
+
+		/**
+		 *	Gets a value indicating whether the buffer is empty
+		 *	@returns	true if the buffer has no items, false otherwise
+		 **/
+		bool empty() const { return _size == 0; }
+
+		/**
+		 *	Gets a value indicating whether the buffer is full
+		 *	@returns	true if the next push overwrites the oldest item, false otherwise
+		 **/
+		bool full() const { return _size == N; }
+
+		/**
+		 *	Removes all items
+		 **/
+		void clear() { _head = 0; _size = 0; }
+
+		/**
+		 *	Pushes a new item, overwriting the oldest one if the buffer is full
+		 *	@param	item	an item to push
+		 **/
+		void push(const T& item)
+		{
+			_items[_head] = item;
+			_head = _head + 1 == N ? 0 : _head + 1;
+			if (_size < N)
+			{
+				_size++;
+			}
+		}
+
+		/**
+		 *	Removes the newest item. The buffer must not be empty
+		 **/
+		void pop_newest()
+		{
+			_head = _head == 0 ? N - 1 : _head - 1;
+			_size--;
+		}
+
+		/**
+		 *	Removes the oldest item. The buffer must not be empty
+		 **/
+		void pop_oldest() { _size--; }
+
+		/**
+		 *	Gets an item by its age
+		 *	@param		age		item's age, must be less than size()
+		 *	@returns	the item
+		 **/
+		T& operator[](uint16_t age) { return _items[index(age)]; }
+		const T& operator[](uint16_t age) const { return _items[index(age)]; }
+
+		/**
+		 *	Gets the newest item. The buffer must not be empty
+		 *	@returns	the newest item
+		 **/
+		T& newest() { return (*this)[0]; }
+		const T& newest() const { return (*this)[0]; }
+
+		/**
+		 *	Gets the oldest item. The buffer must not be empty
+		 *	@returns	the oldest item
+		 **/
+		T& oldest() { return (*this)[_size - 1]; }
+		const T& oldest() const { return (*this)[_size - 1]; }
+
+		iterator_t begin() const { return iterator_t(this, _size - 1); }
+		iterator_t end() const { return iterator_t(this, static_cast<uint16_t>(-1)); }
+		reverse_iterator_t rbegin() const { return reverse_iterator_t(this, 0); }
+		reverse_iterator_t rend() const { return reverse_iterator_t(this, _size); }
+
+	private:
+		/**
+		 *	Items storage
+		 **/
+		T _items[N];
+
+		/**
+		 *	Index of the slot the next item is written to
+		 **/
+		uint16_t _head;
+
+		/**
+		 *	Items count
+		 **/
+		uint16_t _size;
+
+		/**
+		 *	Maps an item's age to its storage index
+		 *	@param		age		item's age
+		 *	@returns	item's index in storage
+		 **/
+		uint16_t index(uint16_t age) const
+		{
+			return _head > age ? _head - 1 - age : _head + N - 1 - age;
+		}
+	};
+}
\ No newline at end of file
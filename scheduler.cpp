@@ -0,0 +1,203 @@
+#include "Arduino.h"
+#include "_config.h"
+#include "scheduler.h"
+#include "log.h"
+
+using namespace thermograph;
+
+/**
+ *	Task scheduler static instance
+ **/
+scheduler_t thermograph::scheduler;
+
+/*
+ ************************************************************************
+ *	scheduler_t
+ *	Cooperative task scheduler class
+ ************************************************************************
+ */
+
+/**
+ *	Constructor
+ **/
+scheduler_t::scheduler_t()
+	: _count(0)
+{ }
+
+/**
+ *	Registers a periodic task
+ *	@param		name	task name
+ *	@param		task	task to execute
+ *	@param		period	task execution period, in milliseconds
+ *	@param		budget	max task execution duration, in milliseconds
+ *	@param		delay	first task execution delay, in milliseconds
+ *	@returns	task's ID, -1 if there is no room for a new task
+ **/
+int8_t scheduler_t::add(const __FlashStringHelper* name, task_t& task, unsigned long period, unsigned long budget, unsigned long delay)
+{
+	if(_count >= MAX_TASKS)
+	{
+		LOG_ERR(APP, F("scheduler\tadd(): too many tasks"));
+		return -1;
+	}
+
+	uint8_t id = _count;
+	entry_t& entry = _tasks[id];
+	entry.name = name;
+	entry.task = &task;
+	entry.period = period;
+	entry.budget = budget;
+	entry.deadline = millis() + delay;
+	memset(&entry.stats, 0, sizeof(task_stats_t));
+
+	_heap[_count] = id;
+	_count++;
+	sift_up(_count - 1);
+
+	LOG_DBG(APP, F("scheduler\tadd(): task #%d, period = %l ms, budget = %l ms"), id, period, budget);
+	return id;
+}
+
+/**
+ *	Executes the most urgent task if its deadline has passed
+ *	@returns	time left until the next task's deadline, in milliseconds
+ **/
+unsigned long scheduler_t::dispatch()
+{
+	if(_count == 0)
+	{
+		return 0;
+	}
+
+	entry_t& entry = _tasks[_heap[0]];
+
+	unsigned long start = millis();
+	long wait = static_cast<long>(entry.deadline - start);
+	if(wait > 0)
+	{
+		return wait;
+	}
+
+	entry.task->run();
+
+	unsigned long finish = millis();
+	unsigned long duration = finish - start;
+
+	// Update task's execution statistics
+	task_stats_t& stats = entry.stats;
+	stats.runs++;
+	stats.jitter = min(start - entry.deadline, 0xFFFFUL);
+	if(stats.jitter > stats.max_jitter)
+	{
+		stats.max_jitter = stats.jitter;
+	}
+	if(duration > stats.max_duration)
+	{
+		stats.max_duration = min(duration, 0xFFFFUL);
+	}
+	if(duration > entry.budget)
+	{
+		stats.overruns++;
+	}
+
+	// Schedule next execution keeping task's phase, skip missed periods
+	entry.deadline += entry.period;
+	if(static_cast<long>(entry.deadline - finish) <= 0)
+	{
+		entry.deadline = finish + entry.period;
+	}
+
+	sift_down(0);
+	return 0;
+}
+
+/**
+ *	Writes tasks' execution statistics into the log
+ **/
+void scheduler_t::log_stats() const
+{
+	if(!LOG_ENABLED(APP, LOG_INFO))
+	{
+		return;
+	}
+
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		const entry_t& entry = _tasks[i];
+
+		log_event_t e = log.begin_event(LOG_INFO);
+		LOG_APPEND(e, F("scheduler\t"));
+		e.printf(entry.name);
+		LOG_APPEND(e,
+			F(": runs = %l, overruns = %l, jitter = %l ms, max jitter = %l ms, max duration = %l ms"),
+			entry.stats.runs,
+			entry.stats.overruns,
+			entry.stats.jitter,
+			entry.stats.max_jitter,
+			entry.stats.max_duration);
+	}
+}
+
+/**
+ *	Compares two tasks' deadlines, taking millis() overflow into account
+ *	@param		a	first task's ID
+ *	@param		b	second task's ID
+ *	@returns	true if task "a" should be executed before task "b"
+ **/
+bool scheduler_t::is_earlier(uint8_t a, uint8_t b) const
+{
+	return static_cast<long>(_tasks[a].deadline - _tasks[b].deadline) < 0;
+}
+
+/**
+ *	Moves a heap item up until heap order is restored
+ *	@param	pos	heap item's position
+ **/
+void scheduler_t::sift_up(uint8_t pos)
+{
+	while(pos > 0)
+	{
+		uint8_t parent = (pos - 1) / 2;
+		if(!is_earlier(_heap[pos], _heap[parent]))
+		{
+			break;
+		}
+
+		uint8_t id = _heap[pos];
+		_heap[pos] = _heap[parent];
+		_heap[parent] = id;
+		pos = parent;
+	}
+}
+
+/**
+ *	Moves a heap item down until heap order is restored
+ *	@param	pos	heap item's position
+ **/
+void scheduler_t::sift_down(uint8_t pos)
+{
+	while(true)
+	{
+		uint8_t left = 2 * pos + 1;
+		uint8_t right = left + 1;
+		uint8_t first = pos;
+
+		if(left < _count && is_earlier(_heap[left], _heap[first]))
+		{
+			first = left;
+		}
+		if(right < _count && is_earlier(_heap[right], _heap[first]))
+		{
+			first = right;
+		}
+		if(first == pos)
+		{
+			break;
+		}
+
+		uint8_t id = _heap[pos];
+		_heap[pos] = _heap[first];
+		_heap[first] = id;
+		pos = first;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "Arduino.h"
+#include "_config.h"
+
+namespace thermograph
+{
+	/**
+	 *	Scheduled task base class
+	 **/
+	class task_t
+	{
+	protected:
+		/**
+		 *	Destructor, not virtual: tasks are never destroyed through task_t, and a vtable slot costs SRAM on AVR
+		 **/
+		~task_t() { }
+
+	public:
+		/**
+		 *	Executes a task
+		 **/
+		virtual void run() = 0;
+	};
+
+	/**
+	 *	Scheduled task's execution statistics
+	 **/
+	struct task_stats_t
+	{
+		/**
+		 *	Amount of task executions
+		 **/
+		unsigned long runs;
+
+		/**
+		 *	Amount of task executions that exceeded task's budget
+		 **/
+		unsigned long overruns;
+
+		/**
+		 *	Last task execution start delay relative to task's deadline, in milliseconds, saturates at 65535
+		 **/
+		uint16_t jitter;
+
+		/**
+		 *	Max task execution start delay relative to task's deadline, in milliseconds, saturates at 65535
+		 **/
+		uint16_t max_jitter;
+
+		/**
+		 *	Max task execution duration, in milliseconds, saturates at 65535
+		 **/
+		uint16_t max_duration;
+	};
+
+	/**
+	 *	Cooperative task scheduler class.
+	 *	Keeps registered tasks in a min-heap ordered by their deadlines
+	 **/
+	class scheduler_t
+	{
+	public:
+		/**
+		 *	Max tasks to register
+		 **/
+		static const uint8_t MAX_TASKS = 6;
+
+		/**
+		 *	Constructor
+		 **/
+		scheduler_t();
+
+		/**
+		 *	Registers a periodic task
+		 *	@param		name	task name
+		 *	@param		task	task to execute
+		 *	@param		period	task execution period, in milliseconds
+		 *	@param		budget	max task execution duration, in milliseconds
+		 *	@param		delay	first task execution delay, in milliseconds
+		 *	@returns	task's ID, -1 if there is no room for a new task
+		 **/
+		int8_t add(const __FlashStringHelper* name, task_t& task, unsigned long period, unsigned long budget, unsigned long delay = 0);
+
+		/**
+		 *	Executes the most urgent task if its deadline has passed
+		 *	@returns	time left until the next task's deadline, in milliseconds
+		 **/
+		unsigned long dispatch();
+
+		/**
+		 *	Gets an amount of registered tasks
+		 *	@returns	an amount of registered tasks
+		 **/
+		uint8_t count() const { return _count; }
+
+		/**
+		 *	Gets a task's execution statistics
+		 *	@param		id	task's ID
+		 *	@returns	task's execution statistics
+		 **/
+		const task_stats_t& get_stats(uint8_t id) const { return _tasks[id].stats; }
+
+		/**
+		 *	Writes tasks' execution statistics into the log
+		 **/
+		void log_stats() const;
+
+	private:
+		/**
+		 *	Registered task
+		 **/
+		struct entry_t
+		{
+			/**
+			 *	Task name
+			 **/
+			const __FlashStringHelper* name;
+
+			/**
+			 *	Task to execute
+			 **/
+			task_t* task;
+
+			/**
+			 *	Task execution period, in milliseconds
+			 **/
+			unsigned long period;
+
+			/**
+			 *	Max task execution duration, in milliseconds
+			 **/
+			uint16_t budget;
+
+			/**
+			 *	Next task execution time
+			 **/
+			unsigned long deadline;
+
+			/**
+			 *	Task's execution statistics
+			 **/
+			task_stats_t stats;
+		};
+
+		/**
+		 *	Registered tasks
+		 **/
+		entry_t _tasks[MAX_TASKS];
+
+		/**
+		 *	Task IDs ordered as a min-heap by deadline
+		 **/
+		uint8_t _heap[MAX_TASKS];
+
+		/**
+		 *	Amount of registered tasks
+		 **/
+		uint8_t _count;
+
+		/**
+		 *	Compares two tasks' deadlines, taking millis() overflow into account
+		 *	@param		a	first task's ID
+		 *	@param		b	second task's ID
+		 *	@returns	true if task "a" should be executed before task "b"
+		 **/
+		bool is_earlier(uint8_t a, uint8_t b) const;
+
+		/**
+		 *	Moves a heap item up until heap order is restored
+		 *	@param	pos	heap item's position
+		 **/
+		void sift_up(uint8_t pos);
+
+		/**
+		 *	Moves a heap item down until heap order is restored
+		 *	@param	pos	heap item's position
+		 **/
+		void sift_down(uint8_t pos);
+	};
+
+	/**
+	 *	Task scheduler static instance
+	 **/
+	extern scheduler_t scheduler;
+}
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "Arduino.h"
+#include <new>
+#include "adc.h"
 #include "data_history.h"
 #include "sensor.h"
 #include "log.h"
@@ -30,212 +32,320 @@ reading_t::reading_t(const optional_t<temperature_t>& temperature, const optiona
 
 #pragma endregion
 
-#pragma region sensor_service_t::temperature_source_t
+#pragma region analog_sensor_node_t
 
 /*
  ************************************************************************
- *	sensor_service_t::temperature_source_t
- *	Temperature source base class
+ *	analog_sensor_node_t
+ *	Analog sensor graph node base class
  ************************************************************************
  */
 
 /**
- *	Initializes temperature sensor
+ *	Initializes a sensor node
  **/
-void sensor_service_t::source_t::init()
+void analog_sensor_node_t::init()
 {
-	get_sensor().init();
+	adc_scanner.add(_port, _reference, _oversampling);
 }
 
 /**
- *	Updates sensor value
- *	@param	time	current global time
+ *	Gets a value indicating whether node's background acquisition has completed
+ *	@returns	true if update() can collect a reading without waiting, false otherwise
  **/
-void sensor_service_t::source_t::update(time_t& time)
+bool analog_sensor_node_t::ready()
 {
-	reading_t reading = get_sensor().update(time);
-	_last_temperature = reading.temperature();
-	_last_humidity = reading.humidity();
+	return adc_scanner.ready(_port);
+}
+
+/**
+ *	Reads sensor's ADC channel
+ *	@returns	ADC code scaled to [0, 65535] range
+ **/
+uint16_t analog_sensor_node_t::read() const
+{
+	return adc_scanner.filtered(_port);
 }
 
 #pragma endregion
 
-#pragma region sensor_service_t
+#pragma region sensor_service_t::channel_t
 
 /*
  ************************************************************************
- *	sensor_service_t
- *	Sensor service class
+ *	sensor_service_t::channel_t
+ *	Sensor channel
  ************************************************************************
  */
 
+/**
+ *	Sensor channels table
+ **/
+#define SENSOR_CHANNEL_CONFIG(port, driver, name, label, period, oversampling) { port, driver, name, label, period, oversampling },
+static const sensor_channel_config_t channel_configs[SENSOR_COUNT] =
+{
+	APP_SENSOR_CHANNELS(SENSOR_CHANNEL_CONFIG)
+};
+#undef SENSOR_CHANNEL_CONFIG
+
+/**
+ *	DHT sensors are timed by an external interrupt, a DHT channel on any other pin would never complete a reading
+ **/
+#define SENSOR_CHANNEL_CHECK(port, driver, name, label, period, oversampling) \
+	static_assert((driver != SENSOR_DRIVER_DHT11 && driver != SENSOR_DRIVER_DHT22) || digitalPinToInterrupt(port) != NOT_AN_INTERRUPT, \
+		"DHT sensor's port must be an external interrupt pin");
+APP_SENSOR_CHANNELS(SENSOR_CHANNEL_CHECK)
+#undef SENSOR_CHANNEL_CHECK
+
 /**
  *	Constructor
  **/
-sensor_service_t::sensor_service_t()
-	: _indoor_source(APP_INDOOR_SENSOR_PORT),
-	  _outdoor_source(APP_OUTDOOR_SENSOR_PORT)
+sensor_service_t::channel_t::channel_t()
+	: _config(NULL),
+	  _sensor(NULL),
+	  _countdown(0),
+	  _pending(false),
+	  _last_temperature(optional_t<temperature_t>::empty()),
+	  _last_humidity(optional_t<humidity_t>::empty())
 { }
 
 /**
- *	Initializes sensors
+ *	Binds the channel to its description and creates its sensor in channel's storage
+ *	@param	config	channel's description
  **/
-void sensor_service_t::init()
+void sensor_service_t::channel_t::configure(const sensor_channel_config_t& config)
 {
-	log.debug(F("sensor_service\tinit()"));
+	_config = &config;
 
-	_indoor_source.init();
-	_outdoor_source.init();
+	switch(config.driver)
+	{
+	case SENSOR_DRIVER_DHT22:
+		_sensor = new(&_node.dht) dht_sensor_node_t(config.port, DHT_22);
+		break;
+	case SENSOR_DRIVER_LM35:
+		_sensor = new(&_node.lm35) lm35_sensor_node_t(config.port, config.oversampling);
+		break;
+	case SENSOR_DRIVER_THERMISTOR:
+		_sensor = new(&_node.thermistor) thermistor_sensor_node_t(config.port, config.oversampling);
+		break;
+	case SENSOR_DRIVER_DHT11:
+	default:
+		_sensor = new(&_node.dht) dht_sensor_node_t(config.port, DHT_11);
+		break;
+	}
 }
 
 /**
- *	Updates sensor values
- *	@param	policy	sensor update policy
+ *	Starts sensor's background acquisition if the channel is due to update
+ *	@returns	true if acquisition has been started, false otherwise
  **/
-void sensor_service_t::update(update_policy policy)
+bool sensor_service_t::channel_t::trigger()
 {
-	sys_time_t time = time_service.get_systime();
-	if(execute_policy(time, policy))
+	if(_countdown > 0)
 	{
-		time_t time = time_service.get_time();
-		_indoor_source.update(time);
-		_outdoor_source.update(time);
-		_last_updated = time_service.get_systime();
-
-		log_readings();
-
-		optional_t<temperature_t> outdoor_temperature = _outdoor_source.get_temperature();
-		if(outdoor_temperature.has_value())
-		{
-			data_history.push(SENSOR_ID_OUTDOOR, time, outdoor_temperature.value());
-		}
-
-		optional_t<temperature_t> indoor_temperature = _indoor_source.get_temperature();
-		if(indoor_temperature.has_value())
-		{
-			data_history.push(SENSOR_ID_INDOOR, time, indoor_temperature.value());
-		}
+		_countdown--;
+		return false;
 	}
+
+	// Channel's period is counted in sensor service's update rounds
+	_countdown = (_config->period + APP_SENSOR_PERIOD - 1) / APP_SENSOR_PERIOD - 1;
+	_pending = true;
+	_sensor->trigger();
+	return true;
 }
 
 /**
- *	Determines whether sensor values should be updated
- *	@param		time	current local time
- *	@param		policy	sensor value update policy
- *	@returns	a value indicating whether sensor values should be updated or not.
+ *	Collects sensor's reading if the channel has been triggered
+ *	@param		time	current global time
+ *	@returns	true if the reading has been collected, false if the channel isn't due in this round
  **/
-bool sensor_service_t::execute_policy(const sys_time_t& time, update_policy policy)
+bool sensor_service_t::channel_t::update(time_t& time)
 {
-	switch (policy)
+	if(!_pending)
 	{
-	case thermograph::sensor_service_t::UP_DEFAULT:
-		{
-			long delta = 0;
-			delta += (time.sec - _last_updated.sec);
-			delta += (time.min - _last_updated.min) * 60;
+		return false;
+	}
 
-			return (delta >= APP_SENSOR_PERIOD);
-		}
+	_pending = false;
+	reading_t reading = _sensor->update(time);
+	_last_temperature = reading.temperature();
+	_last_humidity = reading.humidity();
+	return true;
+}
 
-	case thermograph::sensor_service_t::UP_FORCE:
-		return true;
+#pragma endregion
 
-	default:
-		break;
+#pragma region sensor_service_t
+
+/*
+ ************************************************************************
+ *	sensor_service_t
+ *	Sensor service class
+ ************************************************************************
+ */
+
+/**
+ *	Constructor
+ **/
+sensor_service_t::sensor_service_t()
+	: _round_active(false),
+	  _round_started(0)
+{
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
+	{
+		_channels[id].configure(channel_configs[id]);
 	}
 }
 
 /**
-*	Writes current readings into the log
-*/
-void sensor_service_t::log_readings()
+ *	Initializes sensors
+ **/
+void sensor_service_t::init()
 {
-	log_event_t e = log.begin_event(LOG_INFO);
-	e.printf(F("sensor_service\tupdate(): "));
+	LOG_DBG(SENSOR, F("sensor_service\tinit(): %d channels"), SENSOR_COUNT);
 
-	optional_t<temperature_t> indoor_temperature = _indoor_source.get_temperature();
-	optional_t<humidity_t> indoor_humidity = _indoor_source.get_humidity();
-	e.printf(F("indoor: "));
-
-	if(indoor_temperature.has_value())
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
 	{
-		temperature_t t = indoor_temperature.value();
-		e.printf(F("t = %f deg C, "), &t);
+		_channels[id].init();
 	}
-	else
+}
+
+/**
+ *	Starts a new acquisition round on sensors which are due to update
+ **/
+void sensor_service_t::update()
+{
+	if(_round_active)
 	{
-		e.printf(F("t = <N/A>, "));
+		LOG_ERR(SENSOR, F("sensor_service\tupdate(): previous round hasn't completed"));
+		collect();
 	}
 
-	if(indoor_humidity.has_value())
+	// All sensors convert simultaneously, the round lasts as long as the slowest of them
+	_round_started = millis();
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
 	{
-		humidity_t h = indoor_humidity.value();
-		e.printf(F("h = %f%%, "), &h);
+		if(_channels[id].trigger())
+		{
+			_round_active = true;
+		}
 	}
-	else
+}
+
+/**
+ *	Advances sensors' background acquisition,
+ *	collects the round once all sensors are ready
+ **/
+void sensor_service_t::poll()
+{
+	bool ready = true;
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
 	{
-		e.printf(F("h = <N/A>, "));
+		_channels[id].poll();
+		ready = ready && _channels[id].ready();
 	}
 
-	optional_t<temperature_t> outdoor_temperature = _outdoor_source.get_temperature();
-	optional_t<humidity_t> outdoor_humidity = _outdoor_source.get_humidity();
-	e.printf(F("outdoor: "));
-
-	if(outdoor_temperature.has_value())
+	if(!_round_active)
 	{
-		temperature_t t = outdoor_temperature.value();
-		e.printf(F("t = %f deg C, "), &t);
+		return;
 	}
-	else
+
+	if(!ready && (millis() - _round_started) < APP_SENSOR_ROUND_TIMEOUT)
 	{
-		e.printf(F("t = <N/A>, "));
+		return;
 	}
 
-	if(outdoor_humidity.has_value())
+	collect();
+}
+
+/**
+ *	Collects readings of current acquisition round
+ **/
+void sensor_service_t::collect()
+{
+	unsigned long duration = millis() - _round_started;
+	_round_active = false;
+
+	time_t time = time_service.get_time();
+	bool sampled[SENSOR_COUNT];
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
 	{
-		humidity_t h = outdoor_humidity.value();
-		e.printf(F("h = %f%%"), &h);
+		sampled[id] = _channels[id].update(time);
 	}
-	else
+
+	log_readings(duration);
+
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
 	{
-		e.printf(F("h = <N/A>"));
+		data_history.advance(id, time);
+
+		// A channel which isn't due keeps its last reading for display only, its history interval gets no sample
+		if(!sampled[id])
+		{
+			continue;
+		}
+
+		const optional_t<temperature_t>& temperature = _channels[id].get_temperature();
+		if(temperature.has_value())
+		{
+			data_history.push(id, METRIC_TEMPERATURE, temperature.value());
+		}
+
+		const optional_t<humidity_t>& humidity = _channels[id].get_humidity();
+		if(humidity.has_value())
+		{
+			data_history.push(id, METRIC_HUMIDITY, humidity.value());
+		}
 	}
 }
 
 /**
-*	Retreives a sensor's last temperature value
-*	@param		id	sensor's id
-*	@returns	sensor's last value
-**/
-const optional_t<temperature_t> sensor_service_t::get_temperature(sensor_id id) const
+*	Writes current readings into the log
+*	@param	duration	acquisition round's wall-clock time, in milliseconds
+*/
+void sensor_service_t::log_readings(unsigned long duration)
 {
-	switch (id)
+	if(!LOG_ENABLED(SENSOR, LOG_INFO))
 	{
-	case SENSOR_ID_OUTDOOR:
-		return _outdoor_source.get_temperature();
-	case SENSOR_ID_INDOOR:
-		return _indoor_source.get_temperature();
-	default:
-		break;
+		return;
 	}
-}
 
-/**
-*	Retreives a sensor's last humidity value
-*	@param		id	sensor's id
-*	@returns	sensor's last value
-**/
-const optional_t<humidity_t> sensor_service_t::get_humidity(sensor_id id) const
-{
-	switch (id)
+	log_event_t e = log.begin_event(LOG_INFO);
+	LOG_APPEND(e, F("sensor_service\tupdate(): "));
+
+	for(sensor_id id = 0; id < SENSOR_COUNT; id++)
 	{
-	case SENSOR_ID_OUTDOOR:
-		return _outdoor_source.get_humidity();
-	case SENSOR_ID_INDOOR:
-		return _indoor_source.get_humidity();
-	default:
-		break;
+		const optional_t<temperature_t>& temperature = _channels[id].get_temperature();
+		const optional_t<humidity_t>& humidity = _channels[id].get_humidity();
+		if(temperature.has_value() && humidity.has_value())
+		{
+			// A single format string is shorter in binary log
+			LOG_APPEND(e, F("%s: t = %h deg C, h = %h%%, "), _channels[id].get_config().label, temperature.value(), humidity.value());
+			continue;
+		}
+
+		LOG_APPEND(e, F("%s: "), _channels[id].get_config().label);
+
+		if(temperature.has_value())
+		{
+			LOG_APPEND(e, F("t = %h deg C, "), temperature.value());
+		}
+		else
+		{
+			LOG_APPEND(e, F("t = <N/A>, "));
+		}
+
+		if(humidity.has_value())
+		{
+			LOG_APPEND(e, F("h = %h%%, "), humidity.value());
+		}
+		else
+		{
+			LOG_APPEND(e, F("h = <N/A>, "));
+		}
 	}
+
+	LOG_APPEND(e, F("round = %l ms"), duration);
 }
 
 #pragma endregion
\ No newline at end of file
@@ -9,14 +9,14 @@
 namespace thermograph
 {
 	/**
-	*	Temperature
+	*	Temperature, in hundredths of Celsius degree
 	*/
-	typedef float temperature_t;
+	typedef int16_t temperature_t;
 
 	/**
-	*	Humidity
+	*	Relative humidity, in hundredths of percent
 	*/
-	typedef float humidity_t;
+	typedef int16_t humidity_t;
 
 	/**
 	*	A wrapper class for optional values
@@ -101,12 +101,13 @@ namespace thermograph
 	**/
 	class sensor_node_t
 	{
-	public:
+	protected:
 		/**
-		*	Destructor
+		*	Destructor, nodes are constructed in their channels' storage and never destroyed
 		**/
-		virtual ~sensor_node_t() { }
+		~sensor_node_t() { }
 
+	public:
 		/**
 		*	Initializes a sensor node
 		**/
@@ -118,44 +119,58 @@ namespace thermograph
 		*	@returns	node's temperature value
 		**/
 		virtual const reading_t update(const time_t& time) = 0;
+
+		/**
+		*	Starts node's background acquisition
+		**/
+		virtual void trigger() { }
+
+		/**
+		*	Advances node's background acquisition
+		**/
+		virtual void poll() { }
+
+		/**
+		*	Gets a value indicating whether node's background acquisition has completed
+		*	@returns	true if update() can collect a reading without waiting, false otherwise
+		**/
+		virtual bool ready() { return true; }
 	};
 
 	/**
-	*	Thermistor sensor graph node
+	*	Analog sensor graph node base class.
+	*	Reads oversampled and filtered values of sensor's ADC channel from adc_scanner
 	**/
-	class thermistor_sensor_node_t : public sensor_node_t
+	class analog_sensor_node_t : public sensor_node_t
 	{
 	public:
 		/**
 		*	Constructor
-		*	@param	port	sensor port
+		*	@param	port			sensor port
+		*	@param	reference		analog reference voltage
+		*	@param	oversampling	extra bits to gain by oversampling
 		**/
-		thermistor_sensor_node_t(uint8_t port)
-			: _port(port)
+		analog_sensor_node_t(uint8_t port, uint8_t reference, uint8_t oversampling)
+			: _port(port), _reference(reference), _oversampling(oversampling)
 		{ }
 
 		/**
-		*	Retreives node's current value
-		*	@param		time	current global time
-		*	@returns	node's temperature value
+		*	Initializes a sensor node
 		**/
-		virtual const reading_t update(const time_t& time);
+		virtual void init();
 
 		/**
-		*	Temperature point for approximation
+		*	Gets a value indicating whether node's background acquisition has completed
+		*	@returns	true if update() can collect a reading without waiting, false otherwise
 		**/
-		struct temperature_point_t
-		{
-			/**
-			*	Temperature
-			**/
-			double t;
+		virtual bool ready();
 
-			/**
-			*	Resistance
-			**/
-			double r;
-		};
+	protected:
+		/**
+		*	Reads sensor's ADC channel
+		*	@returns	ADC code scaled to [0, 65535] range
+		**/
+		uint16_t read() const;
 
 	private:
 		/**
@@ -164,62 +179,71 @@ namespace thermograph
 		uint8_t _port;
 
 		/**
-		*	Thermistor voltage dividor resistor's resistance
+		*	Analog reference voltage
 		**/
-		static const double R_D;
+		uint8_t _reference;
 
 		/**
-		*	Thermistor's resistance at 25 Celsium degrees
+		*	Extra bits to gain by oversampling
 		**/
-		static const double R_25;
+		uint8_t _oversampling;
+	};
 
+	/**
+	*	Thermistor sensor graph node
+	**/
+	class thermistor_sensor_node_t : public analog_sensor_node_t
+	{
+	public:
 		/**
-		*	Finds a closest temperature point
-		*	@param		r	thermistor's resistance
-		*	@returns	an index of temperature point, -1 if no temperature point has been found
+		*	Constructor
+		*	@param	port			sensor port
+		*	@param	oversampling	extra bits to gain by oversampling
 		**/
-		static size_t find_temperature_point(double r);
+		thermistor_sensor_node_t(uint8_t port, uint8_t oversampling)
+			: analog_sensor_node_t(port, DEFAULT, oversampling)
+		{ }
 
 		/**
-		*	Computes temperature
-		*	@param		r		thermistor's resistance
-		*	@param		index	temperature point's index
-		*	@returns	temperature
+		*	Retreives node's current value
+		*	@param		time	current global time
+		*	@returns	node's temperature value
 		**/
-		static temperature_t approximate_temperature(double r, size_t index);
+		virtual const reading_t update(const time_t& time);
+
+		/**
+		*	Converts a reading into temperature
+		*	@param		reading		ADC code scaled to [0, 65535] range
+		*	@returns	temperature, THERMISTOR_TABLE_INVALID if the reading is outside of thermistor's range
+		**/
+		static temperature_t convert(uint16_t reading);
 	};
 
 	/**
 	*	LM35 sensor graph node
 	**/
-	class lm35_sensor_node_t : public sensor_node_t
+	class lm35_sensor_node_t : public analog_sensor_node_t
 	{
 	public:
 		/**
 		*	Constructor
-		*	@param	port	sensor port
-		**/
-		lm35_sensor_node_t(uint8_t port)
-			: _port(port)
+		*	@param	port			sensor port
+		*	@param	oversampling	extra bits to gain by oversampling
+		**/
+		lm35_sensor_node_t(uint8_t port, uint8_t oversampling)
+#ifdef LM35_USE_INTERNAL_REF
+			: analog_sensor_node_t(port, INTERNAL, oversampling)
+#else
+			: analog_sensor_node_t(port, DEFAULT, oversampling)
+#endif
 		{ }
 
-		/**
-		*	Initializes a sensor node
-		**/
-		virtual void init();
-
 		/**
 		*	Retreives node's current value
 		*	@param		time	current global time
 		*	@returns	node's temperature value
 		**/
 		virtual const reading_t update(const time_t& time);
-
-	private:
-		/**
-		*	Sensor port
-		**/
-		uint8_t _port;
 	};
 
 	/**
@@ -263,6 +287,22 @@ namespace thermograph
 		**/
 		virtual const reading_t update(const time_t& time);
 
+		/**
+		*	Starts node's background acquisition
+		**/
+		virtual void trigger();
+
+		/**
+		*	Advances node's background acquisition
+		**/
+		virtual void poll();
+
+		/**
+		*	Gets a value indicating whether node's background acquisition has completed
+		*	@returns	true if update() can collect a reading without waiting, false otherwise
+		**/
+		virtual bool ready();
+
 	private:
 		/**
 		*	DHT sensor adapter
@@ -271,21 +311,79 @@ namespace thermograph
 	};
 
 	/**
-	*	Sensor ID
+	*	Sensor driver
+	**/
+	enum sensor_driver
+	{
+		/**
+		*	DHT11 humidity and temperature sensor
+		**/
+		SENSOR_DRIVER_DHT11,
+
+		/**
+		*	DHT22 humidity and temperature sensor
+		**/
+		SENSOR_DRIVER_DHT22,
+
+		/**
+		*	LM35 temperature sensor
+		**/
+		SENSOR_DRIVER_LM35,
+
+		/**
+		*	Thermistor
+		**/
+		SENSOR_DRIVER_THERMISTOR
+	};
+
+	/**
+	*	Sensor channel's description, an entry of APP_SENSOR_CHANNELS table
 	**/
-	enum sensor_id
+	struct sensor_channel_config_t
 	{
 		/**
-		*	Outdoor sensor
+		*	Sensor port
+		**/
+		uint8_t port;
+
+		/**
+		*	Sensor driver
+		**/
+		sensor_driver driver;
+
+		/**
+		*	Display name
 		**/
-		SENSOR_ID_OUTDOOR,
+		const char* name;
 
 		/**
-		*	Indoor sensor
+		*	Short display name
 		**/
-		SENSOR_ID_INDOOR
+		const char* label;
+
+		/**
+		*	Update period, in seconds
+		**/
+		long period;
+
+		/**
+		*	Extra bits to gain by oversampling, analog sensors only
+		**/
+		uint8_t oversampling;
 	};
 
+	/**
+	*	Sensor ID, an index of sensor channel in APP_SENSOR_CHANNELS table
+	**/
+	typedef uint8_t sensor_id;
+
+	/**
+	*	Number of sensor channels
+	**/
+#define SENSOR_CHANNEL_COUNT(port, driver, name, label, period, oversampling) + 1
+	static const sensor_id SENSOR_COUNT = 0 APP_SENSOR_CHANNELS(SENSOR_CHANNEL_COUNT);
+#undef SENSOR_CHANNEL_COUNT
+
 	/**
 	*	Sensor service class
 	**/
@@ -298,176 +396,180 @@ namespace thermograph
 		sensor_service_t();
 
 		/**
-		*	Sensor update policy enumeration
+		*	Initializes sensors
 		**/
-		enum update_policy
-		{
-			/**
-			*	Update sensor values by timer
-			**/
-			UP_DEFAULT,
-
-			/**
-			*	Force sensor values update
-			**/
-			UP_FORCE
-		};
+		void init();
 
 		/**
-		*	Initializes sensors
+		*	Starts a new acquisition round on sensors which are due to update
 		**/
-		void init();
+		void update();
 
 		/**
-		*	Updates sensor values
-		*	@param	policy	sensor update policy
+		*	Advances sensors' background acquisition,
+		*	collects the round once all sensors are ready
 		**/
-		void update(update_policy policy = UP_DEFAULT);
+		void poll();
 
 		/**
 		*	Retreives a sensor's last temperature value
 		*	@param		id	sensor's id
 		*	@returns	sensor's last value
 		**/
-		const optional_t<temperature_t> get_temperature(sensor_id id) const;
+		const optional_t<temperature_t>& get_temperature(sensor_id id) const { return _channels[id].get_temperature(); }
 
 		/**
 		*	Retreives a sensor's last humidity value
 		*	@param		id	sensor's id
 		*	@returns	sensor's last value
 		**/
-		const optional_t<humidity_t> get_humidity(sensor_id id) const;
+		const optional_t<humidity_t>& get_humidity(sensor_id id) const { return _channels[id].get_humidity(); }
+
+		/**
+		*	Retreives a sensor's display name
+		*	@param		id	sensor's id
+		*	@returns	sensor's name
+		**/
+		const char* get_name(sensor_id id) const { return _channels[id].get_config().name; }
+
+		/**
+		*	Retreives a sensor's short display name
+		*	@param		id	sensor's id
+		*	@returns	sensor's label
+		**/
+		const char* get_label(sensor_id id) const { return _channels[id].get_config().label; }
 
 	private:
 		/**
-		*	Temperature and humidity source base class
+		*	Sensor channel
 		**/
-		class source_t
+		class channel_t
 		{
 		public:
 			/**
-			*	Destructor
+			*	Constructor
+			**/
+			channel_t();
+
+			/**
+			*	Binds the channel to its description and creates its sensor in channel's storage
+			*	@param	config	channel's description
 			**/
-			virtual ~source_t() { }
+			void configure(const sensor_channel_config_t& config);
 
 			/**
-			*	Initializes temperature sensor
+			*	Initializes channel's sensor
 			**/
-			virtual void init();
+			void init() { _sensor->init(); }
+
+			/**
+			*	Gets channel's description
+			**/
+			const sensor_channel_config_t& get_config() const { return *_config; }
 
 			/**
 			*	Retreives sensor's last temperature
 			**/
-			const optional_t<temperature_t> get_temperature() const { return _last_temperature; }
+			const optional_t<temperature_t>& get_temperature() const { return _last_temperature; }
 
 			/**
 			*	Retreives sensor's last humidity
 			**/
-			const optional_t<humidity_t> get_humidity() const { return _last_humidity; }
+			const optional_t<humidity_t>& get_humidity() const { return _last_humidity; }
 
 			/**
-			*	Updates sensor value
-			*	@param	time	current global time
+			*	Starts sensor's background acquisition if the channel is due to update
+			*	@returns	true if acquisition has been started, false otherwise
 			**/
-			void update(time_t& time);
+			bool trigger();
 
 			/**
-			*	Returns a reference to the sensor assiciated with current source
-			*	@returns	a reference to the sensor
+			*	Advances sensor's background acquisition
 			**/
-			virtual sensor_node_t& get_sensor() = 0;
+			void poll() { _sensor->poll(); }
 
-		private:
 			/**
-			* Last temperature
+			*	Gets a value indicating whether the channel has no acquisition to collect
 			**/
-			optional_t<temperature_t> _last_temperature;
+			bool ready() { return !_pending || _sensor->ready(); }
 
 			/**
-			* Last humidity
+			*	Collects sensor's reading if the channel has been triggered
+			*	@param		time	current global time
+			*	@returns	true if the reading has been collected, false if the channel isn't due in this round
 			**/
-			optional_t<humidity_t> _last_humidity;
-		};
+			bool update(time_t& time);
 
-		/**
-		* Outdoor source
-		**/
-		class outdoor_source_t : public source_t
-		{
-		public:
+		private:
 			/**
-			*	Constructor
-			*	@param	port	sensor port
+			*	Channel's description
 			**/
-			outdoor_source_t(int port) : _sensor(port, DHT_11) { }
+			const sensor_channel_config_t* _config;
 
-		protected:
 			/**
-			*	Returns a reference to the sensor assiciated with current source
-			*	@returns	a reference to the sensor
+			*	Channel's sensor, constructed in place in one of the driver slots
 			**/
-			virtual sensor_node_t& get_sensor() { return _sensor; }
+			sensor_node_t* _sensor;
 
-		private:
 			/**
-			*	Temperature sensor
+			*	Storage of channel's sensor, sized for the largest driver
 			**/
-			dht_sensor_node_t _sensor;
-		};
+			union node_storage_t
+			{
+				node_storage_t() { }
+				~node_storage_t() { }
+
+				dht_sensor_node_t dht;
+				lm35_sensor_node_t lm35;
+				thermistor_sensor_node_t thermistor;
+			} _node;
 
-		/**
-		*	Indoor source
-		**/
-		class indoor_source_t : public source_t
-		{
-		public:
 			/**
-			*	Constructor
-			*	@param	port	sensor port
+			*	Rounds left until the channel is due to update
 			**/
-			indoor_source_t(int port) : _sensor(port, DHT_11) { }
+			uint8_t _countdown;
 
-		protected:
 			/**
-			*	Returns a reference to the sensor assiciated with current source
-			*	@returns	a reference to the sensor
+			*	Indicates whether the channel has been triggered in current round
 			**/
-			virtual sensor_node_t& get_sensor() { return _sensor; }
+			bool _pending;
 
-		private:
 			/**
-			*	Temperature sensor
+			* Last temperature
 			**/
-			dht_sensor_node_t _sensor;
+			optional_t<temperature_t> _last_temperature;
+
+			/**
+			* Last humidity
+			**/
+			optional_t<humidity_t> _last_humidity;
 		};
 
 		/**
-		*	Indoor source
-		**/		
-		indoor_source_t _indoor_source;
+		*	Sensor channels
+		**/
+		channel_t _channels[SENSOR_COUNT];
 
 		/**
-		*	Outdoor source
+		*	Indicates whether an acquisition round is in progress
 		**/
-		outdoor_source_t _outdoor_source;
+		bool _round_active;
 
 		/**
-		*	Last update time
+		*	Acquisition round's start time, in milliseconds
 		**/
-		sys_time_t _last_updated;
+		unsigned long _round_started;
 
 		/**
-		*	Determines whether sensor values should be updated
-		*	@param		time	current local time
-		*	@param		policy	sensor value update policy
-		*	@returns	a value indicating whether sensor values should be updated or not.
+		*	Collects readings of current acquisition round
 		**/
-		bool execute_policy(const sys_time_t& time, update_policy policy);
+		void collect();
 
 		/**
 		*	Writes current readings into the log
+		*	@param	duration	acquisition round's wall-clock time, in milliseconds
 		*/
-		void log_readings();
+		void log_readings(unsigned long duration);
 	};
 
 	/**
@@ -30,33 +30,64 @@ dht_sensor_node_t::dht_sensor_node_t(uint8_t port, dht_sensor_type type)
 void dht_sensor_node_t::init()
 {
 	_dht.begin();
-	log.debug(F("dht_sensor\tinit()"));
+	LOG_DBG(SENSOR, F("dht_sensor\tinit()"));
 }
 
 /**
- *	Retreives node's current value
+ *	Retreives node's current value.
+ *	Decodes the frame received in background since trigger() has been called.
  *	@param		time	current global time
  *	@returns	node's temperature value
  **/
 const reading_t dht_sensor_node_t::update(const time_t& time)
 {
-	float humidity = _dht.readHumidity();
-	float temperature= _dht.readTemperature();
+	DHTFrame frame;
 
-	if(isnan(humidity) || isnan(temperature))
+	_dht.poll();
+	if(!_dht.read(frame))
 	{
-		log.error(F("dht_sensor\tupdate(): unable to read data from sensor"));
-		return reading_t(
-			optional_t<temperature_t>::empty(),
-			optional_t<humidity_t>::empty()
-			);
+		LOG_ERR_LIMITED(SENSOR, DHT_INCOMPLETE, F("dht_sensor\tupdate(): sensor hasn't completed its reading"));
+		return reading_t(optional_t<temperature_t>::empty(), optional_t<humidity_t>::empty());
+	}
+
+	if(frame.status != DHT_FRAME_OK)
+	{
+		LOG_ERR_LIMITED(SENSOR, DHT_FAILURE, F("dht_sensor\tupdate(): unable to read data from sensor, status = %d"), frame.status);
+		return reading_t(optional_t<temperature_t>::empty(), optional_t<humidity_t>::empty());
 	}
 
-	log.debug(F("dht_sensor\tupdate(): temperature = %f deg C, humidity = %f%%"), &temperature, &humidity);
 	return reading_t(
-		optional_t<temperature_t>::create(temperature),
-		optional_t<humidity_t>::create(humidity)
+		optional_t<temperature_t>::create(frame.temperature),
+		optional_t<humidity_t>::create(frame.humidity)
 		);
 }
 
+/**
+ *	Starts node's background acquisition
+ **/
+void dht_sensor_node_t::trigger()
+{
+	if(!_dht.start())
+	{
+		LOG_ERR_LIMITED(SENSOR, DHT_BUSY, F("dht_sensor\ttrigger(): sensor is busy"));
+	}
+}
+
+/**
+ *	Advances node's background acquisition
+ **/
+void dht_sensor_node_t::poll()
+{
+	_dht.poll();
+}
+
+/**
+ *	Gets a value indicating whether node's background acquisition has completed
+ *	@returns	true if update() can collect a reading without waiting, false otherwise
+ **/
+bool dht_sensor_node_t::ready()
+{
+	return _dht.complete();
+}
+
 #pragma endregion
\ No newline at end of file
@@ -14,16 +14,6 @@ using namespace thermograph;
 ************************************************************************
 */
 
-/**
-*	Initializes a sensor node
-**/
-void lm35_sensor_node_t::init()
-{
-#ifdef LM35_USE_INTERNAL_REF
-	analogReference(INTERNAL);
-#endif
-}
-
 /**
 *	Retreives node's current value
 *	@param		time	current global time
@@ -31,14 +21,15 @@ void lm35_sensor_node_t::init()
 **/
 const reading_t lm35_sensor_node_t::update(const time_t& time)
 {
-	int reading = analogRead(_port);
+	// LM35 outputs 10 mV per degree, a 16-bit scaled reading spans the reference voltage
+	uint16_t reading = read();
 #ifdef LM35_USE_INTERNAL_REF
-	temperature_t temp = reading / 9.31;
+	temperature_t temp = (static_cast<uint32_t>(reading) * 11000) >> 16;
 #else
-	temp_t temp = (5.0 * reading* 100.0) / 1024;
+	temperature_t temp = (static_cast<uint32_t>(reading) * 50000) >> 16;
 #endif
 
-	log.debug(F("lm35_sensor\tupdate(): raw = %d, temp = %f"), reading, &temp);
+	LOG_DBG(SENSOR, F("lm35_sensor\tupdate(): raw = %l, temp = %h"), (long)reading, temp);
 	return reading_t(
 		optional_t<temperature_t>::create(temp),
 		optional_t<humidity_t>::empty()
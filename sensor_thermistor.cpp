@@ -2,6 +2,7 @@
 #include "data_history.h"
 #include "sensor.h"
 #include "log.h"
+#include "thermistor_table.h"
 
 using namespace thermograph;
 
@@ -14,88 +15,6 @@ using namespace thermograph;
  ************************************************************************
  */
 
-/**
- *	Thermistor voltage dividor resistor's resistance
- **/
-const double thermistor_sensor_node_t::R_D = 1.0*1000;
-
-/**
- *	Thermistor's resistance at 25 Celsium degrees
- **/
-const double thermistor_sensor_node_t::R_25 = 10.0*1000;
-
-/**
- *	Thermistor's approximation data
- **/
-static thermistor_sensor_node_t::temperature_point_t temperature_points[] =
-{
-	{ -55.0, 121.46 },
-	{ -50.0, 84.439 },
-	{ -45.0, 59.243 },
-	{ -40.0, 41.938 },
-	{ -35.0, 29.947 },
-
-	{ -30.0, 21.567 },
-	{ -25.0, 15.641 },
-	{ -20.0, 11.466 },
-	{ -15.0, 8.451 },
-	{ -10.0, 6.2927 },
-
-	{  -5.0, 4.7077 },
-	{   0.0, 3.5563 },
-	{   5.0, 2.7119 },
-	{  10.0, 2.086  },
-	{  15.0, 1.6204 },
-
-	{  20.0, 1.2683 },
-	{  25.0, 1.0000 },
-	{  30.0, 0.7942 },
-	{  35.0, 0.63268 },
-
-	{  40.0, 0.5074 },
-	{  45.0, 0.41026 },
-	{  50.0, 0.33363 },
-	{  55.0, 0.27243 }
-};
-
-/**
- *	Finds a closest temperature point
- *	@param		r	thermistor's resistance
- *	@returns	an index of temperature point, -1 if no temperature point has been found
- **/
-size_t thermistor_sensor_node_t::find_temperature_point(double r)
-{
-	size_t count = sizeof(temperature_points) / sizeof(thermistor_sensor_node_t::temperature_point_t);
-
-	for(size_t i = 1; i < count; i++)
-	{
-		if(temperature_points[i].r <= r)
-		{
-			return i - 1;
-		}
-	}
-
-	return -1;
-}
-
-/**
- *	Computes temperature
- *	@param		r		thermistor's resistance
- *	@param		index	temperature point's index
- *	@returns	temperature
- **/
-temperature_t thermistor_sensor_node_t::approximate_temperature(double r, size_t index)
-{
-	const thermistor_sensor_node_t::temperature_point_t* p1 = &(temperature_points[index]);
-	const thermistor_sensor_node_t::temperature_point_t* p2 = &(temperature_points[index + 1]);
-	
-	double a = (p2->t - p1->t) / (p2->r - p1->r);
-	double b = p1->t - a * p1->r;
-
-	double t = a*r + b;
-	return static_cast<temperature_t>(t);
-}
-
 /**
  *	Retreives node's current value
  *	@param		time	current global time
@@ -103,40 +22,54 @@ temperature_t thermistor_sensor_node_t::approximate_temperature(double r, size_t
  **/
 const reading_t thermistor_sensor_node_t::update(const time_t& time)
 {
-	log_event_t e = log.begin_event(LOG_DEBUG);
-	e.printf(F("thermistor_sensor\tupdate(%u) "), &time);
-
-	int a = analogRead(_port);
-	e.printf(F("A = %d; "), a);
-
-	double a_t = a / 1023.0;
-	e.printf(F("At = %F; "), &a_t);
-
-	double r_t = R_D * (1.0 - a_t) / a_t;
-	e.printf(F("Rt = %F Ohm; "), &r_t);
-
-	double k = r_t / R_25;
-	e.printf(F("Kt = %F; "), &k);
-
-	size_t index = find_temperature_point(k);
-	e.printf(F("i = %d; "), index);
-
-	if(index < 0)
+	// A 16-bit scaled reading is 64 times a 10-bit ADC code
+	uint16_t reading = read();
+	temperature_t centi_t = convert(reading);
+	if(centi_t == THERMISTOR_TABLE_INVALID)
 	{
-		e.printf(F("temp. point not found"));
+		LOG_DBG(SENSOR, F("thermistor_sensor\tupdate(%u): A = %d, temp. point not found"), time, reading >> 6);
 		return reading_t(
 			optional_t<temperature_t>::empty(),
 			optional_t<humidity_t>::empty()
 			);
 	}
 
-	temperature_t t = approximate_temperature(k, index);
-	e.printf(F("t = %f deg C"), &t);
+	LOG_DBG(SENSOR, F("thermistor_sensor\tupdate(%u): A = %d + %d/64, t = %h deg C"), time, reading >> 6, reading & 0x3F, centi_t);
 
 	return reading_t(
-		optional_t<temperature_t>::create(t),
+		optional_t<temperature_t>::create(centi_t),
 		optional_t<humidity_t>::empty()
 		);
 }
 
+/**
+ *	Converts a reading into temperature.
+ *	The 10-bit ADC code is converted by thermistor_table lookup,
+ *	interpolating between table entries with bits gained by oversampling.
+ *	@param		reading		ADC code scaled to [0, 65535] range
+ *	@returns	temperature, THERMISTOR_TABLE_INVALID if the reading is outside of thermistor's range
+ **/
+temperature_t thermistor_sensor_node_t::convert(uint16_t reading)
+{
+	uint16_t a = reading >> 6;
+	uint8_t fraction = reading & 0x3F;
+
+	int16_t centi_t = pgm_read_word(&thermistor_table[a]);
+	if(centi_t == THERMISTOR_TABLE_INVALID)
+	{
+		return THERMISTOR_TABLE_INVALID;
+	}
+
+	if(fraction != 0 && a + 1 < 1024)
+	{
+		int16_t next_centi_t = pgm_read_word(&thermistor_table[a + 1]);
+		if(next_centi_t != THERMISTOR_TABLE_INVALID)
+		{
+			centi_t += static_cast<int16_t>((static_cast<int32_t>(next_centi_t - centi_t) * fraction) >> 6);
+		}
+	}
+
+	return centi_t;
+}
+
 #pragma endregion
\ No newline at end of file
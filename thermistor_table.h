@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Arduino.h"
+
+/*
+ * Thermistor's ADC reading to temperature lookup table, in hundredths of Celsius degree.
+ * Generated by host/gen_thermistor_table.cpp, do not edit.
+ */
+
+/*
+ * A reading outside of thermistor's approximation range
+ */
+#define THERMISTOR_TABLE_INVALID ((int16_t)-32768)
+
+static const int16_t thermistor_table[1024] PROGMEM =
+{
+	-32768,  -5240,  -4263,  -3669,  -3233,  -2898,  -2610,  -2365,
+	 -2146,  -1967,  -1778,  -1624,  -1494,  -1342,  -1212,  -1099,
+	 -1000,   -882,   -776,   -682,   -597,   -520,   -432,   -344,
+	  -263,   -189,   -121,    -58,      2,     76,    146,    211,
+	   272,    329,    383,    434,    482,    538,    596,    651,
+	   703,    753,    801,    846,    889,    930,    970,   1010,
+	  1059,   1106,   1150,   1193,   1235,   1275,   1313,   1350,
+	  1386,   1420,   1453,   1486,   1522,   1562,   1600,   1637,
+	  1673,   1708,   1742,   1775,   1807,   1838,   1868,   1897,
+	  1925,   1953,   1980,   2008,   2041,   2074,   2106,   2137,
+	  2167,   2196,   2225,   2253,   2280,   2307,   2333,   2359,
+	  2384,   2408,   2432,   2455,   2478,   2500,   2528,   2556,
+	  2584,   2610,   2636,   2662,   2687,   2712,   2736,   2759,
+	  2783,   2805,   2828,   2850,   2871,   2892,   2913,   2933,
+	  2953,   2973,   2992,   3014,   3038,   3061,   3084,   3107,
+	  3129,   3151,   3172,   3193,   3214,   3235,   3255,   3275,
+	  3294,   3313,   3332,   3351,   3369,   3387,   3405,   3422,
+	  3440,   3457,   3473,   3490,   3508,   3529,   3549,   3569,
+	  3589,   3608,   3628,   3647,   3665,   3684,   3702,   3720,
+	  3738,   3756,   3773,   3790,   3807,   3824,   3840,   3856,
+	  3872,   3888,   3904,   3919,   3935,   3950,   3965,   3979,
+	  3994,   4011,   4029,   4047,   4065,   4083,   4100,   4118,
+	  4135,   4152,   4168,   4185,   4201,   4217,   4233,   4249,
+	  4265,   4280,   4295,   4311,   4326,   4340,   4355,   4370,
+	  4384,   4398,   4412,   4426,   4440,   4454,   4467,   4480,
+	  4494,   4509,   4525,   4541,   4557,   4573,   4589,   4605,
+	  4620,   4636,   4651,   4666,   4681,   4696,   4710,   4725,
+	  4739,   4753,   4767,   4781,   4795,   4809,   4823,   4836,
+	  4849,   4863,   4876,   4889,   4902,   4915,   4927,   4940,
+	  4952,   4965,   4977,   4989,   5001,   5016,   5031,   5046,
+	  5060,   5075,   5089,   5103,   5117,   5131,   5145,   5159,
+	  5173,   5186,   5200,   5213,   5226,   5239,   5252,   5265,
+	  5278,   5291,   5303,   5316,   5328,   5340,   5353,   5365,
+	  5377,   5389,   5401,   5412,   5424,   5436,   5447,   5459,
+	  5470,   5481,   5492, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768
+};
\ No newline at end of file
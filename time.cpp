@@ -19,7 +19,7 @@ thermograph::time_service_t thermograph::time_service;
  *	Gets current global time
  *	@returns	current global time value
  **/
-const time_t time_service_t::get_time() const
+const thermograph::time_t time_service_t::get_time() const
 {
 	time_t time;
 	unsigned long sec = millis() / 1000;
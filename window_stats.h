@@ -0,0 +1,189 @@
+#pragma once
+
+#include "sensor.h"
+#include "history_stream.h"
+#include "ring_buffer.h"
+
+namespace thermograph
+{
+	/**
+	 *	Sliding window statistics class.
+	 *	Keeps N last values and maintains their min, max, mean and variance incrementally:
+	 *	min and max candidates are kept in monotonic deques, mean and variance come from running sums,
+	 *	so both push and every statistic are O(1). A slot without a value (a gap) takes its place
+	 *	in the window but doesn't count in statistics
+	 *	@param	N	window length, values. Must be less than 256
+	 **/
+	template <uint8_t N>
+	class window_stats_t
+	{
+	public:
+		/**
+		 *	Constructor
+		 **/
+		window_stats_t() : _seq(0), _count(0), _pivot(0), _sum(0), _squares(0) { }
+
+		/**
+		 *	Gets window values, 0 is the newest one. Slots without a value hold history_bucket_t::GAP
+		 *	@returns	window values
+		 **/
+		const ring_buffer_t<temperature_t, N>& get_values() const { return _values; }
+
+		/**
+		 *	Gets values count, gaps excluded
+		 *	@returns	values count
+		 **/
+		uint8_t get_count() const { return _count; }
+
+		/**
+		 *	Gets min value. The window must have values
+		 *	@returns	min value
+		 **/
+		temperature_t get_min() const { return value(_min.oldest()); }
+
+		/**
+		 *	Gets max value. The window must have values
+		 *	@returns	max value
+		 **/
+		temperature_t get_max() const { return value(_max.oldest()); }
+
+		/**
+		 *	Gets average value. The window must have values
+		 *	@returns	average value
+		 **/
+		temperature_t get_mean() const { return _pivot + _sum / _count; }
+
+		/**
+		 *	Gets values' variance. The window must have values
+		 *	@returns	variance, in squared value units
+		 **/
+		unsigned long get_variance() const
+		{
+			// Sum of squared deviations from the truncated mean m: S2 - 2mS + nm^2
+			long mean = _sum / _count;
+			return (_squares - 2 * mean * _sum + _count * mean * mean) / _count;
+		}
+
+		/**
+		 *	Pushes a new value, the oldest one expires if the window is full
+		 *	@param	x	a value
+		 **/
+		void push(const temperature_t x)
+		{
+			expire();
+
+			if (_count == 0)
+			{
+				// Sums are kept relative to a pivot to keep squares small
+				_pivot = x;
+				_sum = 0;
+				_squares = 0;
+			}
+
+			_values.push(x);
+			_seq++;
+
+			while (!_min.empty() && value(_min.newest()) >= x)
+			{
+				_min.pop_newest();
+			}
+			_min.push(_seq);
+
+			while (!_max.empty() && value(_max.newest()) <= x)
+			{
+				_max.pop_newest();
+			}
+			_max.push(_seq);
+
+			long d = static_cast<long>(x) - _pivot;
+			_sum += d;
+			_squares += d * d;
+			_count++;
+		}
+
+		/**
+		 *	Pushes a slot without a value, the oldest one expires if the window is full
+		 **/
+		void push_gap()
+		{
+			expire();
+
+			_values.push(history_bucket_t::GAP);
+			_seq++;
+		}
+
+	private:
+		/**
+		 *	Window values
+		 **/
+		ring_buffer_t<temperature_t, N> _values;
+
+		/**
+		 *	Min candidates' sequence numbers, increasing values from the oldest to the newest
+		 **/
+		ring_buffer_t<uint8_t, N> _min;
+
+		/**
+		 *	Max candidates' sequence numbers, decreasing values from the oldest to the newest
+		 **/
+		ring_buffer_t<uint8_t, N> _max;
+
+		/**
+		 *	The newest value's sequence number
+		 **/
+		uint8_t _seq;
+
+		/**
+		 *	Values count, gaps excluded
+		 **/
+		uint8_t _count;
+
+		/**
+		 *	A value sums are relative to
+		 **/
+		temperature_t _pivot;
+
+		/**
+		 *	Sum of values, relative to the pivot
+		 **/
+		long _sum;
+
+		/**
+		 *	Sum of squared values, relative to the pivot
+		 **/
+		unsigned long _squares;
+
+		/**
+		 *	Gets a window value by its sequence number
+		 *	@param		seq		value's sequence number
+		 *	@returns	the value
+		 **/
+		temperature_t value(uint8_t seq) const { return _values[static_cast<uint8_t>(_seq - seq)]; }
+
+		/**
+		 *	Removes the oldest value from statistics if the window is full
+		 **/
+		void expire()
+		{
+			if (!_values.full() || _values.oldest() == history_bucket_t::GAP)
+			{
+				return;
+			}
+
+			uint8_t seq = _seq - (N - 1);
+			if (_min.oldest() == seq)
+			{
+				_min.pop_oldest();
+			}
+			if (_max.oldest() == seq)
+			{
+				_max.pop_oldest();
+			}
+
+			long d = static_cast<long>(_values.oldest()) - _pivot;
+			_sum -= d;
+			_squares -= d * d;
+			_count--;
+		}
+	};
+}
\ No newline at end of file